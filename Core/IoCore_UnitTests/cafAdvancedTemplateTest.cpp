@@ -178,3 +178,39 @@ TEST( AdvancedObjectTest, CopyOfObjects )
         }
     }
 }
+
+//--------------------------------------------------------------------------------------------------
+/// The direct copy has to give the same result as writing to text and reading back in
+//--------------------------------------------------------------------------------------------------
+TEST( AdvancedObjectTest, DirectCopyMatchesTextCopy )
+{
+    auto root      = std::make_shared<ContainerObject>();
+    auto container = std::make_shared<ContainerObject>();
+    root->m_containers.push_back( container );
+    root->m_items.push_back( std::make_shared<ItemObject>( "Obj A" ) );
+    container->m_items.push_back( std::make_shared<ItemObject>( "Obj B" ) );
+    container->m_items.push_back( std::make_shared<ItemObject>( "Obj C" ) );
+
+    caffa::JsonSerializer serializer;
+    std::string           originalOutput = serializer.writeObjectToString( root.get() );
+
+    auto objCopy = serializer.cloneObject( root.get() );
+    ASSERT_TRUE( objCopy );
+    ASSERT_NE( root->m_containers[0], objCopy->m_containers[0] );
+    ASSERT_EQ( originalOutput, serializer.writeObjectToString( objCopy.get() ) );
+
+    auto textCopy = serializer.createObjectFromString( originalOutput );
+    ASSERT_EQ( serializer.writeObjectToString( textCopy.get() ), serializer.writeObjectToString( objCopy.get() ) );
+
+    serializer.setSerializeUuids( false );
+    auto freshCopy = serializer.copyBySerialization( root.get() );
+    ASSERT_NE( root->uuid(), freshCopy->uuid() );
+    ASSERT_EQ( serializer.writeObjectToString( root.get() ), serializer.writeObjectToString( freshCopy.get() ) );
+
+    serializer.setFieldSelector( []( const caffa::FieldHandle* field ) { return field->keyword() != "Items"; } );
+    auto selectedCopy = std::dynamic_pointer_cast<ContainerObject>( serializer.copyBySerialization( root.get() ) );
+    ASSERT_TRUE( selectedCopy );
+    ASSERT_EQ( 0u, selectedCopy->m_items.size() );
+    ASSERT_EQ( 1u, selectedCopy->m_containers.size() );
+    ASSERT_EQ( 0u, selectedCopy->m_containers[0]->m_items.size() );
+}
@@ -4,10 +4,12 @@
 #include "cafAppEnum.h"
 #include "cafChildArrayField.h"
 #include "cafChildField.h"
+#include "cafDefaultObjectFactory.h"
 #include "cafField.h"
 #include "cafFieldIoCapability.h"
 #include "cafFieldIoCapabilitySpecializations.h"
 #include "cafFieldProxyAccessor.h"
+#include "cafJsonSchemaCache.h"
 #include "cafJsonSerializer.h"
 #include "cafMethod.h"
 #include "cafObject.h"
@@ -15,6 +17,7 @@
 #include "cafStringEncoding.h"
 
 #include <functional>
+#include <limits>
 #include <random>
 
 using namespace std::placeholders;
@@ -285,6 +288,46 @@ TEST( BaseTest, ChildArrayFieldSerializing )
     }
 }
 
+class InheritedSimpleObj : public SimpleObj
+{
+    CAFFA_HEADER_INIT( InheritedSimpleObj, SimpleObj )
+
+public:
+    InheritedSimpleObj()
+    {
+        initField( m_child, "Child" );
+        initField( m_undefined, "Undefined" ).withDefault( std::numeric_limits<double>::quiet_NaN() );
+    }
+
+    caffa::ChildField<SimpleObj*> m_child;
+    caffa::Field<double>          m_undefined;
+};
+CAFFA_SOURCE_INIT( InheritedSimpleObj )
+
+//--------------------------------------------------------------------------------------------------
+/// Null values are skipped by the reader, so casting to a base class without the field has to work
+//--------------------------------------------------------------------------------------------------
+TEST( BaseTest, CastToBaseWithNullFields )
+{
+    auto inherited = std::make_shared<InheritedSimpleObj>();
+    inherited->m_position.setValue( 1.5 );
+    inherited->m_up.setValue( 3 );
+    ASSERT_FALSE( inherited->m_child.object() );
+
+    caffa::JsonSerializer serializer;
+
+    std::shared_ptr<SimpleObj> base;
+    ASSERT_NO_THROW( base = serializer.cloneObject<SimpleObj>( inherited.get() ) );
+    ASSERT_TRUE( base );
+    EXPECT_EQ( "SimpleObj", base->classKeyword() );
+    EXPECT_DOUBLE_EQ( 1.5, base->m_position.value() );
+    EXPECT_EQ( 3, base->m_up.value() );
+
+    // A child makes the field non-null and the base class can not hold it
+    inherited->m_child = std::make_shared<SimpleObj>();
+    EXPECT_THROW( serializer.cloneObject<SimpleObj>( inherited.get() ), std::runtime_error );
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -331,6 +374,127 @@ TEST( BaseTest, TestRangeValidation )
     ASSERT_EQ( 5, s1->m_up );
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( BaseTest, SchemaCache )
+{
+    auto s1 = std::make_shared<SimpleObj>();
+
+    caffa::JsonSchemaCache cache;
+    caffa::JsonSerializer  serializer;
+    serializer.setSerializationType( caffa::JsonSerializer::SerializationType::SCHEMA ).setSchemaCache( &cache );
+
+    auto schema = serializer.writeObjectToString( s1.get() );
+    EXPECT_EQ( 1u, cache.size() );
+    EXPECT_EQ( schema, serializer.writeObjectToString( s1.get() ) );
+    EXPECT_EQ( 1u, cache.size() );
+
+    caffa::JsonSerializer uncachedSerializer;
+    uncachedSerializer.setSerializationType( caffa::JsonSerializer::SerializationType::SCHEMA )
+        .setSchemaCache( nullptr );
+    EXPECT_EQ( schema, uncachedSerializer.writeObjectToString( s1.get() ) );
+
+    // Selectors without a key are never cached
+    auto selector = []( const caffa::FieldHandle* field ) { return field->keyword() != "Up"; };
+    serializer.setFieldSelector( selector );
+    auto selectedSchema = serializer.writeObjectToString( s1.get() );
+    EXPECT_NE( schema, selectedSchema );
+    EXPECT_EQ( 1u, cache.size() );
+
+    serializer.setFieldSelector( selector, "noUp" );
+    EXPECT_EQ( selectedSchema, serializer.writeObjectToString( s1.get() ) );
+    EXPECT_EQ( 2u, cache.size() );
+    EXPECT_TRUE( cache.find( s1->classKeyword(), serializer.objectFactory()->identity(), "noUp" ) );
+
+    cache.invalidate( s1->classKeyword() );
+    EXPECT_EQ( 0u, cache.size() );
+
+    serializer.writeObjectToString( s1.get() );
+    EXPECT_EQ( 1u, cache.size() );
+    cache.clear();
+    EXPECT_FALSE( cache.find( s1->classKeyword(), serializer.objectFactory()->identity(), "noUp" ) );
+}
+
+TEST( BaseTest, AllObjectSchemas )
+{
+    caffa::JsonSchemaCache cache;
+    caffa::JsonSerializer  serializer;
+    serializer.setSchemaCache( &cache );
+
+    auto schemas = serializer.writeObjectSchemas();
+    ASSERT_TRUE( schemas );
+    EXPECT_EQ( caffa::DefaultObjectFactory::instance()->generation(), schemas->generation );
+    EXPECT_EQ( caffa::json::dump( schemas->schemas ), schemas->text );
+
+    // Each class schema is the same as when written on its own
+    auto                  s1 = std::make_shared<SimpleObj>();
+    caffa::JsonSerializer schemaSerializer;
+    schemaSerializer.setSerializationType( caffa::JsonSerializer::SerializationType::SCHEMA ).setSchemaCache( nullptr );
+    caffa::json::object simpleSchema;
+    schemaSerializer.writeObjectToJson( s1.get(), simpleSchema );
+    ASSERT_TRUE( schemas->schemas.contains( s1->classKeyword() ) );
+    EXPECT_EQ( simpleSchema, schemas->schemas.at( s1->classKeyword() ) );
+
+    // The schemas are shared until the cache is invalidated
+    EXPECT_EQ( schemas, serializer.writeObjectSchemas() );
+    cache.invalidate( s1->classKeyword() );
+    auto rewritten = serializer.writeObjectSchemas();
+    EXPECT_NE( schemas, rewritten );
+    EXPECT_EQ( schemas->text, rewritten->text );
+
+    // Selectors without a key are never cached
+    serializer.setFieldSelector( []( const caffa::FieldHandle* field ) { return field->keyword() != "Up"; } );
+    EXPECT_NE( serializer.writeObjectSchemas(), serializer.writeObjectSchemas() );
+}
+
+namespace
+{
+class ForwardingSchemaFactory : public caffa::ObjectFactory
+{
+public:
+    std::string              name() const override { return "Forwarding schema ObjectFactory"; }
+    std::vector<std::string> classKeywords() const override
+    {
+        return caffa::DefaultObjectFactory::instance()->classKeywords();
+    }
+    std::uint64_t generation() const override { return caffa::DefaultObjectFactory::instance()->generation(); }
+
+private:
+    std::shared_ptr<caffa::ObjectHandle> doCreate( const std::string_view& classKeyword ) override
+    {
+        return caffa::DefaultObjectFactory::instance()->create( classKeyword );
+    }
+};
+} // namespace
+
+TEST( BaseTest, SchemaCacheKeepsFactoriesApart )
+{
+    caffa::JsonSchemaCache  cache;
+    ForwardingSchemaFactory factory;
+
+    caffa::JsonSerializer defaultSerializer;
+    defaultSerializer.setSchemaCache( &cache );
+    caffa::JsonSerializer forwardingSerializer( &factory );
+    forwardingSerializer.setSchemaCache( &cache );
+    EXPECT_NE( caffa::DefaultObjectFactory::instance()->identity(), factory.identity() );
+
+    // Both factories are at the same generation, but neither gets the schemas cached for the other
+    auto defaultSchemas    = defaultSerializer.writeObjectSchemas();
+    auto forwardingSchemas = forwardingSerializer.writeObjectSchemas();
+    EXPECT_EQ( defaultSchemas->generation, forwardingSchemas->generation );
+    EXPECT_NE( defaultSchemas, forwardingSchemas );
+    EXPECT_EQ( factory.identity(), forwardingSchemas->factoryIdentity );
+    EXPECT_EQ( defaultSchemas->text, forwardingSchemas->text );
+    EXPECT_EQ( defaultSchemas, defaultSerializer.writeObjectSchemas() );
+    EXPECT_EQ( forwardingSchemas, forwardingSerializer.writeObjectSchemas() );
+
+    // The class schemas are kept apart as well
+    auto s1 = std::make_shared<SimpleObj>();
+    EXPECT_TRUE( cache.find( s1->classKeyword(), factory.identity(), "" ) );
+    EXPECT_TRUE( cache.find( s1->classKeyword(), caffa::DefaultObjectFactory::instance()->identity(), "" ) );
+}
+
 std::string ipsum()
 {
     return "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Sed aliquam ligula sed nibh rutrum, quis tempus "
@@ -425,6 +589,78 @@ TEST( Base64Test, roundtrip )
     }
 }
 
+TEST( Base64Test, implementationsMatchScalar )
+{
+    using caffa::StringTools::Base64Implementation;
+
+    std::mt19937                       mt( 42 );
+    std::uniform_int_distribution<int> dist( 0, 255 );
+
+    for ( auto implementation :
+          { Base64Implementation::SSSE3, Base64Implementation::AVX2, Base64Implementation::NEON } )
+    {
+        if ( !caffa::StringTools::isBase64ImplementationSupported( implementation ) ) continue;
+
+        // Cover every tail length around the vector block sizes
+        for ( size_t len = 0; len < 300; ++len )
+        {
+            std::string binary( len, '\0' );
+            for ( auto& c : binary )
+            {
+                c = static_cast<char>( dist( mt ) );
+            }
+
+            std::string expected( caffa::StringTools::encodedBase64Size( len ), '\0' );
+            caffa::StringTools::encodeBase64( binary, expected, Base64Implementation::SCALAR );
+
+            std::string encoded( expected.size(), '\0' );
+            ASSERT_EQ( encoded.size(), caffa::StringTools::encodeBase64( binary, encoded, implementation ) );
+            ASSERT_EQ( expected, encoded );
+
+            std::string decoded( len, '\0' );
+            ASSERT_EQ( len, caffa::StringTools::decodeBase64( encoded, decoded, implementation ) );
+            ASSERT_EQ( binary, decoded );
+
+            // Invalid characters have to be caught wherever they are, including inside vector blocks
+            if ( encoded.size() > 4u )
+            {
+                auto invalid = encoded;
+                invalid.replace( len % ( encoded.size() - 4u ), 1u, "*" );
+                EXPECT_THROW( caffa::StringTools::decodeBase64( invalid, decoded, implementation ),
+                              std::runtime_error );
+            }
+        }
+    }
+}
+
+TEST( Base64Test, chunkedIntoCallerBuffer )
+{
+    const std::string text = ipsum();
+
+    // Chunks which are a multiple of 3 bytes encode to the same text as the whole
+    std::string encoded( caffa::StringTools::encodedBase64Size( text.size() ), '\0' );
+    size_t      written = 0u;
+    for ( size_t start = 0u; start < text.size(); start += 300u )
+    {
+        written += caffa::StringTools::encodeBase64( std::string_view( text ).substr( start, 300u ),
+                                                     std::span<char>( encoded ).subspan( written ) );
+    }
+    EXPECT_EQ( encoded.size(), written );
+    EXPECT_EQ( caffa::StringTools::encodeBase64( text ), encoded );
+
+    std::string decoded( caffa::StringTools::decodedBase64Size( encoded ), '\0' );
+    written = 0u;
+    for ( size_t start = 0u; start < encoded.size(); start += 400u )
+    {
+        written += caffa::StringTools::decodeBase64( std::string_view( encoded ).substr( start, 400u ),
+                                                     std::span<char>( decoded ).subspan( written ) );
+    }
+    EXPECT_EQ( text, decoded );
+
+    std::string tooSmall( 4u, '\0' );
+    EXPECT_THROW( caffa::StringTools::encodeBase64( text, tooSmall ), std::runtime_error );
+}
+
 TEST( Base64Test, oneLongRoundtrip )
 {
     CAFFA_INFO( "Got a string of size " << oneLongString.length() / 1024 / 1024 << " MebiBytes to encode and decode" );
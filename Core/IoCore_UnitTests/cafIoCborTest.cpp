@@ -0,0 +1,253 @@
+#include "gtest/gtest.h"
+
+#include "cafCborSerializer.h"
+#include "cafCborStream.h"
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class CborChild : public caffa::Object
+{
+    CAFFA_HEADER_INIT( CborChild, Object )
+
+public:
+    CborChild()
+    {
+        initField( m_name, "Name" );
+        initField( m_doubles, "Doubles" );
+        initField( m_integers, "Integers" );
+        initField( m_bytes, "Bytes" );
+    }
+
+    caffa::Field<std::string>               m_name;
+    caffa::Field<std::vector<double>>       m_doubles;
+    caffa::Field<std::vector<int64_t>>      m_integers;
+    caffa::Field<std::vector<std::uint8_t>> m_bytes;
+};
+CAFFA_SOURCE_INIT( CborChild )
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class CborParent : public caffa::Object
+{
+    CAFFA_HEADER_INIT( CborParent, Object )
+
+public:
+    CborParent()
+    {
+        initField( m_flag, "Flag" ).withDefault( false );
+        initField( m_single, "Single" );
+        initField( m_children, "Children" );
+    }
+
+    caffa::Field<bool>                 m_flag;
+    caffa::ChildField<CborChild*>      m_single;
+    caffa::ChildArrayField<CborChild*> m_children;
+};
+CAFFA_SOURCE_INIT( CborParent )
+
+namespace
+{
+std::shared_ptr<CborParent> createCborParent()
+{
+    auto parent = std::make_shared<CborParent>();
+    parent->m_flag.setValue( true );
+
+    auto single = std::make_shared<CborChild>();
+    single->m_name.setValue( "Single child" );
+    single->m_doubles.setValue( { 0.1, -2.5, 1.0e300 } );
+    single->m_integers.setValue( { -1, 1ll << 40 } );
+    single->m_bytes.setValue( { 1, 2, 3 } );
+    parent->m_single = single;
+
+    appendTestChildren( parent->m_children,
+                        3u,
+                        "Child ",
+                        []( CborChild& child, size_t i )
+                        {
+                            child.m_doubles.setValue( std::vector<double>( 100, 0.25 * i ) );
+                            child.m_integers.setValue( std::vector<int64_t>( 100, static_cast<int64_t>( i ) ) );
+                        } );
+    return parent;
+}
+
+caffa::json::value decodeBytes( const std::vector<std::uint8_t>& bytes )
+{
+    return caffa::CborSerializer::decode( bytes );
+}
+
+} // namespace
+
+TEST( CborSerializer, RoundTripMatchesJson )
+{
+    auto parent = createCborParent();
+
+    caffa::CborSerializer cborSerializer;
+    auto                  bytes = cborSerializer.writeObjectToBytes( parent.get() );
+
+    auto copy = std::dynamic_pointer_cast<CborParent>( cborSerializer.createObjectFromBytes( bytes ) );
+    ASSERT_TRUE( copy );
+
+    caffa::JsonSerializer jsonSerializer;
+    EXPECT_EQ( jsonSerializer.writeObjectToString( parent.get() ), jsonSerializer.writeObjectToString( copy.get() ) );
+    EXPECT_EQ( parent->uuid(), copy->uuid() );
+    ASSERT_EQ( 3u, copy->m_children.size() );
+    EXPECT_EQ( std::vector<int64_t>( 100, 2 ), copy->m_children[2]->m_integers.value() );
+    EXPECT_EQ( parent->m_single->m_doubles.value(), copy->m_single->m_doubles.value() );
+
+    // Numeric arrays are stored as packed binary and should be smaller than the text
+    EXPECT_LT( bytes.size(), jsonSerializer.writeObjectToString( parent.get() ).size() );
+}
+
+TEST( CborSerializer, StreamsAndOptions )
+{
+    auto parent = createCborParent();
+
+    caffa::CborSerializer serializer;
+    serializer.setSerializeUuids( false );
+
+    std::stringstream stream;
+    serializer.writeStream( parent.get(), stream );
+
+    auto copy = std::make_shared<CborParent>();
+    serializer.readStream( copy.get(), stream );
+    EXPECT_NE( parent->uuid(), copy->uuid() );
+    EXPECT_EQ( "Single child", copy->m_single->m_name.value() );
+    EXPECT_EQ( 3u, copy->m_children.size() );
+
+    serializer.setFieldSelector( []( const caffa::FieldHandle* field ) { return field->keyword() != "Children"; } );
+    auto clone = serializer.cloneObject( parent.get() );
+    ASSERT_TRUE( clone );
+    EXPECT_TRUE( clone->m_flag.value() );
+    EXPECT_TRUE( clone->m_children.empty() );
+    EXPECT_EQ( parent->m_single->m_integers.value(), clone->m_single->m_integers.value() );
+}
+
+TEST( CborSerializer, EncodeDecodeValues )
+{
+    auto value = caffa::json::parse( R"({"a":[1,2,300],"b":[-1,70000],"c":[0.5,1.5],"d":[0.1,0.2],)"
+                                     R"("e":[1,"two",null,true],"f":{"g":18446744073709551615},"h":[]})" );
+
+    auto bytes = caffa::CborSerializer::encode( value );
+    EXPECT_EQ( value, caffa::CborSerializer::decode( bytes ) );
+
+    bytes.push_back( 0x00 );
+    EXPECT_THROW( caffa::CborSerializer::decode( bytes ), std::runtime_error );
+    EXPECT_THROW( caffa::CborSerializer::decode( std::vector<std::uint8_t>{ 0x83, 0x01 } ), std::runtime_error );
+}
+
+TEST( CborSerializer, DecodesSpecificationExamples )
+{
+    // Examples from RFC 8949 Appendix A and RFC 8746
+    EXPECT_EQ( caffa::json::value( 1000 ), decodeBytes( { 0x19, 0x03, 0xe8 } ) );
+    EXPECT_EQ( caffa::json::value( -1000 ), decodeBytes( { 0x39, 0x03, 0xe7 } ) );
+    EXPECT_EQ( caffa::json::value( 1.0 ), decodeBytes( { 0xf9, 0x3c, 0x00 } ) );
+    EXPECT_EQ( caffa::json::value( -4.0 ), decodeBytes( { 0xf9, 0xc4, 0x00 } ) );
+    EXPECT_EQ( caffa::json::value( 1.1 ), decodeBytes( { 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a } ) );
+    EXPECT_EQ( caffa::json::value( "IETF" ), decodeBytes( { 0x64, 0x49, 0x45, 0x54, 0x46 } ) );
+    EXPECT_EQ( caffa::json::value( "AQIDBA==" ), decodeBytes( { 0x44, 0x01, 0x02, 0x03, 0x04 } ) );
+    EXPECT_EQ( caffa::json::parse( "[1,[2,3],[4,5]]" ),
+               decodeBytes( { 0x9f, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, 0xff } ) );
+    EXPECT_EQ( caffa::json::parse( R"({"a":1,"b":[2,3]})" ),
+               decodeBytes( { 0xbf, 0x61, 0x61, 0x01, 0x61, 0x62, 0x9f, 0x02, 0x03, 0xff, 0xff } ) );
+    EXPECT_EQ( caffa::json::value( "streaming" ),
+               decodeBytes( { 0x7f, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x64, 0x6d, 0x69, 0x6e, 0x67, 0xff } ) );
+
+    // Big endian signed 16 bit typed array
+    EXPECT_EQ( caffa::json::parse( "[-2,258]" ), decodeBytes( { 0xd8, 0x49, 0x44, 0xff, 0xfe, 0x01, 0x02 } ) );
+}
+
+TEST( CborSerializer, ByteDataAndFieldsAheadOfKeyword )
+{
+    auto parent = createCborParent();
+
+    caffa::CborSerializer serializer;
+    auto                  bytes = serializer.writeObjectToBytes( parent.get() );
+
+    // Byte data is written as a byte string, which decodes to base64 in JSON
+    auto decoded = caffa::CborSerializer::decode( bytes );
+    EXPECT_EQ( caffa::json::value( "AQID" ), decoded.as_object().at( "Single" ).as_object().at( "Bytes" ) );
+
+    auto copy = serializer.cloneObject( parent.get() );
+    ASSERT_TRUE( copy );
+    EXPECT_EQ( std::vector<std::uint8_t>( { 1, 2, 3 } ), copy->m_single->m_bytes.value() );
+
+    // Fields ahead of the class keyword are read once the object has been created
+    caffa::json::object jsonChild;
+    jsonChild["Name"]     = "First";
+    jsonChild["keyword"]  = "CborChild";
+    jsonChild["Integers"] = caffa::json::array{ 1, 2 };
+
+    auto child = std::dynamic_pointer_cast<CborChild>(
+        serializer.createObjectFromBytes( caffa::CborSerializer::encode( jsonChild ) ) );
+    ASSERT_TRUE( child );
+    EXPECT_EQ( "First", child->m_name.value() );
+    EXPECT_EQ( std::vector<int64_t>( { 1, 2 } ), child->m_integers.value() );
+
+    caffa::json::object jsonParent;
+    jsonParent["Flag"]     = true;
+    jsonParent["Children"] = caffa::json::array{ caffa::json::value( jsonChild ), caffa::json::value( jsonChild ) };
+    jsonParent["keyword"]  = "CborParent";
+    jsonParent["Single"]   = jsonChild;
+
+    const auto        parentBytes = caffa::CborSerializer::encode( jsonParent );
+    std::stringstream stream( std::string( parentBytes.begin(), parentBytes.end() ) );
+
+    auto streamed = std::make_shared<CborParent>();
+    serializer.readStream( streamed.get(), stream );
+    EXPECT_TRUE( streamed->m_flag.value() );
+    ASSERT_EQ( 2u, streamed->m_children.size() );
+    EXPECT_EQ( "First", streamed->m_children[1]->m_name.value() );
+    EXPECT_EQ( std::vector<int64_t>( { 1, 2 } ), streamed->m_single->m_integers.value() );
+
+    // A truncated stream is an error
+    std::stringstream truncated( std::string( parentBytes.begin(), parentBytes.end() - 1 ) );
+    EXPECT_THROW( serializer.readStream( std::make_shared<CborParent>().get(), truncated ), std::runtime_error );
+}
+
+TEST( CborSerializer, RejectsDeeplyNestedData )
+{
+    // Crafted data nested far deeper than any object tree would overflow the stack if it was followed
+    std::vector<std::uint8_t> arrays( 100000, 0x81 );
+    arrays.push_back( 0x01 );
+    EXPECT_THROW( caffa::CborSerializer::decode( arrays ), std::runtime_error );
+
+    std::vector<std::uint8_t> tags( 100000, 0xc6 );
+    tags.push_back( 0x01 );
+    EXPECT_THROW( caffa::CborSerializer::decode( tags ), std::runtime_error );
+
+    // Data nested as deep as JSON may be is still read
+    std::vector<std::uint8_t> allowed( caffa::CborReader::MAX_DEPTH, 0x81 );
+    allowed.push_back( 0x01 );
+    EXPECT_NO_THROW( caffa::CborSerializer::decode( allowed ) );
+
+    // Field values are read with the same limit
+    caffa::json::object jsonChild;
+    jsonChild["keyword"] = "CborChild";
+
+    auto bytes = caffa::CborSerializer::encode( jsonChild );
+    ASSERT_EQ( 0xa1, bytes.front() );
+
+    // Add a second entry holding an empty array behind a long chain of tags
+    const std::string fieldKeyword = "Doubles";
+    bytes.front()                  = 0xa2;
+    bytes.push_back( static_cast<std::uint8_t>( 0x60 + fieldKeyword.size() ) );
+    bytes.insert( bytes.end(), fieldKeyword.begin(), fieldKeyword.end() );
+    bytes.insert( bytes.end(), 100000, 0xc6 );
+    bytes.push_back( 0x80 );
+
+    caffa::CborSerializer serializer;
+    EXPECT_THROW( serializer.readObjectFromBytes( std::make_shared<CborChild>().get(), bytes ), std::runtime_error );
+}
@@ -0,0 +1,274 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonDeltaSerializer.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+
+#include <chrono>
+#include <stdexcept>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class DeltaItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( DeltaItem, Object )
+
+public:
+    DeltaItem()
+    {
+        initField( m_name, "Name" );
+        initField( m_value, "Value" ).withDefault( 0.0 );
+        initField( m_single, "Single" );
+        initField( m_items, "Items" );
+    }
+
+    caffa::Field<std::string>          m_name;
+    caffa::Field<double>               m_value;
+    caffa::ChildField<DeltaItem*>      m_single;
+    caffa::ChildArrayField<DeltaItem*> m_items;
+};
+CAFFA_SOURCE_INIT( DeltaItem )
+
+namespace
+{
+std::shared_ptr<DeltaItem> createDeltaTree()
+{
+    auto root = std::make_shared<DeltaItem>();
+    root->m_name.setValue( "Root" );
+    appendTestChildren( root->m_items,
+                        10u,
+                        "Item ",
+                        []( DeltaItem& item, size_t i ) { item.m_value.setValue( 1.0 * i ); } );
+    return root;
+}
+
+} // namespace
+
+TEST( JsonDeltaSerializer, TracksModifications )
+{
+    DeltaItem item;
+    EXPECT_EQ( 0u, item.m_name.lastModifiedVersion() );
+
+    const auto before = caffa::FieldHandle::currentVersion();
+    item.m_name.setValue( "Changed" );
+    EXPECT_GT( item.m_name.lastModifiedVersion(), before );
+    EXPECT_EQ( item.m_name.lastModifiedVersion(), caffa::FieldHandle::currentVersion() );
+    EXPECT_EQ( 0u, item.m_value.lastModifiedVersion() );
+
+    const auto afterName = caffa::FieldHandle::currentVersion();
+    item.m_items.push_back( std::make_shared<DeltaItem>() );
+    EXPECT_GT( item.m_items.lastModifiedVersion(), afterName );
+
+    const auto afterPush = caffa::FieldHandle::currentVersion();
+    item.m_items.clear();
+    EXPECT_GT( item.m_items.lastModifiedVersion(), afterPush );
+
+    item.m_single = std::make_shared<DeltaItem>();
+    EXPECT_GT( item.m_single.lastModifiedVersion(), item.m_items.lastModifiedVersion() );
+    EXPECT_GE( item.m_single.lastModified(), item.m_name.lastModified() );
+}
+
+TEST( JsonDeltaSerializer, WriteAndApplyDelta )
+{
+    auto root = createDeltaTree();
+
+    caffa::JsonSerializer serializer;
+    const auto            rootString = serializer.writeObjectToString( root.get() );
+
+    auto copy = std::dynamic_pointer_cast<DeltaItem>( serializer.createObjectFromString( rootString ) );
+    ASSERT_TRUE( copy );
+
+    caffa::JsonDeltaSerializer deltaSerializer;
+
+    const auto version = caffa::FieldHandle::currentVersion();
+    EXPECT_TRUE( deltaSerializer.writeDeltaToJson( root.get(), version )["objects"].as_object().empty() );
+
+    root->m_items[3]->m_value.setValue( 42.0 );
+    root->m_items[7]->m_name.setValue( "Renamed" );
+
+    auto delta   = deltaSerializer.writeDeltaToJson( root.get(), version );
+    auto objects = delta["objects"].as_object();
+    ASSERT_EQ( 2u, objects.size() );
+    ASSERT_TRUE( objects.contains( root->m_items[3]->uuid() ) );
+    EXPECT_EQ( 2u, objects[root->m_items[3]->uuid()].as_object().size() );
+    EXPECT_EQ( caffa::FieldHandle::currentVersion(), caffa::JsonDeltaSerializer::deltaVersion( delta ) );
+
+    deltaSerializer.readDeltaFromString( copy.get(), caffa::json::dump( delta ) );
+    EXPECT_EQ( 42.0, copy->m_items[3]->m_value.value() );
+    EXPECT_EQ( "Renamed", copy->m_items[7]->m_name.value() );
+    EXPECT_EQ( serializer.writeObjectToString( root.get() ), serializer.writeObjectToString( copy.get() ) );
+
+    // Structural changes send the children of child arrays by uuid and the other child fields in full
+    const auto nextVersion = caffa::JsonDeltaSerializer::deltaVersion( delta );
+    root->m_items.erase( 0u );
+    root->m_single = std::make_shared<DeltaItem>();
+    root->m_single->m_name.setValue( "Single" );
+
+    delta = deltaSerializer.writeDeltaToJson( root.get(), nextVersion );
+    ASSERT_EQ( 1u, delta["objects"].as_object().size() );
+    deltaSerializer.readDeltaFromJson( copy.get(), delta );
+    ASSERT_EQ( 9u, copy->m_items.size() );
+    ASSERT_TRUE( copy->m_single );
+    EXPECT_EQ( root->m_single->uuid(), copy->m_single->uuid() );
+    EXPECT_EQ( serializer.writeObjectToString( root.get() ), serializer.writeObjectToString( copy.get() ) );
+
+    const auto beforeClear = caffa::FieldHandle::currentVersion();
+    root->m_single.clear();
+    deltaSerializer.readDeltaFromJson( copy.get(), deltaSerializer.writeDeltaToJson( root.get(), beforeClear ) );
+    EXPECT_FALSE( copy->m_single );
+
+    // Time stamps work as well
+    const auto now = std::chrono::system_clock::now();
+    EXPECT_TRUE( deltaSerializer.writeDeltaToJson( root.get(), now )["objects"].as_object().empty() );
+}
+
+TEST( JsonDeltaSerializer, InvalidDeltas )
+{
+    auto root = createDeltaTree();
+    auto copy = createDeltaTree();
+
+    caffa::JsonDeltaSerializer deltaSerializer;
+
+    const auto version = caffa::FieldHandle::currentVersion();
+    root->m_name.setValue( "Changed" );
+
+    // Different UUIDs, so the object can not be found and nothing is changed
+    auto delta = deltaSerializer.writeDeltaToJson( root.get(), version );
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), delta ), std::runtime_error );
+    EXPECT_EQ( "Root", copy->m_name.value() );
+
+    EXPECT_THROW( deltaSerializer.readDeltaFromString( copy.get(), "[]" ), std::runtime_error );
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), caffa::json::object() ), std::runtime_error );
+
+    caffa::json::object badField;
+    badField["NoSuchField"] = 1;
+    caffa::json::object objects;
+    objects[copy->uuid()] = badField;
+    caffa::json::object badDelta;
+    badDelta["objects"] = objects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), badDelta ), std::runtime_error );
+
+    // A bad field in a later object leaves the valid changes to earlier objects unapplied
+    caffa::json::object goodField;
+    goodField["Name"] = "Changed";
+    caffa::json::object mixedObjects;
+    mixedObjects[copy->m_items[0]->uuid()] = goodField;
+    mixedObjects[copy->uuid()]             = badField;
+    badDelta["objects"]                    = mixedObjects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), badDelta ), std::runtime_error );
+    EXPECT_EQ( "Item 0", copy->m_items[0]->m_name.value() );
+
+    // Objects inside a child field replaced by the same delta would be destroyed before they are changed
+    caffa::json::object replacedItems;
+    replacedItems["Items"] = caffa::json::array();
+    caffa::json::object nestedObjects;
+    nestedObjects[copy->uuid()]             = replacedItems;
+    nestedObjects[copy->m_items[2]->uuid()] = goodField;
+    badDelta["objects"]                     = nestedObjects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), badDelta ), std::runtime_error );
+    ASSERT_EQ( 10u, copy->m_items.size() );
+    EXPECT_EQ( "Item 2", copy->m_items[2]->m_name.value() );
+
+    // Only child fields can be set to null
+    caffa::json::object nullField;
+    nullField["Name"] = nullptr;
+    caffa::json::object nullObjects;
+    nullObjects[copy->uuid()] = nullField;
+    badDelta["objects"]       = nullObjects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), badDelta ), std::runtime_error );
+    EXPECT_EQ( "Root", copy->m_name.value() );
+
+    // Kept children have to be children of the field
+    caffa::json::object unknownChild;
+    unknownChild["keyword"] = "DeltaItem";
+    unknownChild["uuid"]    = root->m_items[0]->uuid();
+    caffa::json::object unknownItems;
+    unknownItems["Items"] = caffa::json::array{ caffa::json::value( unknownChild ) };
+    caffa::json::object unknownObjects;
+    unknownObjects[copy->uuid()] = unknownItems;
+    badDelta["objects"]          = unknownObjects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), badDelta ), std::runtime_error );
+    EXPECT_EQ( 10u, copy->m_items.size() );
+}
+
+TEST( JsonDeltaSerializer, ChildArraysElementByElement )
+{
+    auto root = createDeltaTree();
+
+    caffa::JsonSerializer serializer;
+    const auto            rootString = serializer.writeObjectToString( root.get() );
+
+    auto copy = std::dynamic_pointer_cast<DeltaItem>( serializer.createObjectFromString( rootString ) );
+    ASSERT_TRUE( copy );
+
+    caffa::JsonDeltaSerializer deltaSerializer;
+
+    const auto version = caffa::FieldHandle::currentVersion();
+    root->m_items.erase( 0u );
+    root->m_items[4]->m_name.setValue( "Renamed" );
+    auto added = std::make_shared<DeltaItem>();
+    added->m_name.setValue( "Added" );
+    root->m_items.push_back( added );
+
+    auto delta   = deltaSerializer.writeDeltaToJson( root.get(), version );
+    auto objects = delta["objects"].as_object();
+    ASSERT_EQ( 2u, objects.size() );
+    EXPECT_EQ( 1u, objects[root->m_items[4]->uuid()].as_object().count( "Name" ) );
+
+    // Only the added child is written in full
+    const auto& jsonItems = objects[root->uuid()].as_object()["Items"].as_array();
+    ASSERT_EQ( 10u, jsonItems.size() );
+    for ( size_t i = 0; i < 9u; ++i )
+    {
+        EXPECT_EQ( 2u, jsonItems[i].as_object().size() );
+        EXPECT_EQ( root->m_items[i]->uuid(), jsonItems[i].as_object().at( "uuid" ).as_string() );
+    }
+    EXPECT_EQ( "Added", jsonItems[9].as_object().at( "Name" ).as_string() );
+
+    // The kept children are changed in place
+    const auto* keptItem = copy->m_items[5].get();
+    deltaSerializer.readDeltaFromJson( copy.get(), delta );
+    ASSERT_EQ( 10u, copy->m_items.size() );
+    EXPECT_EQ( keptItem, copy->m_items[4].get() );
+    EXPECT_EQ( "Renamed", copy->m_items[4]->m_name.value() );
+    EXPECT_EQ( added->uuid(), copy->m_items[9]->uuid() );
+    EXPECT_EQ( serializer.writeObjectToString( root.get() ), serializer.writeObjectToString( copy.get() ) );
+
+    // Changes to a child removed by the same delta are rejected
+    auto& keptItems = objects[root->uuid()].as_object()["Items"].as_array();
+    keptItems.erase( keptItems.begin() );
+    objects[copy->m_items[0]->uuid()] = caffa::json::object{ { "Name", "Removed" } };
+    delta["objects"]                  = objects;
+    EXPECT_THROW( deltaSerializer.readDeltaFromJson( copy.get(), delta ), std::runtime_error );
+    EXPECT_EQ( "Item 1", copy->m_items[0]->m_name.value() );
+}
+
+TEST( JsonDeltaSerializer, VolatileFieldsOnlyWhenChanged )
+{
+    auto root = createDeltaTree();
+    root->m_value.markVolatile();
+
+    caffa::JsonDeltaSerializer deltaSerializer;
+
+    const auto version = caffa::FieldHandle::currentVersion();
+    EXPECT_TRUE( deltaSerializer.writeDeltaToJson( root.get(), version )["objects"].as_object().empty() );
+
+    root->m_value.setValue( 3.0 );
+    auto objects = deltaSerializer.writeDeltaToJson( root.get(), version )["objects"].as_object();
+    ASSERT_TRUE( objects.contains( root->uuid() ) );
+    EXPECT_TRUE( objects[root->uuid()].as_object().contains( "Value" ) );
+
+    // Unless asked to write every volatile field
+    deltaSerializer.setWriteVolatileFields( true );
+    EXPECT_TRUE( deltaSerializer.writeVolatileFields() );
+    const auto laterVersion = caffa::FieldHandle::currentVersion();
+    objects = deltaSerializer.writeDeltaToJson( root.get(), laterVersion )["objects"].as_object();
+    ASSERT_EQ( 1u, objects.size() );
+    EXPECT_EQ( 3.0, objects[root->uuid()].as_object().at( "Value" ).as_double() );
+}
@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafDefaultObjectFactory.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::atomic<int> lazyNodeCount = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class LazyNode : public caffa::Object
+{
+    CAFFA_HEADER_INIT( LazyNode, Object )
+
+public:
+    LazyNode()
+    {
+        initField( m_name, "Name" );
+        initField( m_single, "Single" );
+        initField( m_nodes, "Nodes" );
+        lazyNodeCount++;
+    }
+
+    caffa::Field<std::string>         m_name;
+    caffa::ChildField<LazyNode*>      m_single;
+    caffa::ChildArrayField<LazyNode*> m_nodes;
+};
+CAFFA_SOURCE_INIT( LazyNode )
+
+namespace
+{
+std::shared_ptr<LazyNode> createLazyTree()
+{
+    auto root = std::make_shared<LazyNode>();
+    root->m_name.setValue( "Root" );
+
+    auto single = std::make_shared<LazyNode>();
+    single->m_name.setValue( "Single" );
+    single->m_single = std::make_shared<LazyNode>();
+    root->m_single   = single;
+
+    appendTestChildren( root->m_nodes,
+                        3u,
+                        "Node ",
+                        []( LazyNode& node, size_t ) { appendTestChildren( node.m_nodes, 2u, "Leaf " ); } );
+    return root;
+}
+
+} // namespace
+
+TEST( LazyChildren, CreatesChildrenOnFirstAccess )
+{
+    const auto text = caffa::JsonSerializer().writeObjectToString( createLazyTree().get() );
+
+    caffa::JsonSerializer serializer;
+    serializer.setLazyChildren( true );
+    EXPECT_TRUE( serializer.lazyChildren() );
+
+    lazyNodeCount = 0;
+    auto root     = std::dynamic_pointer_cast<LazyNode>( serializer.createObjectFromString( text ) );
+    ASSERT_TRUE( root );
+    EXPECT_EQ( 1, lazyNodeCount.load() );
+    EXPECT_EQ( "Root", root->m_name.value() );
+
+    // Only the array itself is created, not the children of its elements
+    ASSERT_EQ( 3u, root->m_nodes.size() );
+    EXPECT_EQ( 4, lazyNodeCount.load() );
+    EXPECT_EQ( "Node 1", root->m_nodes[1]->m_name.value() );
+    EXPECT_EQ( 4, lazyNodeCount.load() );
+
+    ASSERT_TRUE( root->m_single.object() );
+    EXPECT_EQ( "Single", root->m_single->m_name.value() );
+    EXPECT_EQ( 5, lazyNodeCount.load() );
+
+    // Writing visits every child
+    EXPECT_EQ( text, serializer.writeObjectToString( root.get() ) );
+    EXPECT_EQ( 12, lazyNodeCount.load() );
+
+    // Children can be modified before they have been created
+    lazyNodeCount = 0;
+    std::stringstream stream( text );
+    auto              copy = std::make_shared<LazyNode>();
+    serializer.readStream( copy.get(), stream );
+    EXPECT_EQ( 1, lazyNodeCount.load() );
+
+    copy->m_nodes.push_back( std::make_shared<LazyNode>() );
+    ASSERT_EQ( 4u, copy->m_nodes.size() );
+    EXPECT_EQ( "Node 2", copy->m_nodes[2]->m_name.value() );
+
+    copy->m_single.clear();
+    EXPECT_FALSE( copy->m_single.object() );
+    EXPECT_EQ( 5, lazyNodeCount.load() );
+}
+
+TEST( LazyChildren, CreatesChildrenOnceAcrossThreads )
+{
+    const auto text = caffa::JsonSerializer().writeObjectToString( createLazyTree().get() );
+
+    caffa::JsonSerializer serializer;
+    serializer.setLazyChildren( true ).setParallelReadThreshold( 2u );
+
+    lazyNodeCount = 0;
+    auto root     = serializer.createObjectFromString( text );
+    ASSERT_TRUE( root );
+
+    std::atomic<int> mismatches = 0;
+    {
+        std::vector<std::jthread> threads;
+        for ( int i = 0; i < 4; ++i )
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    if ( serializer.writeObjectToString( root.get() ) != text ) mismatches++;
+                } );
+        }
+    }
+    EXPECT_EQ( 0, mismatches.load() );
+    EXPECT_EQ( 12, lazyNodeCount.load() );
+}
+
+namespace
+{
+class ForwardingFactory : public caffa::ObjectFactory
+{
+public:
+    std::string name() const override { return "Forwarding ObjectFactory"; }
+
+private:
+    std::shared_ptr<caffa::ObjectHandle> doCreate( const std::string_view& classKeyword ) override
+    {
+        return caffa::DefaultObjectFactory::instance()->create( classKeyword );
+    }
+};
+} // namespace
+
+TEST( LazyChildren, NeedsSharedObjectFactory )
+{
+    const auto text = caffa::JsonSerializer().writeObjectToString( createLazyTree().get() );
+
+    // The lazy children could outlive a factory which is not shared, so everything is read straight away
+    ForwardingFactory     forwardingFactory;
+    caffa::JsonSerializer rawFactorySerializer( &forwardingFactory );
+    rawFactorySerializer.setLazyChildren( true );
+    EXPECT_FALSE( rawFactorySerializer.lazyChildren() );
+
+    lazyNodeCount = 0;
+    EXPECT_TRUE( rawFactorySerializer.createObjectFromString( text ) );
+    EXPECT_EQ( 12, lazyNodeCount.load() );
+
+    auto sharedFactory = std::make_shared<ForwardingFactory>();
+    caffa::JsonSerializer sharedFactorySerializer( std::static_pointer_cast<caffa::ObjectFactory>( sharedFactory ) );
+    sharedFactorySerializer.setLazyChildren( true );
+    EXPECT_TRUE( sharedFactorySerializer.lazyChildren() );
+
+    lazyNodeCount = 0;
+    EXPECT_TRUE( sharedFactorySerializer.createObjectFromString( text ) );
+    EXPECT_EQ( 1, lazyNodeCount.load() );
+
+    auto factory = caffa::DefaultObjectFactory::instance();
+
+    caffa::JsonSerializer defaultFactorySerializer( factory.get() );
+    defaultFactorySerializer.setLazyChildren( true );
+    EXPECT_TRUE( defaultFactorySerializer.lazyChildren() );
+
+    EXPECT_EQ( factory.get(), defaultFactorySerializer.objectFactory() );
+}
@@ -0,0 +1,227 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafNdjson.h"
+#include "cafObject.h"
+#include "cafParallelFor.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class NdjsonRecord : public caffa::Object
+{
+    CAFFA_HEADER_INIT( NdjsonRecord, Object )
+
+public:
+    NdjsonRecord()
+    {
+        initField( m_name, "Name" );
+        initField( m_values, "Values" );
+    }
+
+    caffa::Field<std::string>         m_name;
+    caffa::Field<std::vector<double>> m_values;
+};
+CAFFA_SOURCE_INIT( NdjsonRecord )
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class NdjsonTable : public caffa::Object
+{
+    CAFFA_HEADER_INIT( NdjsonTable, Object )
+
+public:
+    NdjsonTable() { initField( m_records, "Records" ); }
+
+    caffa::ChildArrayField<NdjsonRecord*> m_records;
+};
+CAFFA_SOURCE_INIT( NdjsonTable )
+
+namespace
+{
+std::shared_ptr<NdjsonTable> createTable( size_t recordCount )
+{
+    // The quote and line break in the names have to be escaped to keep each record on one line
+    auto table = std::make_shared<NdjsonTable>();
+    appendTestChildren( table->m_records, recordCount, "Record \"\n" );
+    return table;
+}
+
+std::vector<std::string> splitLines( const std::string& text )
+{
+    std::vector<std::string> lines;
+    std::istringstream       stream( text );
+    for ( std::string line; std::getline( stream, line ); )
+    {
+        lines.push_back( line );
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST( Ndjson, WritesOneObjectPerLine )
+{
+    auto table = createTable( 100u );
+
+    caffa::JsonSerializer serializer;
+    serializer.setSerializeUuids( false );
+
+    std::ostringstream stream;
+    EXPECT_EQ( 100u, caffa::NdjsonWriter( serializer, 64u ).write( table->m_records, stream ) );
+
+    const auto text = stream.str();
+    ASSERT_FALSE( text.empty() );
+    EXPECT_EQ( '\n', text.back() );
+
+    const auto lines = splitLines( text );
+    ASSERT_EQ( 100u, lines.size() );
+    for ( size_t i = 0; i < lines.size(); ++i )
+    {
+        EXPECT_EQ( serializer.writeObjectToString( table->m_records[i].get() ), lines[i] );
+    }
+    EXPECT_EQ( std::string::npos, lines[0].find( "uuid" ) );
+
+    // The field selector applies to every line
+    serializer.setFieldSelector( []( const caffa::FieldHandle* field ) { return field->keyword() != "Values"; } );
+    std::ostringstream selectedStream;
+    caffa::NdjsonWriter( serializer ).write( table->m_records, selectedStream );
+    const auto selectedLines = splitLines( selectedStream.str() );
+    ASSERT_EQ( 100u, selectedLines.size() );
+    EXPECT_EQ( std::string::npos, selectedLines[3].find( "Values" ) );
+
+    caffa::JsonSerializer schemaSerializer;
+    schemaSerializer.setSerializationType( caffa::JsonSerializer::SerializationType::SCHEMA );
+    EXPECT_THROW( caffa::NdjsonWriter{ schemaSerializer }, std::runtime_error );
+}
+
+TEST( Ndjson, ShardsMatchSingleStream )
+{
+    caffa::setParallelThreadCount( 4u );
+
+    auto table = createTable( 1001u );
+
+    caffa::JsonSerializer serializer;
+    caffa::NdjsonWriter   writer( serializer );
+
+    std::ostringstream singleStream;
+    EXPECT_EQ( 1001u, writer.write( table->m_records, singleStream ) );
+
+    for ( size_t shardCount : { 1u, 3u, 8u } )
+    {
+        std::vector<std::ostringstream> shards( shardCount );
+        std::vector<std::ostream*>      streams;
+        for ( auto& shard : shards )
+        {
+            streams.push_back( &shard );
+        }
+        EXPECT_EQ( 1001u, writer.write( table->m_records, streams ) );
+
+        std::string joined;
+        for ( const auto& shard : shards )
+        {
+            EXPECT_FALSE( shard.str().empty() );
+            joined += shard.str();
+        }
+        EXPECT_EQ( singleStream.str(), joined );
+    }
+
+    caffa::setParallelThreadCount( 0u );
+}
+
+TEST( Ndjson, ReadsInWindows )
+{
+    caffa::setParallelThreadCount( 4u );
+
+    auto table = createTable( 1001u );
+
+    caffa::JsonSerializer serializer;
+    std::ostringstream    stream;
+    caffa::NdjsonWriter( serializer ).write( table->m_records, stream );
+    const auto text = stream.str();
+
+    for ( size_t threshold : { 0u, 1u } )
+    {
+        for ( size_t windowSize : { 1u, 7u, 1001u, 5000u } )
+        {
+            caffa::JsonSerializer reader;
+            reader.setParallelReadThreshold( threshold );
+
+            auto               copy = std::make_shared<NdjsonTable>();
+            std::istringstream input( text );
+            EXPECT_EQ( 1001u, caffa::NdjsonReader( reader, windowSize ).read( input, copy->m_records ) );
+            EXPECT_EQ( serializer.writeObjectToString( table.get() ), serializer.writeObjectToString( copy.get() ) );
+        }
+    }
+
+    // Objects are appended after the existing children
+    auto                copy = std::make_shared<NdjsonTable>();
+    std::istringstream  first( text );
+    std::istringstream  second( text );
+    caffa::NdjsonReader reader( serializer, 100u );
+    EXPECT_EQ( 100u, reader.windowSize() );
+    reader.read( first, copy->m_records );
+    reader.read( second, copy->m_records );
+    ASSERT_EQ( 2002u, copy->m_records.size() );
+    EXPECT_EQ( table->m_records[5]->m_name.value(), copy->m_records[1006]->m_name.value() );
+
+    caffa::setParallelThreadCount( 0u );
+}
+
+TEST( Ndjson, SkipsBlankLinesAndUnknownClasses )
+{
+    caffa::JsonSerializer serializer;
+    serializer.setSerializeUuids( false );
+
+    auto record = std::make_shared<NdjsonRecord>();
+    record->m_name.setValue( "Only" );
+    const auto line = serializer.writeObjectToString( record.get() );
+
+    std::istringstream input( "\n" + line + "\r\n  \n{\"keyword\":\"NoSuchClass\"}\n" +
+                              serializer.writeObjectToString( std::make_shared<NdjsonTable>().get() ) + "\n" + line );
+
+    auto copy = std::make_shared<NdjsonTable>();
+    EXPECT_EQ( 2u, caffa::NdjsonReader( serializer ).read( input, copy->m_records ) );
+    ASSERT_EQ( 2u, copy->m_records.size() );
+    EXPECT_EQ( "Only", copy->m_records[1]->m_name.value() );
+
+    std::istringstream invalid( line + "\n" + line + "\n{\"keyword\":\n" );
+    try
+    {
+        caffa::NdjsonReader( serializer ).read( invalid, copy->m_records );
+        FAIL() << "Expected a parse error";
+    }
+    catch ( const std::runtime_error& e )
+    {
+        EXPECT_NE( std::string::npos, std::string( e.what() ).find( "line 3" ) );
+    }
+}
+
+TEST( Ndjson, ReadsFiles )
+{
+    auto table = createTable( 50u );
+
+    const auto path = std::filesystem::temp_directory_path() / "caffa_ndjson_test.ndjson";
+    {
+        std::ofstream stream( path, std::ios::binary );
+        caffa::NdjsonWriter( caffa::JsonSerializer() ).write( table->m_records, stream );
+    }
+
+    auto copy = std::make_shared<NdjsonTable>();
+    EXPECT_EQ( 50u, caffa::NdjsonReader( caffa::JsonSerializer() ).read( path, copy->m_records ) );
+    EXPECT_EQ( table->m_records[49]->uuid(), copy->m_records[49]->uuid() );
+    std::filesystem::remove( path );
+
+    EXPECT_THROW( caffa::NdjsonReader( caffa::JsonSerializer() ).read( path, copy->m_records ), std::runtime_error );
+}
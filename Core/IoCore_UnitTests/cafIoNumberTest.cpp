@@ -3,10 +3,14 @@
 
 #include "cafField.h"
 #include "cafFieldIoCapabilitySpecializations.h"
+#include "cafJsonPackedArray.h"
+#include "cafJsonSchemaCache.h"
 #include "cafJsonSerializer.h"
 #include "cafObject.h"
 
 #include <cmath>
+#include <limits>
+#include <vector>
 
 //--------------------------------------------------------------------------------------------------
 ///
@@ -33,6 +37,29 @@ public:
 };
 CAFFA_SOURCE_INIT( SimpleObjectWithNumbers )
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class ObjectWithNumberVectors : public caffa::Object
+{
+    CAFFA_HEADER_INIT( ObjectWithNumberVectors, Object )
+
+public:
+    ObjectWithNumberVectors()
+    {
+        initField( m_doubles, "Doubles" );
+        initField( m_floats, "Floats" );
+        initField( m_integers, "Integers" ).withPackedNumericArrays();
+        initField( m_names, "Names" );
+    }
+
+    caffa::Field<std::vector<double>>      m_doubles;
+    caffa::Field<std::vector<float>>       m_floats;
+    caffa::Field<std::vector<int>>         m_integers;
+    caffa::Field<std::vector<std::string>> m_names;
+};
+CAFFA_SOURCE_INIT( ObjectWithNumberVectors )
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -106,3 +133,105 @@ TEST( SerializeNumbers, SimpleObjectWithFloatValues )
         EXPECT_TRUE( diffB < epsilon );
     }
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( SerializeNumbers, PackedNumericArrays )
+{
+    ObjectWithNumberVectors obj1;
+    std::vector<double>     doubles;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        doubles.push_back( std::sin( 0.01 * i ) );
+    }
+    doubles.push_back( std::numeric_limits<double>::max() );
+    obj1.m_doubles  = doubles;
+    obj1.m_floats   = std::vector<float>{ 0.5f, -1.25f, 3.0e38f };
+    obj1.m_integers = std::vector<int>{ std::numeric_limits<int>::min(), -1, 0, 1, std::numeric_limits<int>::max() };
+    obj1.m_names    = std::vector<std::string>{ "a", "b" };
+
+    // The integers are packed on their own, everything numeric with the serializer setting
+    auto plainText  = caffa::JsonSerializer().writeObjectToString( &obj1 );
+    auto plainJson  = caffa::json::parse( plainText ).as_object();
+    auto packedText = caffa::JsonSerializer().setPackNumericArrays( true ).writeObjectToString( &obj1 );
+    auto packedJson = caffa::json::parse( packedText ).as_object();
+
+    EXPECT_TRUE( plainJson["Doubles"].is_array() );
+    EXPECT_TRUE( caffa::JsonPackedArray::isPacked( plainJson["Integers"] ) );
+    EXPECT_TRUE( caffa::JsonPackedArray::isPacked( packedJson["Doubles"] ) );
+    EXPECT_TRUE( caffa::JsonPackedArray::isPacked( packedJson["Floats"] ) );
+    EXPECT_TRUE( packedJson["Names"].is_array() );
+    EXPECT_EQ( caffa::json::value( "float64" ), packedJson["Doubles"].as_object()["dtype"] );
+    EXPECT_EQ( caffa::json::value( "int32" ), packedJson["Integers"].as_object()["dtype"] );
+    EXPECT_LT( packedText.size(), plainText.size() );
+
+    for ( const auto& text : { plainText, packedText } )
+    {
+        ObjectWithNumberVectors obj2;
+        caffa::JsonSerializer().readObjectFromString( &obj2, text );
+        EXPECT_EQ( doubles, obj2.m_doubles.value() );
+        EXPECT_EQ( obj1.m_floats.value(), obj2.m_floats.value() );
+        EXPECT_EQ( obj1.m_integers.value(), obj2.m_integers.value() );
+        EXPECT_EQ( obj1.m_names.value(), obj2.m_names.value() );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( SerializeNumbers, PackedArrayConversionAndErrors )
+{
+    auto packed = caffa::JsonPackedArray::pack( std::vector<std::uint16_t>{ 1u, 2u, 65535u } );
+    EXPECT_EQ( caffa::json::value( "uint16" ), packed["dtype"] );
+    EXPECT_EQ( caffa::json::value( "AQACAP//" ), packed["data"] );
+    EXPECT_EQ( std::vector<double>( { 1.0, 2.0, 65535.0 } ), caffa::JsonPackedArray::unpack<double>( packed ) );
+
+    auto empty = caffa::JsonPackedArray::pack( std::vector<double>() );
+    EXPECT_TRUE( caffa::JsonPackedArray::unpack<double>( empty ).empty() );
+
+    auto wrongLength      = packed;
+    wrongLength["length"] = 4;
+    EXPECT_THROW( caffa::JsonPackedArray::unpack<int>( wrongLength ), std::runtime_error );
+
+    // Times the element size this wraps around to the actual data size
+    auto overflowingLength      = packed;
+    overflowingLength["length"] = ( std::uint64_t( 1u ) << 63u ) + 3u;
+    EXPECT_THROW( caffa::JsonPackedArray::unpack<std::uint16_t>( overflowingLength ), std::runtime_error );
+
+    auto wrongType     = packed;
+    wrongType["dtype"] = "complex128";
+    EXPECT_THROW( caffa::JsonPackedArray::unpack<int>( wrongType ), std::runtime_error );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( SerializeNumbers, PackedNumericArraySchema )
+{
+    ObjectWithNumberVectors obj;
+
+    caffa::JsonSchemaCache cache;
+    caffa::JsonSerializer  serializer;
+    serializer.setSerializationType( caffa::JsonSerializer::SerializationType::SCHEMA ).setSchemaCache( &cache );
+
+    auto schema     = caffa::json::parse( serializer.writeObjectToString( &obj ) ).as_object();
+    auto properties = schema["properties"].as_object();
+
+    // Only the integers are packed on their own
+    EXPECT_EQ( caffa::json::value( "array" ), properties["Doubles"].as_object()["type"] );
+    ASSERT_TRUE( properties["Integers"].as_object().contains( "oneOf" ) );
+    auto integerSchemas = properties["Integers"].as_object()["oneOf"].as_array();
+    ASSERT_EQ( 2u, integerSchemas.size() );
+    EXPECT_EQ( caffa::json::value( "array" ), integerSchemas[0].as_object()["type"] );
+    EXPECT_EQ( caffa::json::value( caffa::JsonPackedArray::jsonSchema() ), integerSchemas[1] );
+
+    // Packing everything gives other schemas, which are cached separately
+    serializer.setPackNumericArrays( true );
+    auto packedSchema     = caffa::json::parse( serializer.writeObjectToString( &obj ) ).as_object();
+    auto packedProperties = packedSchema["properties"].as_object();
+    EXPECT_TRUE( packedProperties["Doubles"].as_object().contains( "oneOf" ) );
+    EXPECT_TRUE( packedProperties["Floats"].as_object().contains( "oneOf" ) );
+    EXPECT_FALSE( packedProperties["Names"].as_object().contains( "oneOf" ) );
+    EXPECT_EQ( 2u, cache.size() );
+}
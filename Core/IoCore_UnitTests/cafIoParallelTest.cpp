@@ -0,0 +1,288 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+#include "cafParallelFor.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class ParallelLeaf : public caffa::Object
+{
+    CAFFA_HEADER_INIT( ParallelLeaf, Object )
+
+public:
+    ParallelLeaf()
+    {
+        initField( m_name, "Name" );
+        initField( m_values, "Values" );
+        initField( m_leaves, "Leaves" );
+    }
+
+    caffa::Field<std::string>             m_name;
+    caffa::Field<std::vector<double>>     m_values;
+    caffa::ChildArrayField<ParallelLeaf*> m_leaves;
+};
+CAFFA_SOURCE_INIT( ParallelLeaf )
+
+namespace
+{
+std::shared_ptr<ParallelLeaf> createParallelTree( size_t childCount )
+{
+    auto root = std::make_shared<ParallelLeaf>();
+    root->m_name.setValue( "Root" );
+    appendTestChildren( root->m_leaves, childCount, "Child " );
+    for ( size_t i = 0; i < childCount; ++i )
+    {
+        appendTestChildren( root->m_leaves[i]->m_leaves, i % 3, "Grandchild " );
+    }
+    return root;
+}
+
+class ParallelTest : public ::testing::Test
+{
+protected:
+    // Use several threads even on machines with a single core
+    void SetUp() override { caffa::setParallelThreadCount( 4u ); }
+    void TearDown() override { caffa::setParallelThreadCount( 0u ); }
+};
+
+} // namespace
+
+TEST_F( ParallelTest, ParallelForCoversEveryIndex )
+{
+    std::vector<std::atomic<int>> visits( 1001 );
+    caffa::parallelFor( visits.size(),
+                        7u,
+                        [&visits]( size_t begin, size_t end )
+                        {
+                            for ( size_t i = begin; i < end; ++i )
+                            {
+                                visits[i]++;
+                                // Nested loops run on the calling thread
+                                caffa::parallelFor( 3u, 1u, [&visits, i]( size_t, size_t ) { visits[i]++; } );
+                            }
+                        } );
+    for ( const auto& visit : visits )
+    {
+        EXPECT_EQ( 2, visit.load() );
+    }
+
+    EXPECT_THROW( caffa::parallelFor( 100u,
+                                      1u,
+                                      []( size_t begin, size_t end )
+                                      {
+                                          if ( begin <= 50u && 50u < end ) throw std::runtime_error( "Failed" );
+                                      } ),
+                  std::runtime_error );
+
+    // The threads are kept between calls
+    std::set<std::thread::id> threadIds;
+    std::mutex                threadIdMutex;
+    for ( size_t call = 0; call < 50u; ++call )
+    {
+        caffa::parallelFor( 100u,
+                            1u,
+                            [&threadIds, &threadIdMutex]( size_t, size_t )
+                            {
+                                std::scoped_lock lock( threadIdMutex );
+                                threadIds.insert( std::this_thread::get_id() );
+                            } );
+    }
+    EXPECT_LE( threadIds.size(), 4u );
+}
+
+TEST_F( ParallelTest, ParallelWriteMatchesSerialWrite )
+{
+    auto root = createParallelTree( 500u );
+
+    caffa::JsonSerializer serialSerializer;
+    const auto            serialString = serialSerializer.writeObjectToString( root.get() );
+    const auto            prettyString = serialSerializer.writeObjectToString( root.get(), true );
+    caffa::json::object   serialJson;
+    serialSerializer.writeObjectToJson( root.get(), serialJson );
+
+    for ( size_t grainSize : { 1u, 16u, 499u, 500u } )
+    {
+        caffa::JsonSerializer parallelSerializer;
+        parallelSerializer.setParallelWriteGrainSize( grainSize );
+        EXPECT_EQ( grainSize, parallelSerializer.parallelWriteGrainSize() );
+
+        EXPECT_EQ( serialString, parallelSerializer.writeObjectToString( root.get() ) );
+        EXPECT_EQ( serialString, parallelSerializer.writeObjectToString( root.get() ) );
+        EXPECT_EQ( prettyString, parallelSerializer.writeObjectToString( root.get(), true ) );
+
+        caffa::json::object parallelJson;
+        parallelSerializer.writeObjectToJson( root.get(), parallelJson );
+        EXPECT_EQ( serialJson, parallelJson );
+    }
+
+    caffa::JsonSerializer skeletonSerializer;
+    skeletonSerializer.setSerializationType( caffa::JsonSerializer::SerializationType::DATA_SKELETON );
+    const auto skeletonString = skeletonSerializer.writeObjectToString( root.get() );
+    skeletonSerializer.setParallelWriteGrainSize( 10u );
+    EXPECT_EQ( skeletonString, skeletonSerializer.writeObjectToString( root.get() ) );
+
+    auto copy = caffa::JsonSerializer().createObjectFromString( serialString );
+    ASSERT_TRUE( copy );
+    EXPECT_EQ( serialString, serialSerializer.writeObjectToString( copy.get() ) );
+}
+
+TEST_F( ParallelTest, ParallelReadMatchesSerialRead )
+{
+    auto       root         = createParallelTree( 500u );
+    const auto serialString = caffa::JsonSerializer().writeObjectToString( root.get() );
+
+    for ( size_t threshold : { 1u, 100u, 500u, 501u } )
+    {
+        caffa::JsonSerializer parallelSerializer;
+        parallelSerializer.setParallelReadThreshold( threshold );
+        EXPECT_EQ( threshold, parallelSerializer.parallelReadThreshold() );
+
+        auto copy =
+            std::dynamic_pointer_cast<ParallelLeaf>( parallelSerializer.createObjectFromString( serialString ) );
+        ASSERT_TRUE( copy );
+        ASSERT_EQ( 500u, copy->m_leaves.size() );
+        EXPECT_EQ( serialString, parallelSerializer.writeObjectToString( copy.get() ) );
+
+        auto jsonCopy = std::make_shared<ParallelLeaf>();
+        parallelSerializer.readObjectFromJson( jsonCopy.get(), caffa::json::parse( serialString ).as_object() );
+        EXPECT_EQ( serialString, parallelSerializer.writeObjectToString( jsonCopy.get() ) );
+    }
+
+    // Unknown classes are skipped and the rest of the array is kept in order
+    auto  jsonRoot   = caffa::json::parse( serialString ).as_object();
+    auto& jsonLeaves = jsonRoot["Leaves"].as_array();
+    jsonLeaves[1].as_object()["keyword"] = "NoSuchClass";
+
+    caffa::JsonSerializer parallelSerializer;
+    parallelSerializer.setParallelReadThreshold( 1u );
+    auto copy = std::make_shared<ParallelLeaf>();
+    parallelSerializer.readObjectFromJson( copy.get(), jsonRoot );
+    ASSERT_EQ( 499u, copy->m_leaves.size() );
+    EXPECT_EQ( "Child 0", copy->m_leaves[0]->m_name.value() );
+    EXPECT_EQ( "Child 2", copy->m_leaves[1]->m_name.value() );
+
+    copy->m_leaves.push_back_objs( { std::make_shared<ParallelLeaf>(), nullptr } );
+    EXPECT_EQ( 500u, copy->m_leaves.size() );
+}
+
+TEST_F( ParallelTest, SharedSerializerAcrossThreads )
+{
+    auto root = createParallelTree( 50u );
+
+    caffa::JsonSerializer skeletonSerializer;
+    skeletonSerializer.setSerializationType( caffa::JsonSerializer::SerializationType::DATA_SKELETON );
+
+    const auto skeletonString = skeletonSerializer.writeObjectToString( root.get() );
+    const auto fullString     = caffa::JsonSerializer().writeObjectToString( root.get() );
+
+    // Only the top level object gets its fields written in a skeleton
+    auto skeleton = caffa::json::parse( skeletonString ).as_object();
+    ASSERT_TRUE( skeleton.contains( "Leaves" ) );
+    EXPECT_FALSE( skeleton["Leaves"].as_array()[0].as_object().contains( "Name" ) );
+
+    // Writing a child through its field on its own makes the child the top level object
+    caffa::json::value childValue;
+    root->m_leaves.capability<caffa::FieldIoCapability>()->writeToJson( childValue, skeletonSerializer );
+    EXPECT_TRUE( childValue.as_array()[0].as_object().contains( "Name" ) );
+
+    const caffa::JsonSerializer sharedSerializer;
+    std::atomic<int>            mismatches = 0;
+    {
+        std::vector<std::jthread> threads;
+        for ( int i = 0; i < 4; ++i )
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    for ( int j = 0; j < 20; ++j )
+                    {
+                        if ( sharedSerializer.writeObjectToString( root.get() ) != fullString ) mismatches++;
+                        if ( skeletonSerializer.writeObjectToString( root.get() ) != skeletonString ) mismatches++;
+                    }
+                } );
+        }
+    }
+    EXPECT_EQ( 0, mismatches.load() );
+}
+
+TEST_F( ParallelTest, WriteWithMemoryResource )
+{
+    auto       root           = createParallelTree( 200u );
+    const auto expectedString = caffa::JsonSerializer().writeObjectToString( root.get() );
+
+    boost::json::monotonic_resource arena;
+
+    caffa::JsonSerializer serializer;
+    serializer.setMemoryResource( &arena ).setParallelWriteGrainSize( 10u );
+    EXPECT_EQ( &arena, serializer.memoryResource().get() );
+
+    {
+        // Values are allocated from the storage of the object written to, all the way down the tree
+        caffa::json::object jsonObject( &arena );
+        serializer.writeObjectToJson( root.get(), jsonObject );
+        EXPECT_EQ( expectedString, caffa::json::dump( jsonObject ) );
+
+        const auto& jsonLeaves = jsonObject["Leaves"].as_array();
+        EXPECT_EQ( &arena, jsonLeaves.storage().get() );
+        EXPECT_EQ( &arena, jsonLeaves[5].as_object().at( "Values" ).storage().get() );
+    }
+
+    auto copy = serializer.copyBySerialization( root.get() );
+    ASSERT_TRUE( copy );
+    EXPECT_EQ( expectedString, caffa::JsonSerializer().writeObjectToString( copy.get() ) );
+
+    const auto parsed = caffa::json::parse( expectedString, &arena );
+    EXPECT_EQ( &arena, parsed.storage().get() );
+    EXPECT_EQ( &arena, parsed.as_object().storage().get() );
+}
+
+TEST_F( ParallelTest, ReadStreamWithMemoryResource )
+{
+    class CountingResource : public boost::json::memory_resource
+    {
+    public:
+        size_t allocations = 0u;
+
+    private:
+        void* do_allocate( std::size_t bytes, std::size_t alignment ) override
+        {
+            ++allocations;
+            return m_arena.allocate( bytes, alignment );
+        }
+        void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override {}
+        bool do_is_equal( const boost::json::memory_resource& other ) const noexcept override
+        {
+            return this == &other;
+        }
+
+        boost::json::monotonic_resource m_arena;
+    };
+
+    auto       root           = createParallelTree( 20u );
+    const auto expectedString = caffa::JsonSerializer().writeObjectToString( root.get() );
+
+    CountingResource      resource;
+    caffa::JsonSerializer serializer;
+    serializer.setMemoryResource( &resource );
+
+    // Streamed reads keep their field values in an arena released after each value, not in the resource
+    std::stringstream stream( expectedString );
+    auto              copy = std::make_shared<ParallelLeaf>();
+    serializer.readStream( copy.get(), stream );
+    EXPECT_EQ( expectedString, caffa::JsonSerializer().writeObjectToString( copy.get() ) );
+    EXPECT_EQ( 0u, resource.allocations );
+}
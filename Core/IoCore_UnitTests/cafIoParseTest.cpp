@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+
+#include "cafJsonDefinitions.h"
+
+#include <string>
+
+TEST( JsonParse, ClassifiesText )
+{
+    for ( const char* text : { "0", "-0", "12", "-1.5", "1e5", "2.5E-3", "1E+2", " 7 ", "null", "true", "false",
+                               R"("quoted")", "{}", "[1,2]", "\t{\"a\":1}\n" } )
+    {
+        EXPECT_TRUE( caffa::json::isParsableJson( text ) ) << text;
+    }
+    for ( const char* text : { "", "   ", "01", "-", "1.", ".5", "1e", "1e+", "+1", "1.5.2", "nul", "True", "\"",
+                               "{", "[1", "hello world", "12abc" } )
+    {
+        EXPECT_FALSE( caffa::json::isParsableJson( text ) ) << text;
+    }
+}
+
+TEST( JsonParse, ParsesBareStrings )
+{
+    EXPECT_EQ( caffa::json::value( 42 ), caffa::json::parse( " 42 " ) );
+    EXPECT_EQ( caffa::json::value( -2.5 ), caffa::json::parse( "-2.5" ) );
+    EXPECT_EQ( caffa::json::value( true ), caffa::json::parse( "true" ) );
+    EXPECT_EQ( caffa::json::value( "quoted" ), caffa::json::parse( R"("quoted")" ) );
+
+    // Bare strings are taken as they are, without interpreting quotes or backslashes
+    EXPECT_EQ( caffa::json::value( "hello world" ), caffa::json::parse( "  hello world\n" ) );
+    EXPECT_EQ( caffa::json::value( R"(C:\temp "a")" ), caffa::json::parse( R"(C:\temp "a")" ) );
+    EXPECT_EQ( caffa::json::value( "01" ), caffa::json::parse( "01" ) );
+    EXPECT_EQ( caffa::json::value( "" ), caffa::json::parse( "   " ) );
+}
+
+TEST( JsonParse, ReportsErrorOffsets )
+{
+    caffa::json::ParseError error;
+    EXPECT_EQ( caffa::json::parse( R"({"a":[1,2]})" ), caffa::json::parse( R"({"a":[1,2]})", error ) );
+    EXPECT_TRUE( error.message.empty() );
+
+    const std::string invalid = R"(  {"a":[1,2}  )";
+    EXPECT_TRUE( caffa::json::parse( invalid, error ).is_null() );
+    EXPECT_FALSE( error.message.empty() );
+    EXPECT_EQ( invalid.find( '}' ), error.offset );
+
+    error = {};
+    EXPECT_TRUE( caffa::json::parse( R"([1,2] [3])", error ).is_null() );
+    EXPECT_FALSE( error.message.empty() );
+
+    // Errors are also logged and give null
+    EXPECT_TRUE( caffa::json::parse( invalid ).is_null() );
+}
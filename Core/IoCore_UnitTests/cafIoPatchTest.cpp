@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonPatch.h"
+#include "cafObject.h"
+#include "cafRangeValidator.h"
+
+#include <stdexcept>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class PatchItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( PatchItem, Object )
+
+public:
+    PatchItem()
+    {
+        initField( m_name, "Name" );
+        initField( m_count, "Count" ).withDefault( 0 );
+        initField( m_values, "Values" );
+        initField( m_packed, "Packed" ).withPackedNumericArrays();
+        initField( m_single, "Single" );
+        initField( m_items, "Items" );
+
+        m_count.addValidator( std::make_unique<caffa::RangeValidator<int>>( 0, 100 ) );
+    }
+
+    caffa::Field<std::string>          m_name;
+    caffa::Field<int>                  m_count;
+    caffa::Field<std::vector<int>>     m_values;
+    caffa::Field<std::vector<double>>  m_packed;
+    caffa::ChildField<PatchItem*>      m_single;
+    caffa::ChildArrayField<PatchItem*> m_items;
+};
+CAFFA_SOURCE_INIT( PatchItem )
+
+namespace
+{
+std::shared_ptr<PatchItem> createPatchTree()
+{
+    auto root = std::make_shared<PatchItem>();
+    root->m_name.setValue( "Root" );
+    root->m_values.setValue( { 1, 2, 3 } );
+    root->m_packed.setValue( { 0.5, 1.5 } );
+    appendTestChildren( root->m_items, 5u, "Item " );
+    return root;
+}
+
+} // namespace
+
+TEST( JsonPatch, FieldOperations )
+{
+    auto root = createPatchTree();
+
+    caffa::JsonPatch patch;
+    patch.applyFromString( root.get(),
+                           R"([{"op":"test","path":"/Name","value":"Root"},)"
+                           R"({"op":"replace","path":"/Name","value":"Patched"},)"
+                           R"({"op":"replace","path":"/Items/2/Count","value":42},)"
+                           R"({"op":"add","path":"/Values/1","value":10},)"
+                           R"({"op":"remove","path":"/Values/0"},)"
+                           R"({"op":"add","path":"/Values/-","value":4},)"
+                           R"({"op":"test","path":"/Items/2/Count","value":42.0}])" );
+
+    EXPECT_EQ( "Patched", root->m_name.value() );
+    EXPECT_EQ( 42, root->m_items[2]->m_count.value() );
+    EXPECT_EQ( std::vector<int>( { 10, 2, 3, 4 } ), root->m_values.value() );
+    EXPECT_EQ( caffa::json::value( "Item 1" ), patch.valueAt( root.get(), "/Items/1/Name" ) );
+
+    // Validators are run
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"replace","path":"/Count","value":1000}])" ),
+                  std::runtime_error );
+    EXPECT_EQ( 0, root->m_count.value() );
+
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"test","path":"/Name","value":"Root"}])" ),
+                  std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"remove","path":"/Name"}])" ), std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"add","path":"/NoSuchField","value":1}])" ),
+                  std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"remove","path":"/Items/5"}])" ), std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"remove","path":"/Items/01"}])" ), std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"frobnicate","path":""}])" ), std::runtime_error );
+}
+
+TEST( JsonPatch, ObjectOperations )
+{
+    auto root = createPatchTree();
+
+    auto item0 = root->m_items[0];
+    auto item3 = root->m_items[3];
+
+    caffa::JsonPatch patch;
+    patch.applyFromString( root.get(),
+                           R"([{"op":"add","path":"/Items/1","value":{"keyword":"PatchItem","Name":"New"}},)"
+                           R"({"op":"remove","path":"/Items/0"},)"
+                           R"({"op":"move","from":"/Items/3","path":"/Single"},)"
+                           R"({"op":"add","path":"/Single/Items/-","value":{"keyword":"PatchItem","Name":"Deep"}}])" );
+
+    ASSERT_EQ( 4u, root->m_items.size() );
+    EXPECT_EQ( "New", root->m_items[0]->m_name.value() );
+    EXPECT_EQ( "Item 1", root->m_items[1]->m_name.value() );
+    EXPECT_EQ( "Item 4", root->m_items[3]->m_name.value() );
+
+    // Moved objects are the same instances
+    EXPECT_EQ( item3, root->m_single.object() );
+    ASSERT_EQ( 1u, root->m_single->m_items.size() );
+    EXPECT_EQ( "Deep", root->m_single->m_items[0]->m_name.value() );
+
+    // Moving within the same array
+    patch.applyFromString( root.get(), R"([{"op":"move","from":"/Items/0","path":"/Items/-"}])" );
+    EXPECT_EQ( "New", root->m_items[3]->m_name.value() );
+
+    // Copies get their own UUID
+    patch.applyFromString( root.get(), R"([{"op":"copy","from":"/Single","path":"/Items/0"}])" );
+    ASSERT_EQ( 5u, root->m_items.size() );
+    EXPECT_EQ( "Item 3", root->m_items[0]->m_name.value() );
+    EXPECT_NE( item3->uuid(), root->m_items[0]->uuid() );
+    EXPECT_EQ( 1u, root->m_items[0]->m_items.size() );
+
+    patch.applyFromString( root.get(),
+                           R"([{"op":"replace","path":"/Items/0","value":{"keyword":"PatchItem","Name":"Replaced"}},)"
+                           R"({"op":"remove","path":"/Single"}])" );
+    EXPECT_EQ( "Replaced", root->m_items[0]->m_name.value() );
+    EXPECT_FALSE( root->m_single );
+
+    // Objects can not be moved into their own children and failed moves put the object back
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"move","from":"/Items/1","path":"/Items/1/Items/0"}])" ),
+                  std::runtime_error );
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"move","from":"/Items/1","path":"/Items/9"}])" ),
+                  std::runtime_error );
+    ASSERT_EQ( 5u, root->m_items.size() );
+    EXPECT_EQ( "Item 1", root->m_items[1]->m_name.value() );
+
+    EXPECT_THROW( patch.applyFromString( root.get(), R"([{"op":"add","path":"/Items/0","value":{"keyword":"Nope"}}])" ),
+                  std::runtime_error );
+    EXPECT_THROW( patch.valueAt( root.get(), "/Single/Name" ), std::runtime_error );
+}
+
+TEST( JsonPatch, PackedArraysAndChildArrays )
+{
+    auto root = createPatchTree();
+
+    // Packed numeric arrays are addressed like plain arrays
+    caffa::JsonPatch patch;
+    patch.applyFromString( root.get(),
+                           R"([{"op":"test","path":"/Packed","value":[0.5,1.5]},)"
+                           R"({"op":"test","path":"/Packed/1","value":1.5},)"
+                           R"({"op":"replace","path":"/Packed/0","value":2.5},)"
+                           R"({"op":"add","path":"/Packed/-","value":3.5}])" );
+    EXPECT_EQ( std::vector<double>( { 2.5, 1.5, 3.5 } ), root->m_packed.value() );
+    EXPECT_EQ( caffa::json::value( 3.5 ), patch.valueAt( root.get(), "/Packed/2" ) );
+
+    // Empty entries in a child array can not be resolved through
+    root->m_items.push_back( nullptr );
+    EXPECT_THROW( patch.valueAt( root.get(), "/Items/5/Name" ), std::runtime_error );
+    EXPECT_THROW( patch.valueAt( root.get(), "/Items/5" ), std::runtime_error );
+
+    // Removing a whole child array clears it
+    patch.applyFromString( root.get(), R"([{"op":"remove","path":"/Items"}])" );
+    EXPECT_EQ( 0u, root->m_items.size() );
+}
@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+#include "cafSerializationPlan.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class PlanItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( PlanItem, Object )
+
+public:
+    PlanItem()
+    {
+        initField( m_name, "Name" );
+        initField( m_value, "Value" ).withDefault( 0 );
+        initField( m_old, "Old" ).withDefault( 1 ).markDeprecated();
+        initField( m_child, "Child" );
+        initField( m_items, "Items" );
+    }
+
+    caffa::Field<std::string>         m_name;
+    caffa::Field<int>                 m_value;
+    caffa::Field<int>                 m_old;
+    caffa::ChildField<PlanItem*>      m_child;
+    caffa::ChildArrayField<PlanItem*> m_items;
+};
+CAFFA_SOURCE_INIT( PlanItem )
+
+//--------------------------------------------------------------------------------------------------
+/// Registers its value field under another keyword when asked to
+//--------------------------------------------------------------------------------------------------
+class SwappedPlanItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( SwappedPlanItem, Object )
+
+public:
+    explicit SwappedPlanItem( bool swapped = false )
+    {
+        initField( m_name, "Name" );
+        initField( m_value, swapped ? "Swapped" : "Value" ).withDefault( 0 );
+    }
+
+    caffa::Field<std::string> m_name;
+    caffa::Field<int>         m_value;
+};
+CAFFA_SOURCE_INIT( SwappedPlanItem )
+
+TEST( SerializationPlan, SharedBetweenObjectsOfAClass )
+{
+    auto first  = std::make_shared<PlanItem>();
+    auto second = std::make_shared<PlanItem>();
+
+    std::optional<caffa::SerializationPlan> ownPlan;
+    const auto&                             plan = caffa::SerializationPlan::forObject( first.get(), ownPlan );
+    EXPECT_EQ( &plan, &caffa::SerializationPlan::forObject( second.get(), ownPlan ) );
+    EXPECT_FALSE( ownPlan );
+
+    ASSERT_EQ( 5u, plan.entries().size() );
+    EXPECT_EQ( "Child", plan.entries().front().keyword );
+    EXPECT_EQ( "Value", plan.entries().back().keyword );
+
+    const auto* value = plan.findEntry( "Value" );
+    ASSERT_TRUE( value );
+    EXPECT_EQ( &second->m_value, caffa::SerializationPlan::field( second.get(), *value ) );
+    EXPECT_EQ( second->m_value.capability<caffa::FieldIoCapability>(),
+               caffa::SerializationPlan::ioCapability( &second->m_value, *value ) );
+    EXPECT_EQ( caffa::SerializationPlan::FieldKind::DATA, value->kind );
+    EXPECT_FALSE( value->deprecated );
+
+    EXPECT_TRUE( plan.findEntry( "Old" )->deprecated );
+    EXPECT_EQ( caffa::SerializationPlan::FieldKind::CHILD, plan.findEntry( "Child" )->kind );
+    EXPECT_EQ( caffa::SerializationPlan::FieldKind::CHILD_ARRAY, plan.findEntry( "Items" )->kind );
+    EXPECT_FALSE( plan.findEntry( "Missing" ) );
+}
+
+TEST( SerializationPlan, OwnPlanForAnotherLayout )
+{
+    auto first   = std::make_shared<SwappedPlanItem>();
+    auto swapped = std::make_shared<SwappedPlanItem>( true );
+
+    std::optional<caffa::SerializationPlan> ownPlan;
+    const auto&                             plan = caffa::SerializationPlan::forObject( first.get(), ownPlan );
+    EXPECT_FALSE( ownPlan );
+    ASSERT_TRUE( plan.findEntry( "Value" ) );
+
+    // Same number of fields, but one under another keyword
+    const auto& swappedPlan = caffa::SerializationPlan::forObject( swapped.get(), ownPlan );
+    ASSERT_TRUE( ownPlan );
+    EXPECT_EQ( &*ownPlan, &swappedPlan );
+    EXPECT_FALSE( swappedPlan.findEntry( "Value" ) );
+
+    const auto* entry = swappedPlan.findEntry( "Swapped" );
+    ASSERT_TRUE( entry );
+    EXPECT_EQ( &swapped->m_value, caffa::SerializationPlan::field( swapped.get(), *entry ) );
+
+    std::optional<caffa::SerializationPlan> secondOwnPlan;
+    EXPECT_EQ( &plan, &caffa::SerializationPlan::forObject( first.get(), secondOwnPlan ) );
+    EXPECT_FALSE( secondOwnPlan );
+}
+
+TEST( SerializationPlan, ReadAndWriteThroughPlans )
+{
+    auto root = std::make_shared<PlanItem>();
+    root->m_name.setValue( "Root" );
+    root->m_old.setValue( 5 );
+    appendTestChildren( root->m_items,
+                        100u,
+                        "Item ",
+                        []( PlanItem& item, size_t i ) { item.m_value.setValue( static_cast<int>( i ) ); } );
+    auto child = std::make_shared<PlanItem>();
+    child->m_value.setValue( -1 );
+    root->m_child = child;
+
+    caffa::JsonSerializer serializer;
+    serializer.setSerializeUuids( false );
+
+    const auto string = serializer.writeObjectToString( root.get() );
+
+    caffa::json::object jsonObject;
+    serializer.writeObjectToJson( root.get(), jsonObject );
+    EXPECT_EQ( string, caffa::json::dump( jsonObject ) );
+
+    // Deprecated fields are neither written nor expected when reading
+    EXPECT_FALSE( jsonObject.contains( "Old" ) );
+    EXPECT_EQ( 100u, jsonObject["Items"].as_array().size() );
+
+    auto copy = std::dynamic_pointer_cast<PlanItem>( serializer.createObjectFromString( string ) );
+    ASSERT_TRUE( copy );
+    EXPECT_EQ( string, serializer.writeObjectToString( copy.get() ) );
+    ASSERT_EQ( 100u, copy->m_items.size() );
+    EXPECT_EQ( 99, copy->m_items[99]->m_value.value() );
+    EXPECT_EQ( -1, copy->m_child->m_value.value() );
+    EXPECT_EQ( 1, copy->m_old.value() );
+
+    auto jsonCopy = std::make_shared<PlanItem>();
+    serializer.readObjectFromJson( jsonCopy.get(), jsonObject );
+    EXPECT_EQ( string, serializer.writeObjectToString( jsonCopy.get() ) );
+
+    auto clone = serializer.cloneObject( root.get() );
+    ASSERT_TRUE( clone );
+    EXPECT_EQ( string, serializer.writeObjectToString( clone.get() ) );
+
+    jsonObject["Unknown"] = 1;
+    EXPECT_THROW( serializer.readObjectFromJson( jsonCopy.get(), jsonObject ), std::runtime_error );
+    EXPECT_THROW( serializer.readObjectFromString( jsonCopy.get(), caffa::json::dump( jsonObject ) ),
+                  std::runtime_error );
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafFieldProjection.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class ProjectionItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( ProjectionItem, Object )
+
+public:
+    ProjectionItem()
+    {
+        initField( m_name, "Name" );
+        initField( m_status, "Status" );
+        initField( m_values, "Values" );
+        initField( m_children, "Children" );
+    }
+
+    caffa::Field<std::string>               m_name;
+    caffa::Field<int>                       m_status;
+    caffa::Field<std::vector<double>>       m_values;
+    caffa::ChildArrayField<ProjectionItem*> m_children;
+};
+CAFFA_SOURCE_INIT( ProjectionItem )
+
+namespace
+{
+std::shared_ptr<ProjectionItem> createProjectionTree()
+{
+    auto root = std::make_shared<ProjectionItem>();
+    root->m_name.setValue( "Root" );
+    appendTestChildren( root->m_children,
+                        5u,
+                        "Child ",
+                        []( ProjectionItem& child, size_t i )
+                        {
+                            child.m_status.setValue( static_cast<int>( i ) );
+                            child.m_values.setValue( std::vector<double>( 10, 1.0 * i ) );
+                            appendTestChildren( child.m_children, 1u, "Grandchild " );
+                        } );
+    return root;
+}
+
+std::shared_ptr<const caffa::FieldProjection> projection( std::string_view paths )
+{
+    return std::make_shared<caffa::FieldProjection>( caffa::FieldProjection::parse( paths ) );
+}
+
+} // namespace
+
+TEST( FieldProjection, WritesSelectedFields )
+{
+    auto root = createProjectionTree();
+
+    caffa::JsonSerializer serializer;
+    serializer.setProjection( projection( "Children[*].Name, Children[*].Status" ) );
+    ASSERT_TRUE( serializer.projection() );
+    EXPECT_EQ( 2u, serializer.projection()->paths().size() );
+
+    const auto text     = serializer.writeObjectToString( root.get() );
+    const auto jsonRoot = caffa::json::parse( text ).as_object();
+    EXPECT_EQ( "ProjectionItem", jsonRoot.at( "keyword" ).as_string() );
+    EXPECT_TRUE( jsonRoot.contains( "uuid" ) );
+    EXPECT_FALSE( jsonRoot.contains( "Name" ) );
+    EXPECT_FALSE( jsonRoot.contains( "Values" ) );
+
+    const auto& jsonChildren = jsonRoot.at( "Children" ).as_array();
+    ASSERT_EQ( 5u, jsonChildren.size() );
+    for ( size_t i = 0; i < jsonChildren.size(); ++i )
+    {
+        const auto& jsonChild = jsonChildren[i].as_object();
+        EXPECT_EQ( "Child " + std::to_string( i ), jsonChild.at( "Name" ).as_string() );
+        EXPECT_EQ( static_cast<int64_t>( i ), jsonChild.at( "Status" ).as_int64() );
+        EXPECT_FALSE( jsonChild.contains( "Values" ) );
+        EXPECT_FALSE( jsonChild.contains( "Children" ) );
+    }
+
+    // Writing to JSON and writing in parallel gives the same result
+    caffa::json::object jsonObject;
+    serializer.writeObjectToJson( root.get(), jsonObject );
+    EXPECT_EQ( text, caffa::json::dump( jsonObject ) );
+    serializer.setParallelWriteGrainSize( 2u );
+    EXPECT_EQ( text, serializer.writeObjectToString( root.get() ) );
+
+    // A path ending at a child field selects everything below it, and wildcards add to named fields
+    serializer.setProjection( projection( "Children.Values,*.Children" ) );
+    const auto wideRoot  = caffa::json::parse( serializer.writeObjectToString( root.get() ) ).as_object();
+    const auto wideChild = wideRoot.at( "Children" ).as_array()[0].as_object();
+    EXPECT_TRUE( wideRoot.contains( "Name" ) );
+    EXPECT_TRUE( wideChild.contains( "Values" ) );
+    EXPECT_EQ( "Grandchild 0", wideChild.at( "Children" ).as_array()[0].as_object().at( "Name" ).as_string() );
+    EXPECT_FALSE( wideChild.contains( "Name" ) );
+
+    serializer.setProjection( nullptr );
+    const auto fullText = caffa::JsonSerializer().writeObjectToString( root.get() );
+    EXPECT_EQ( fullText, serializer.writeObjectToString( root.get() ) );
+}
+
+TEST( FieldProjection, SkipsUnselectedSubtrees )
+{
+    auto root = createProjectionTree();
+
+    // Fields below the projection are never offered to the field selector
+    size_t                selectorCalls = 0u;
+    caffa::JsonSerializer serializer;
+    serializer.setFieldSelector(
+        [&selectorCalls]( const caffa::FieldHandle* )
+        {
+            selectorCalls++;
+            return true;
+        } );
+    serializer.setProjection( projection( "Name" ) );
+
+    const auto jsonRoot = caffa::json::parse( serializer.writeObjectToString( root.get() ) ).as_object();
+    EXPECT_EQ( 4u, selectorCalls );
+    EXPECT_TRUE( jsonRoot.contains( "Name" ) );
+    EXPECT_FALSE( jsonRoot.contains( "Children" ) );
+
+    for ( const char* invalid : { "", "Children..Name", "Children[0].Name", "Children[*", ".Name" } )
+    {
+        EXPECT_THROW( caffa::FieldProjection::parse( invalid ), std::runtime_error ) << invalid;
+    }
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafObject.h"
+
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class ReconcileItem : public caffa::Object
+{
+    CAFFA_HEADER_INIT( ReconcileItem, Object )
+
+public:
+    ReconcileItem()
+    {
+        initField( m_name, "Name" );
+        initField( m_items, "Items" );
+    }
+
+    caffa::Field<std::string>              m_name;
+    caffa::ChildArrayField<ReconcileItem*> m_items;
+};
+CAFFA_SOURCE_INIT( ReconcileItem )
+
+namespace
+{
+std::shared_ptr<ReconcileItem> createReconcileTree( size_t childCount )
+{
+    auto root = std::make_shared<ReconcileItem>();
+    root->m_name.setValue( "Root" );
+    appendTestChildren( root->m_items,
+                        childCount,
+                        "Child ",
+                        []( ReconcileItem& child, size_t )
+                        { appendTestChildren( child.m_items, 1u, "Grandchild " ); } );
+    return root;
+}
+
+/// The new state of the tree: Child 0 is removed, Child 1 moved last and renamed and a new child added
+caffa::json::object createRefresh( const caffa::JsonSerializer& serializer, const ReconcileItem* root )
+{
+    caffa::json::object jsonRoot;
+    serializer.writeObjectToJson( root, jsonRoot );
+
+    auto& jsonItems = jsonRoot["Items"].as_array();
+    auto  moved     = jsonItems[1];
+    moved.as_object()["Name"] = "Renamed";
+    jsonItems.erase( jsonItems.begin(), jsonItems.begin() + 2 );
+    jsonItems.push_back( moved );
+
+    auto added = std::make_shared<ReconcileItem>();
+    added->m_name.setValue( "Added" );
+    caffa::json::object jsonAdded;
+    serializer.writeObjectToJson( added.get(), jsonAdded );
+    jsonItems.push_back( jsonAdded );
+    return jsonRoot;
+}
+
+void expectReconciled( const std::vector<std::shared_ptr<ReconcileItem>>& before, const ReconcileItem* root )
+{
+    const size_t count = before.size();
+    ASSERT_EQ( count, root->m_items.size() );
+
+    for ( size_t i = 2; i < count; ++i )
+    {
+        EXPECT_EQ( before[i], root->m_items[i - 2] );
+        EXPECT_EQ( "Child " + std::to_string( i ), root->m_items[i - 2]->m_name.value() );
+    }
+    EXPECT_EQ( before[1], root->m_items[count - 2] );
+    EXPECT_EQ( "Renamed", root->m_items[count - 2]->m_name.value() );
+    EXPECT_EQ( "Added", root->m_items[count - 1]->m_name.value() );
+
+    // Children are reconciled all the way down
+    EXPECT_EQ( before[1]->m_items[0], root->m_items[count - 2]->m_items[0] );
+}
+
+} // namespace
+
+TEST( ReconcileRead, UpdatesMatchingChildrenInPlace )
+{
+    for ( size_t threshold : { 0u, 1u } )
+    {
+        auto root   = createReconcileTree( 20u );
+        auto before = root->m_items.objects();
+
+        caffa::JsonSerializer serializer;
+        serializer.setReconcileChildren( true ).setParallelReadThreshold( threshold );
+        EXPECT_TRUE( serializer.reconcileChildren() );
+
+        const auto jsonRoot = createRefresh( serializer, root.get() );
+        serializer.readObjectFromJson( root.get(), jsonRoot );
+        expectReconciled( before, root.get() );
+
+        // Reading the same state again keeps every child and leaves the array itself unmodified
+        auto       after   = root->m_items.objects();
+        const auto version = root->m_items.lastModifiedVersion();
+        serializer.readObjectFromJson( root.get(), jsonRoot );
+        EXPECT_EQ( after, root->m_items.objects() );
+        EXPECT_EQ( version, root->m_items.lastModifiedVersion() );
+    }
+}
+
+TEST( ReconcileRead, LeavesChildrenBeforeTheFirstDifference )
+{
+    auto root   = createReconcileTree( 5u );
+    auto before = root->m_items.objects();
+
+    caffa::JsonSerializer serializer;
+    serializer.setReconcileChildren( true );
+
+    caffa::json::object jsonRoot;
+    serializer.writeObjectToJson( root.get(), jsonRoot );
+    auto& jsonItems = jsonRoot["Items"].as_array();
+    jsonItems.erase( jsonItems.begin() + 3 );
+
+    const auto addedVersion = before[0]->addedVersion();
+    serializer.readObjectFromJson( root.get(), jsonRoot );
+    ASSERT_EQ( 4u, root->m_items.size() );
+    EXPECT_EQ( before[0], root->m_items[0] );
+    EXPECT_EQ( addedVersion, root->m_items[0]->addedVersion() );
+
+    // The children after the removed one are added again
+    EXPECT_EQ( before[4], root->m_items[3] );
+    EXPECT_GT( root->m_items[3]->addedVersion(), addedVersion );
+}
+
+TEST( ReconcileRead, ReadsStringsIntoExistingChildren )
+{
+    auto root   = createReconcileTree( 20u );
+    auto before = root->m_items.objects();
+
+    caffa::JsonSerializer serializer;
+    serializer.setReconcileChildren( true );
+
+    const auto string = caffa::json::dump( createRefresh( serializer, root.get() ) );
+    serializer.readObjectFromString( root.get(), string );
+    expectReconciled( before, root.get() );
+    EXPECT_EQ( string, serializer.writeObjectToString( root.get() ) );
+}
+
+TEST( ReconcileRead, ReplacesChildrenByDefault )
+{
+    auto root   = createReconcileTree( 5u );
+    auto before = root->m_items.objects();
+
+    caffa::JsonSerializer serializer;
+    EXPECT_FALSE( serializer.reconcileChildren() );
+
+    caffa::json::object jsonRoot;
+    serializer.writeObjectToJson( root.get(), jsonRoot );
+    serializer.readObjectFromJson( root.get(), jsonRoot );
+
+    ASSERT_EQ( 5u, root->m_items.size() );
+    EXPECT_NE( before[0], root->m_items[0] );
+    EXPECT_EQ( before[0]->uuid(), root->m_items[0]->uuid() );
+
+    // Entries without a uuid always get new children
+    caffa::JsonSerializer withoutUuids;
+    withoutUuids.setSerializeUuids( false );
+    caffa::json::object jsonWithoutUuids;
+    withoutUuids.writeObjectToJson( root.get(), jsonWithoutUuids );
+
+    before = root->m_items.objects();
+    serializer.setReconcileChildren( true );
+    serializer.readObjectFromJson( root.get(), jsonWithoutUuids );
+    ASSERT_EQ( 5u, root->m_items.size() );
+    EXPECT_NE( before[0], root->m_items[0] );
+}
@@ -0,0 +1,385 @@
+#include "gtest/gtest.h"
+
+#include "cafChildArrayField.h"
+#include "cafChildField.h"
+#include "cafField.h"
+#include "cafFieldIoCapabilitySpecializations.h"
+#include "cafIoTestChildren.h"
+#include "cafJsonSerializer.h"
+#include "cafJsonStreamReader.h"
+#include "cafJsonStreamWriter.h"
+#include "cafObject.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class StreamChild : public caffa::Object
+{
+    CAFFA_HEADER_INIT( StreamChild, Object )
+
+public:
+    StreamChild()
+    {
+        initField( m_name, "Name" );
+        initField( m_values, "Values" );
+    }
+
+    caffa::Field<std::string>         m_name;
+    caffa::Field<std::vector<double>> m_values;
+};
+CAFFA_SOURCE_INIT( StreamChild )
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+class StreamParent : public caffa::Object
+{
+    CAFFA_HEADER_INIT( StreamParent, Object )
+
+public:
+    StreamParent()
+    {
+        initField( m_count, "Count" ).withDefault( 0 );
+        initField( m_single, "Single" );
+        initField( m_children, "Children" );
+    }
+
+    caffa::Field<int>                    m_count;
+    caffa::ChildField<StreamChild*>      m_single;
+    caffa::ChildArrayField<StreamChild*> m_children;
+};
+CAFFA_SOURCE_INIT( StreamParent )
+
+namespace
+{
+//--------------------------------------------------------------------------------------------------
+/// Documents with a couple of thousand children are larger than a read chunk
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<StreamParent> createStreamParent( size_t childCount = 3u )
+{
+    auto parent = std::make_shared<StreamParent>();
+    parent->m_count.setValue( static_cast<int>( childCount ) );
+
+    auto single = std::make_shared<StreamChild>();
+    single->m_name.setValue( "Single \"quoted\" child" );
+    single->m_values.setValue( { 1.5, -2.25 } );
+    parent->m_single = single;
+
+    appendTestChildren( parent->m_children, childCount, "Child ", 32u );
+    return parent;
+}
+
+std::string writeThroughDocument( const caffa::JsonSerializer& serializer, const caffa::ObjectHandle* object )
+{
+    caffa::json::object jsonObject;
+    serializer.writeObjectToJson( object, jsonObject );
+    return caffa::json::dump( jsonObject );
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+/// The streamed output has to be byte for byte what the document based writer produces
+//--------------------------------------------------------------------------------------------------
+TEST( StreamWriter, MatchesDocumentOutput )
+{
+    auto parent = createStreamParent();
+
+    caffa::JsonSerializer serializer;
+    std::string           streamed = serializer.writeObjectToString( parent.get() );
+    ASSERT_EQ( writeThroughDocument( serializer, parent.get() ), streamed );
+
+    std::stringstream stream;
+    serializer.writeStream( parent.get(), stream );
+    ASSERT_EQ( streamed, stream.str() );
+
+    serializer.setSerializationType( caffa::JsonSerializer::SerializationType::DATA_SKELETON );
+    std::string skeleton = serializer.writeObjectToString( parent.get() );
+    ASSERT_EQ( writeThroughDocument( serializer, parent.get() ), skeleton );
+    ASSERT_EQ( std::string::npos, skeleton.find( "Child 0" ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( StreamWriter, PrettyOutputParsesToSameDocument )
+{
+    auto parent = createStreamParent();
+
+    caffa::JsonSerializer serializer;
+    std::string           compact = serializer.writeObjectToString( parent.get() );
+    std::string           pretty  = serializer.writeObjectToString( parent.get(), true );
+
+    ASSERT_NE( compact, pretty );
+    ASSERT_EQ( '\n', pretty.back() );
+    ASSERT_EQ( caffa::json::parse( compact ), caffa::json::parse( pretty ) );
+
+    auto copy = serializer.createObjectFromString( pretty );
+    ASSERT_TRUE( copy );
+    ASSERT_EQ( compact, serializer.writeObjectToString( copy.get() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Pretty printing keeps every double exact and escapes keys and strings like json::dump
+//--------------------------------------------------------------------------------------------------
+TEST( StreamWriter, PrettyPrintsExactValues )
+{
+    caffa::json::object document;
+    document["Sum"]         = 0.1 + 0.2;
+    document["Whole"]       = 3.0;
+    document["Tiny"]        = 5e-324;
+    document["Huge"]        = -1.7976931348623157e308;
+    document["Integers"]    = caffa::json::array{ -9223372036854775807ll - 1, 18446744073709551615ull, 0 };
+    document["Say \"hi\""]  = "Tab\tquote\"back\\slash\x01\x1f end";
+    document["Nested"]      = caffa::json::object{ { "Flags", caffa::json::array{ true, false, nullptr } } };
+    document["Empty"]       = caffa::json::object{};
+    document["Empty array"] = caffa::json::array{};
+
+    std::string pretty;
+    {
+        caffa::JsonStreamWriter writer( pretty, true );
+        writer.value( document );
+    }
+    ASSERT_EQ( '\n', pretty.back() );
+    ASSERT_NE( std::string::npos, pretty.find( "\"Sum\" : 0.30000000000000004" ) );
+    ASSERT_NE( std::string::npos, pretty.find( "\"Whole\" : 3.0" ) );
+    ASSERT_NE( std::string::npos, pretty.find( R"("Say \"hi\"" : "Tab\tquote\"back\\slash\u0001\u001f end")" ) );
+
+    const auto parsed = caffa::json::parse( pretty );
+    ASSERT_EQ( caffa::json::value( document ), parsed );
+    ASSERT_EQ( 0.1 + 0.2, parsed.as_object().at( "Sum" ).as_double() );
+    ASSERT_TRUE( parsed.as_object().at( "Whole" ).is_double() );
+
+    std::stringstream stream;
+    caffa::JsonSerializer().prettyPrint( stream, document );
+    ASSERT_EQ( pretty, stream.str() );
+
+    std::string compact;
+    {
+        caffa::JsonStreamWriter writer( compact );
+        writer.value( document );
+    }
+    ASSERT_EQ( caffa::json::dump( document ), compact );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Values printed with an indentation continue the indentation of the line they start on
+//--------------------------------------------------------------------------------------------------
+TEST( StreamWriter, PrettyPrintsWithIndentation )
+{
+    const auto            value = caffa::json::parse( R"({"List": [1, 2], "Text": "Line\nbreak", "Empty": {}})" );
+    caffa::JsonSerializer serializer;
+
+    std::stringstream expected;
+    serializer.prettyPrint( expected, value );
+
+    std::stringstream withoutIndentation;
+    serializer.prettyPrint( withoutIndentation, value, nullptr );
+    ASSERT_EQ( expected.str(), withoutIndentation.str() );
+
+    std::string       indent = "    ";
+    std::stringstream nested;
+    serializer.prettyPrint( nested, value, &indent );
+    ASSERT_EQ( "    ", indent );
+
+    const auto text = nested.str();
+    ASSERT_NE( '\n', text.back() );
+    ASSERT_EQ( value, caffa::json::parse( text ) );
+
+    std::istringstream expectedLines( expected.str() );
+    std::istringstream nestedLines( text );
+    std::string        expectedLine;
+    std::string        nestedLine;
+    for ( bool first = true; std::getline( expectedLines, expectedLine ); first = false )
+    {
+        ASSERT_TRUE( std::getline( nestedLines, nestedLine ) );
+        ASSERT_EQ( first ? expectedLine : indent + expectedLine, nestedLine );
+    }
+    ASSERT_FALSE( std::getline( nestedLines, nestedLine ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// A small buffer forces several flushes while writing
+//--------------------------------------------------------------------------------------------------
+TEST( StreamWriter, SmallBufferFlushes )
+{
+    auto parent = createStreamParent();
+
+    caffa::JsonSerializer serializer;
+
+    std::stringstream stream;
+    {
+        caffa::JsonStreamWriter writer( stream, false, 8u );
+        serializer.writeObjectToStream( parent.get(), writer );
+    }
+    ASSERT_EQ( serializer.writeObjectToString( parent.get() ), stream.str() );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Feeding the reader one byte at a time splits every key, string and number across chunks
+//--------------------------------------------------------------------------------------------------
+TEST( StreamReader, ReadsSingleByteChunks )
+{
+    auto parent = createStreamParent();
+
+    caffa::JsonSerializer serializer;
+    std::string           text = serializer.writeObjectToString( parent.get() );
+
+    caffa::JsonStreamReader reader( serializer );
+    for ( char c : text )
+    {
+        reader.write( std::string_view( &c, 1u ) );
+    }
+    reader.finish();
+    ASSERT_EQ( text.size(), reader.bytesConsumed() );
+
+    auto copy = std::dynamic_pointer_cast<StreamParent>( reader.createdObject() );
+    ASSERT_TRUE( copy );
+    ASSERT_EQ( 3, copy->m_count.value() );
+    ASSERT_EQ( 3u, copy->m_children.size() );
+    ASSERT_EQ( "Single \"quoted\" child", copy->m_single->m_name.value() );
+    ASSERT_EQ( text, serializer.writeObjectToString( copy.get() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Fields ahead of the class keyword and child objects wrapped in a value entry are still read
+//--------------------------------------------------------------------------------------------------
+TEST( StreamReader, ReadsUnorderedAndWrappedObjects )
+{
+    std::string text = "{\"Count\": 7, \"keyword\": \"StreamParent\", "
+                       "\"Single\": {\"value\": {\"keyword\": \"StreamChild\", \"Name\": \"Wrapped\"}}, "
+                       "\"Children\": [{\"Values\": [1.0, 2.0], \"keyword\": \"StreamChild\"}, 42, null]}";
+
+    auto object = caffa::JsonSerializer().createObjectFromString( text );
+    auto parent = std::dynamic_pointer_cast<StreamParent>( object );
+    ASSERT_TRUE( parent );
+    ASSERT_EQ( 7, parent->m_count.value() );
+    ASSERT_TRUE( parent->m_single.object() );
+    ASSERT_EQ( "Wrapped", parent->m_single->m_name.value() );
+    ASSERT_EQ( 1u, parent->m_children.size() );
+    ASSERT_EQ( std::vector<double>( { 1.0, 2.0 } ), parent->m_children[0]->m_values.value() );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// A child object with a matching uuid is read into rather than replaced
+//--------------------------------------------------------------------------------------------------
+TEST( StreamReader, ReusesChildWithMatchingUuid )
+{
+    auto parent = createStreamParent();
+    auto single = parent->m_single.object();
+
+    single->m_name.setValue( "Changed" );
+    std::string text = caffa::JsonSerializer().writeObjectToString( parent.get() );
+    single->m_name.setValue( "Original" );
+
+    caffa::JsonSerializer().readObjectFromString( parent.get(), text );
+    ASSERT_EQ( single, parent->m_single.object() );
+    ASSERT_EQ( "Changed", single->m_name.value() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST( StreamReader, RejectsInvalidInput )
+{
+    StreamParent parent;
+
+    ASSERT_THROW( caffa::JsonSerializer().readObjectFromString( &parent, "{\"keyword\": \"StreamParent\", \"Nope\": 1}" ),
+                  std::runtime_error );
+    ASSERT_THROW( caffa::JsonSerializer().readObjectFromString( &parent, "{\"keyword\": \"StreamParent\", \"Count\": " ),
+                  std::runtime_error );
+    ASSERT_THROW( caffa::JsonSerializer().readObjectFromString( &parent, "{\"keyword\": \"StreamParent\"} {}" ),
+                  std::runtime_error );
+    ASSERT_FALSE( caffa::JsonSerializer().createObjectFromString( "null" ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Documents larger than a chunk are read in several passes, reporting progress after each
+//--------------------------------------------------------------------------------------------------
+TEST( StreamReader, ReadStreamReportsProgress )
+{
+    auto parent = createStreamParent( 2000u );
+
+    caffa::JsonSerializer serializer;
+    std::stringstream     stream;
+    serializer.writeStream( parent.get(), stream );
+
+    const size_t totalSize = stream.str().size();
+    ASSERT_GT( totalSize, caffa::JsonSerializer::READ_CHUNK_SIZE );
+
+    std::vector<size_t> progress;
+    StreamParent        copy;
+    serializer.readStream( &copy, stream, [&progress]( size_t bytesConsumed ) { progress.push_back( bytesConsumed ); } );
+
+    ASSERT_GT( progress.size(), 1u );
+    ASSERT_TRUE( std::is_sorted( progress.begin(), progress.end() ) );
+    ASSERT_EQ( totalSize, progress.back() );
+    ASSERT_EQ( parent->m_children.size(), copy.m_children.size() );
+    ASSERT_EQ( serializer.writeObjectToString( parent.get() ), serializer.writeObjectToString( &copy ) );
+}
+
+TEST( StreamReader, ReadFileMatchesReadStream )
+{
+    auto parent = createStreamParent( 2000u );
+
+    caffa::JsonSerializer serializer;
+    const auto            path = std::filesystem::temp_directory_path() / "caffaReadFileTest.json";
+    {
+        std::ofstream file( path, std::ios::binary );
+        serializer.writeStream( parent.get(), file );
+    }
+
+    std::vector<size_t> progress;
+    StreamParent        copy;
+    serializer.readFile( &copy, path, [&progress]( size_t bytesConsumed ) { progress.push_back( bytesConsumed ); } );
+
+    ASSERT_GT( progress.size(), 1u );
+    ASSERT_EQ( std::filesystem::file_size( path ), progress.back() );
+    ASSERT_EQ( serializer.writeObjectToString( parent.get() ), serializer.writeObjectToString( &copy ) );
+
+    std::filesystem::remove( path );
+    EXPECT_THROW( serializer.readFile( &copy, path ), std::runtime_error );
+}
+
+TEST( StreamReader, CompressedStreamsRoundTrip )
+{
+    auto parent = createStreamParent( 2000u );
+
+    caffa::JsonSerializer serializer;
+    const auto            expected = serializer.writeObjectToString( parent.get() );
+
+    for ( auto compression : { caffa::Compression::NONE, caffa::Compression::GZIP, caffa::Compression::ZSTD } )
+    {
+        std::stringstream stream;
+        if ( !caffa::isCompressionSupported( compression ) )
+        {
+            EXPECT_THROW( serializer.writeCompressedStream( parent.get(), stream, compression ), std::runtime_error );
+            continue;
+        }
+
+        serializer.writeCompressedStream( parent.get(), stream, compression, 1 );
+        const auto compressed = stream.str();
+        EXPECT_EQ( compression, caffa::detectCompression( compressed ) );
+        if ( compression != caffa::Compression::NONE )
+        {
+            EXPECT_LT( compressed.size(), expected.size() / 4u );
+        }
+
+        StreamParent copy;
+        serializer.readCompressedStream( &copy, stream );
+        EXPECT_EQ( expected, serializer.writeObjectToString( &copy ) );
+
+        if ( compression != caffa::Compression::NONE )
+        {
+            std::stringstream truncated( compressed.substr( 0u, compressed.size() / 2u ) );
+            StreamParent      partialCopy;
+            EXPECT_THROW( serializer.readCompressedStream( &partialCopy, truncated ), std::runtime_error );
+        }
+    }
+}
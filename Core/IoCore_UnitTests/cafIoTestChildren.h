@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cafChildArrayField.h"
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+/// Append childCount children with a string field m_name. Child i is named namePrefix followed by i
+/// and is handed to setUp( child, i ) to fill in any other fields before it is appended.
+//--------------------------------------------------------------------------------------------------
+template <typename ChildType, std::invocable<ChildType&, size_t> SetUp>
+void appendTestChildren( caffa::ChildArrayField<ChildType*>& field,
+                         size_t                               childCount,
+                         const std::string&                   namePrefix,
+                         SetUp                                setUp )
+{
+    for ( size_t i = 0; i < childCount; ++i )
+    {
+        auto child = std::make_shared<ChildType>();
+        child->m_name.setValue( namePrefix + std::to_string( i ) );
+        setUp( *child, i );
+        field.push_back( child );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Append childCount children named namePrefix followed by their index. If the children have a double
+/// vector field m_values, child i holds i % valueCycle copies of 0.5 * i, so the children vary in size
+/// and some of them have empty arrays.
+//--------------------------------------------------------------------------------------------------
+template <typename ChildType>
+void appendTestChildren( caffa::ChildArrayField<ChildType*>& field,
+                         size_t                               childCount,
+                         const std::string&                   namePrefix,
+                         size_t                               valueCycle = 7u )
+{
+    if constexpr ( requires( ChildType& child ) { child.m_values.setValue( std::vector<double>() ); } )
+    {
+        appendTestChildren( field,
+                            childCount,
+                            namePrefix,
+                            [valueCycle]( ChildType& child, size_t i )
+                            { child.m_values.setValue( std::vector<double>( i % valueCycle, 0.5 * i ) ); } );
+    }
+    else
+    {
+        appendTestChildren( field, childCount, namePrefix, []( ChildType&, size_t ) {} );
+    }
+}
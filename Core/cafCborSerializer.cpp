@@ -0,0 +1,523 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafCborSerializer.h"
+
+#include "cafAssert.h"
+#include "cafCborStream.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafChildFieldHandle.h"
+#include "cafFieldHandle.h"
+#include "cafFieldIoCapability.h"
+#include "cafLogger.h"
+#include "cafObjectFactory.h"
+#include "cafSerializationPlan.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace caffa;
+
+namespace
+{
+//==================================================================================================
+/// Walks the object hierarchy, converting between objects and CBOR
+//==================================================================================================
+class CborObjectIo
+{
+public:
+    explicit CborObjectIo( const JsonSerializer& jsonSerializer )
+        : m_jsonSerializer( jsonSerializer )
+        , m_fieldSelector( jsonSerializer.fieldSelector() )
+        , m_serializeUuids( jsonSerializer.serializeUuids() )
+    {
+    }
+
+    void writeObject( CborWriter& writer, const ObjectHandle* object ) const
+    {
+        struct Member
+        {
+            const SerializationPlan::Entry* entry;
+            FieldHandle*                    field;
+            const FieldIoCapability*        ioCapability;
+        };
+
+        // The map header holds the number of entries, so the fields to write are found first
+        std::optional<SerializationPlan> ownPlan;
+        std::vector<Member>              members;
+        for ( const auto& entry : SerializationPlan::forObject( object, ownPlan ).entries() )
+        {
+            auto field = SerializationPlan::field( object, entry );
+            if ( m_fieldSelector && !m_fieldSelector( field ) ) continue;
+
+            if ( entry.deprecated ) continue;
+
+            const FieldIoCapability* ioCapability = SerializationPlan::ioCapability( field, entry );
+            if ( !ioCapability || !field->isReadable() || ioCapability->writesNull( m_jsonSerializer ) ) continue;
+
+            members.push_back( { &entry, field, ioCapability } );
+        }
+
+        const bool writeUuid = m_serializeUuids && !object->uuid().empty();
+        writer.head( Cbor::MAP, members.size() + ( writeUuid ? 2u : 1u ) );
+        writer.text( "keyword" );
+        writer.text( object->classKeyword() );
+        if ( writeUuid )
+        {
+            writer.text( "uuid" );
+            writer.text( object->uuid() );
+        }
+
+        for ( const auto& [entry, field, ioCapability] : members )
+        {
+            writer.text( entry->keyword );
+            switch ( entry->kind )
+            {
+                case SerializationPlan::FieldKind::CHILD_ARRAY:
+                {
+                    auto children = static_cast<const ChildArrayFieldHandle*>( field )->childObjects();
+                    std::erase( children, nullptr );
+
+                    writer.head( Cbor::ARRAY, children.size() );
+                    for ( const auto& child : children )
+                    {
+                        writeObject( writer, child.get() );
+                    }
+                    break;
+                }
+                case SerializationPlan::FieldKind::CHILD:
+                    writeObject( writer, static_cast<const ChildFieldHandle*>( field )->childObjects().front().get() );
+                    break;
+                case SerializationPlan::FieldKind::DATA:
+                    ioCapability->writeToCbor( writer, m_jsonSerializer );
+                    break;
+            }
+        }
+    }
+
+    void readObject( CborReader& reader, ObjectHandle* object ) const
+    {
+        CborReader::DepthGuard           guard( reader );
+        std::optional<SerializationPlan> ownPlan;
+        const auto&                      plan = SerializationPlan::forObject( object, ownPlan );
+
+        auto remaining = reader.readContainer( Cbor::MAP );
+        readMembers( reader, remaining, object, plan );
+    }
+
+    /**
+     * Create the object described by the map at the reader position
+     * @return the object or nullptr if the class is unknown, in which case the map has been skipped
+     */
+    std::shared_ptr<ObjectHandle> createObject( CborReader& reader ) const
+    {
+        auto remaining = reader.readContainer( Cbor::MAP );
+        auto header    = readHeader( reader, remaining );
+
+        std::shared_ptr<ObjectHandle> object;
+        if ( !header.classKeyword.empty() )
+        {
+            object = m_jsonSerializer.objectFactory()->create( header.classKeyword );
+        }
+        if ( !object )
+        {
+            skipBody( reader, remaining, header );
+            return nullptr;
+        }
+
+        readBody( reader, remaining, header, object.get() );
+        return object;
+    }
+
+private:
+    /**
+     * The entries of an object map up to the first field after the class keyword, which is what it takes to create
+     * the object. The class keyword and uuid normally come first, but any fields ahead of them are kept encoded until
+     * there is an object to read them into.
+     */
+    struct Header
+    {
+        std::string                classKeyword;
+        std::string                uuid;
+        CborWriter::Bytes          pendingFields;
+        size_t                     pendingCount = 0u;
+        std::optional<std::string> nextKeyword;
+    };
+
+    Header readHeader( CborReader& reader, std::optional<std::uint64_t>& remaining ) const
+    {
+        Header     header;
+        CborWriter pendingWriter( header.pendingFields );
+        while ( reader.hasNext( remaining ) )
+        {
+            auto keyword = reader.readText();
+            if ( keyword == "keyword" || keyword == "class" )
+            {
+                header.classKeyword = reader.readText();
+            }
+            else if ( keyword == "uuid" )
+            {
+                header.uuid = reader.readText();
+            }
+            else if ( header.classKeyword.empty() )
+            {
+                pendingWriter.text( keyword );
+                const auto encoded = reader.readEncodedValue();
+                header.pendingFields.insert( header.pendingFields.end(), encoded.begin(), encoded.end() );
+                header.pendingCount++;
+            }
+            else
+            {
+                header.nextKeyword = std::move( keyword );
+                break;
+            }
+        }
+        return header;
+    }
+
+    /**
+     * Read the rest of an object map after readHeader into the object created from the header
+     */
+    void readBody( CborReader&                   reader,
+                   std::optional<std::uint64_t>& remaining,
+                   const Header&                 header,
+                   ObjectHandle*                 object ) const
+    {
+        CborReader::DepthGuard           guard( reader );
+        std::optional<SerializationPlan> ownPlan;
+        const auto&                      plan = SerializationPlan::forObject( object, ownPlan );
+
+        if ( m_serializeUuids && !header.uuid.empty() )
+        {
+            object->setUuid( header.uuid );
+        }
+
+        CborReader pendingReader( header.pendingFields );
+        for ( size_t i = 0u; i < header.pendingCount; ++i )
+        {
+            auto keyword = pendingReader.readText();
+            readField( pendingReader, object, plan, keyword );
+        }
+
+        if ( header.nextKeyword )
+        {
+            readField( reader, object, plan, *header.nextKeyword );
+        }
+        readMembers( reader, remaining, object, plan );
+    }
+
+    void skipBody( CborReader& reader, std::optional<std::uint64_t>& remaining, const Header& header ) const
+    {
+        if ( header.nextKeyword )
+        {
+            reader.skipValue();
+        }
+        while ( reader.hasNext( remaining ) )
+        {
+            reader.skipValue();
+            reader.skipValue();
+        }
+    }
+
+    void readMembers( CborReader&                   reader,
+                      std::optional<std::uint64_t>& remaining,
+                      ObjectHandle*                 object,
+                      const SerializationPlan&      plan ) const
+    {
+        while ( reader.hasNext( remaining ) )
+        {
+            auto keyword = reader.readText();
+            if ( keyword == "keyword" || keyword == "class" )
+            {
+                auto classKeyword = reader.readText();
+                CAFFA_ASSERT( ObjectHandle::matchesClassKeyword( classKeyword, object->classInheritanceStack() ) );
+            }
+            else if ( keyword == "uuid" )
+            {
+                auto uuid = reader.readText();
+                if ( m_serializeUuids ) object->setUuid( uuid );
+            }
+            else
+            {
+                readField( reader, object, plan, keyword );
+            }
+        }
+    }
+
+    void readField( CborReader&              reader,
+                    ObjectHandle*            object,
+                    const SerializationPlan& plan,
+                    const std::string&       keyword ) const
+    {
+        if ( keyword == "$id" || keyword == "methods" || reader.peekNull() )
+        {
+            reader.skipValue();
+            return;
+        }
+
+        const auto*        entry        = plan.findEntry( keyword );
+        FieldHandle*       field        = entry ? SerializationPlan::field( object, *entry ) : nullptr;
+        FieldIoCapability* ioCapability = entry ? SerializationPlan::ioCapability( field, *entry ) : nullptr;
+        if ( !ioCapability || !field->isWritable() )
+        {
+            throw std::runtime_error( "Invalid field " + keyword + " in " + std::string( object->classKeyword() ) );
+        }
+
+        if ( m_fieldSelector && !m_fieldSelector( field ) )
+        {
+            reader.skipValue();
+        }
+        else if ( entry->kind == SerializationPlan::FieldKind::CHILD_ARRAY && reader.peekMajorType() == Cbor::ARRAY )
+        {
+            readChildArray( reader, static_cast<ChildArrayFieldHandle*>( field ) );
+        }
+        else if ( entry->kind == SerializationPlan::FieldKind::CHILD && reader.peekMajorType() == Cbor::MAP )
+        {
+            readChild( reader, static_cast<ChildFieldHandle*>( field ) );
+        }
+        else
+        {
+            ioCapability->readFromCbor( reader, m_jsonSerializer );
+        }
+    }
+
+    void readChild( CborReader& reader, ChildFieldHandle* field ) const
+    {
+        auto remaining = reader.readContainer( Cbor::MAP );
+        auto header    = readHeader( reader, remaining );
+        if ( header.classKeyword.empty() )
+        {
+            throw std::runtime_error( "Invalid CBOR. Could not find keyword tag" );
+        }
+
+        std::shared_ptr<ObjectHandle> object;
+        if ( auto existing = field->childObjects();
+             !existing.empty() && !header.uuid.empty() && existing.front()->uuid() == header.uuid )
+        {
+            CAFFA_TRACE( "Had existing matching object! Overwriting field values!" );
+            object = existing.front();
+        }
+        else if ( object = m_jsonSerializer.objectFactory()->create( header.classKeyword ); object )
+        {
+            field->setChildObject( object );
+            if ( auto children = field->childObjects(); children.empty() || children.front() != object )
+            {
+                object.reset();
+            }
+        }
+
+        if ( !object || !ObjectHandle::matchesClassKeyword( header.classKeyword, object->classInheritanceStack() ) )
+        {
+            CAFFA_ERROR( "Unknown object type with class name: " << header.classKeyword
+                                                                 << " found while reading the field : "
+                                                                 << field->keyword() );
+            skipBody( reader, remaining, header );
+            return;
+        }
+
+        readBody( reader, remaining, header, object.get() );
+    }
+
+    void readChildArray( CborReader& reader, ChildArrayFieldHandle* field ) const
+    {
+        CborReader::DepthGuard guard( reader );
+        field->clear();
+
+        auto remaining = reader.readContainer( Cbor::ARRAY );
+        while ( reader.hasNext( remaining ) )
+        {
+            if ( reader.peekMajorType() != Cbor::MAP )
+            {
+                reader.skipValue();
+                continue;
+            }
+
+            auto childRemaining = reader.readContainer( Cbor::MAP );
+            auto header         = readHeader( reader, childRemaining );
+            if ( header.classKeyword.empty() )
+            {
+                throw std::runtime_error( "Invalid CBOR. Could not find keyword tag" );
+            }
+
+            auto object = m_jsonSerializer.objectFactory()->create( header.classKeyword );
+            if ( !object )
+            {
+                CAFFA_ERROR( "Warning: Unknown object type with class name: "
+                             << header.classKeyword << " found while reading the field : " << field->keyword() );
+                skipBody( reader, childRemaining, header );
+                continue;
+            }
+
+            readBody( reader, childRemaining, header, object.get() );
+            field->insertAt( field->size(), object );
+        }
+    }
+
+    const JsonSerializer&         m_jsonSerializer;
+    JsonSerializer::FieldSelector m_fieldSelector;
+    bool                          m_serializeUuids;
+};
+
+} // namespace
+
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer::CborSerializer( ObjectFactory* objectFactory /* = nullptr */ )
+    : m_jsonSerializer( objectFactory )
+{
+    m_jsonSerializer.setSerializationType( JsonSerializer::SerializationType::DATA_FULL );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer& CborSerializer::setFieldSelector( FieldSelector fieldSelector )
+{
+    m_jsonSerializer.setFieldSelector( std::move( fieldSelector ) );
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer& CborSerializer::setSerializeUuids( bool serializeUuids )
+{
+    m_jsonSerializer.setSerializeUuids( serializeUuids );
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ObjectFactory* CborSerializer::objectFactory() const
+{
+    return m_jsonSerializer.objectFactory();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer::FieldSelector CborSerializer::fieldSelector() const
+{
+    return m_jsonSerializer.fieldSelector();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborSerializer::serializeUuids() const
+{
+    return m_jsonSerializer.serializeUuids();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer::Bytes CborSerializer::writeObjectToBytes( const ObjectHandle* object ) const
+{
+    Bytes      bytes;
+    CborWriter writer( bytes );
+    if ( object )
+    {
+        CborObjectIo( m_jsonSerializer ).writeObject( writer, object );
+    }
+    else
+    {
+        writer.null();
+    }
+    return bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborSerializer::readObjectFromBytes( ObjectHandle* object, std::span<const std::uint8_t> bytes ) const
+{
+    CAFFA_ASSERT( object );
+
+    CborReader reader( bytes );
+    CborObjectIo( m_jsonSerializer ).readObject( reader, object );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> CborSerializer::createObjectFromBytes( std::span<const std::uint8_t> bytes ) const
+{
+    if ( bytes.empty() ) return nullptr;
+
+    CborReader reader( bytes );
+    if ( reader.peekNull() ) return nullptr;
+
+    return CborObjectIo( m_jsonSerializer ).createObject( reader );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> CborSerializer::copyBySerialization( const ObjectHandle* object ) const
+{
+    return createObjectFromBytes( writeObjectToBytes( object ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborSerializer::readStream( ObjectHandle* object, std::istream& stream ) const
+{
+    CAFFA_ASSERT( object );
+
+    CborReader reader( stream, JsonSerializer::READ_CHUNK_SIZE );
+    CborObjectIo( m_jsonSerializer ).readObject( reader, object );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborSerializer::writeStream( const ObjectHandle* object, std::ostream& stream ) const
+{
+    auto bytes = writeObjectToBytes( object );
+    stream.write( reinterpret_cast<const char*>( bytes.data() ), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborSerializer::Bytes CborSerializer::encode( const json::value& value )
+{
+    Bytes bytes;
+    CborWriter( bytes ).value( value );
+    return bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value CborSerializer::decode( std::span<const std::uint8_t> bytes )
+{
+    CborReader reader( bytes );
+    auto       value = reader.readValue();
+    if ( !reader.atEnd() )
+    {
+        throw std::runtime_error( "Invalid CBOR: Unexpected data after the first data item" );
+    }
+    return value;
+}
@@ -0,0 +1,153 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+#include "cafJsonSerializer.h"
+#include "cafObjectHandle.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace caffa
+{
+class ObjectFactory;
+
+/**
+ * Binary serializer writing object data as CBOR (RFC 8949).
+ *
+ * The layout mirrors the JSON data layout, so every object is a map holding "keyword", "uuid" and the fields.
+ * Numbers are stored in binary form. Arrays of numbers are stored as RFC 8746 typed arrays, using the narrowest
+ * element type that holds every value exactly, and vectors of bytes are stored as byte strings (see cafCborStream.h).
+ *
+ * Only data is handled. Fields of booleans, numbers, strings and vectors of these are encoded and decoded directly
+ * by their IO capabilities. Other fields are converted through their JSON representation, so any field which can be
+ * written to JSON can be written to CBOR.
+ *
+ * Data nested deeper than CborReader::MAX_DEPTH, counting objects, child arrays and nested values, is rejected.
+ */
+class CborSerializer
+{
+public:
+    using FieldSelector = JsonSerializer::FieldSelector;
+    using Bytes         = std::vector<std::uint8_t>;
+
+    /**
+     * Constructor
+     * @param objectFactory The factory used when creating new objects. Not relevant when writing.
+     */
+    explicit CborSerializer( ObjectFactory* objectFactory = nullptr );
+
+    /**
+     * Clone the object by serializing to and from CBOR
+     *
+     * @param object The object to copy
+     * @return shared ptr containing a new copy
+     */
+    template <DerivesFromObjectHandle ObjectType>
+    std::shared_ptr<ObjectType> cloneObject( const ObjectType* object ) const
+    {
+        return std::dynamic_pointer_cast<ObjectType>( copyBySerialization( object ) );
+    }
+
+    /**
+     * Set Field Selector
+     * @param fieldSelector
+     * @return reference to this
+     */
+    CborSerializer& setFieldSelector( FieldSelector fieldSelector );
+
+    /**
+     * Set whether to serialize UUIDs
+     * @param serializeUuids
+     * @return reference to this
+     */
+    CborSerializer& setSerializeUuids( bool serializeUuids );
+
+    [[nodiscard]] ObjectFactory* objectFactory() const;
+    [[nodiscard]] FieldSelector  fieldSelector() const;
+    [[nodiscard]] bool           serializeUuids() const;
+
+    /**
+     * Write an object to a CBOR byte array
+     * @param object The object to write
+     * @return The CBOR encoded object
+     */
+    [[nodiscard]] Bytes writeObjectToBytes( const ObjectHandle* object ) const;
+
+    /**
+     * Read this particular object (with children) from CBOR. Throws std::runtime_error on invalid data.
+     * @param object ObjectHandle to read in to.
+     * @param bytes The CBOR encoded object
+     */
+    void readObjectFromBytes( ObjectHandle* object, std::span<const std::uint8_t> bytes ) const;
+
+    /**
+     * Create a new object from CBOR
+     * @param bytes The CBOR encoded object
+     * @return new object or nullptr if the class keyword is missing or unknown
+     */
+    [[nodiscard]] std::shared_ptr<ObjectHandle> createObjectFromBytes( std::span<const std::uint8_t> bytes ) const;
+
+    /**
+     * Copy the object by writing to CBOR and reading in again
+     * @param object The object to copy
+     * @return shared ptr containing a new copy
+     */
+    [[nodiscard]] std::shared_ptr<ObjectHandle> copyBySerialization( const ObjectHandle* object ) const;
+
+    /**
+     * Read object from a binary input stream. The stream is decoded as it is read, in chunks of
+     * JsonSerializer::READ_CHUNK_SIZE bytes, so it is never held in memory as a whole.
+     * @param object Pointer to object to read into
+     * @param stream The input stream
+     */
+    void readStream( ObjectHandle* object, std::istream& stream ) const;
+
+    /**
+     * Write object to a binary output stream
+     * @param object Pointer to object to write
+     * @param stream The output stream
+     */
+    void writeStream( const ObjectHandle* object, std::ostream& stream ) const;
+
+    /**
+     * Encode a JSON value as CBOR
+     * @param value The JSON value
+     * @return The CBOR encoded value
+     */
+    [[nodiscard]] static Bytes encode( const json::value& value );
+
+    /**
+     * Decode CBOR to a JSON value. Typed arrays become arrays of numbers and byte strings become base64 strings.
+     * Throws std::runtime_error on invalid data.
+     * @param bytes The CBOR encoded value
+     * @return The JSON value
+     */
+    [[nodiscard]] static json::value decode( std::span<const std::uint8_t> bytes );
+
+private:
+    JsonSerializer m_jsonSerializer;
+};
+
+} // namespace caffa
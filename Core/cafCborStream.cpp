@@ -0,0 +1,835 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafCborStream.h"
+
+#include "cafStringEncoding.h"
+
+#include <cmath>
+
+using namespace caffa;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborWriter::CborWriter( Bytes& output )
+    : m_output( output )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::head( std::uint8_t majorType, std::uint64_t argument )
+{
+    const std::uint8_t initial = static_cast<std::uint8_t>( majorType << 5 );
+    if ( argument < 24u )
+    {
+        m_output.push_back( initial | static_cast<std::uint8_t>( argument ) );
+    }
+    else if ( argument <= UINT8_MAX )
+    {
+        m_output.push_back( initial | 24u );
+        bigEndian( argument, 1u );
+    }
+    else if ( argument <= UINT16_MAX )
+    {
+        m_output.push_back( initial | 25u );
+        bigEndian( argument, 2u );
+    }
+    else if ( argument <= UINT32_MAX )
+    {
+        m_output.push_back( initial | 26u );
+        bigEndian( argument, 4u );
+    }
+    else
+    {
+        m_output.push_back( initial | 27u );
+        bigEndian( argument, 8u );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::null()
+{
+    m_output.push_back( Cbor::CBOR_NULL );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::boolean( bool value )
+{
+    m_output.push_back( value ? Cbor::CBOR_TRUE : Cbor::CBOR_FALSE );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::integer( std::int64_t value )
+{
+    if ( value >= 0 )
+    {
+        head( Cbor::UNSIGNED_INTEGER, static_cast<std::uint64_t>( value ) );
+    }
+    else
+    {
+        head( Cbor::NEGATIVE_INTEGER, static_cast<std::uint64_t>( -( value + 1 ) ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::unsignedInteger( std::uint64_t value )
+{
+    head( Cbor::UNSIGNED_INTEGER, value );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::text( std::string_view text )
+{
+    head( Cbor::TEXT_STRING, text.size() );
+    m_output.insert( m_output.end(), text.begin(), text.end() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::bytes( std::span<const std::uint8_t> bytes )
+{
+    head( Cbor::BYTE_STRING, bytes.size() );
+    m_output.insert( m_output.end(), bytes.begin(), bytes.end() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::floatingPoint( double value )
+{
+    if ( const auto single = static_cast<float>( value ); static_cast<double>( single ) == value )
+    {
+        m_output.push_back( Cbor::CBOR_FLOAT32 );
+        bigEndian( std::bit_cast<std::uint32_t>( single ), 4u );
+    }
+    else
+    {
+        m_output.push_back( Cbor::CBOR_FLOAT64 );
+        bigEndian( std::bit_cast<std::uint64_t>( value ), 8u );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::value( const json::value& value )
+{
+    switch ( value.kind() )
+    {
+        case boost::json::kind::null:
+            null();
+            break;
+        case boost::json::kind::bool_:
+            boolean( value.get_bool() );
+            break;
+        case boost::json::kind::int64:
+            integer( value.get_int64() );
+            break;
+        case boost::json::kind::uint64:
+            unsignedInteger( value.get_uint64() );
+            break;
+        case boost::json::kind::double_:
+            floatingPoint( value.get_double() );
+            break;
+        case boost::json::kind::string:
+        {
+            const auto& string = value.get_string();
+            text( std::string_view( string.data(), string.size() ) );
+            break;
+        }
+        case boost::json::kind::array:
+        {
+            const auto& array = value.get_array();
+            if ( !numberArray( array ) )
+            {
+                head( Cbor::ARRAY, array.size() );
+                for ( const auto& entry : array )
+                {
+                    this->value( entry );
+                }
+            }
+            break;
+        }
+        case boost::json::kind::object:
+        {
+            const auto& object = value.get_object();
+            head( Cbor::MAP, object.size() );
+            for ( const auto& [key, entry] : object )
+            {
+                text( std::string_view( key.data(), key.size() ) );
+                this->value( entry );
+            }
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write a JSON array of numbers as a typed array
+/// @return false if the array is not a homogeneous array of at least two numbers
+//--------------------------------------------------------------------------------------------------
+bool CborWriter::numberArray( const json::array& array )
+{
+    if ( array.size() < 2u ) return false;
+
+    if ( std::ranges::all_of( array, []( const json::value& entry ) { return entry.is_double(); } ) )
+    {
+        std::vector<double> values;
+        values.reserve( array.size() );
+        for ( const auto& entry : array )
+        {
+            values.push_back( entry.get_double() );
+        }
+        numbers<double>( values );
+        return true;
+    }
+
+    constexpr auto int64Max    = static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() );
+    bool           anyNegative = false, anyUnsigned = false;
+    for ( const auto& entry : array )
+    {
+        if ( const auto* i = entry.if_int64(); i )
+        {
+            anyNegative = anyNegative || *i < 0;
+        }
+        else if ( const auto* u = entry.if_uint64(); u )
+        {
+            anyUnsigned = anyUnsigned || *u > int64Max;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if ( anyNegative && anyUnsigned ) return false;
+
+    if ( anyUnsigned )
+    {
+        std::vector<std::uint64_t> values;
+        values.reserve( array.size() );
+        for ( const auto& entry : array )
+        {
+            values.push_back( entry.to_number<std::uint64_t>() );
+        }
+        numbers<std::uint64_t>( values );
+    }
+    else
+    {
+        std::vector<std::int64_t> values;
+        values.reserve( array.size() );
+        for ( const auto& entry : array )
+        {
+            values.push_back( entry.to_number<std::int64_t>() );
+        }
+        numbers<std::int64_t>( values );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborWriter::bigEndian( std::uint64_t value, size_t size )
+{
+    for ( size_t i = size; i-- > 0u; )
+    {
+        m_output.push_back( static_cast<std::uint8_t>( value >> ( 8u * i ) ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborReader::CborReader( std::span<const std::uint8_t> bytes )
+    : m_bytes( bytes )
+    , m_position( 0u )
+    , m_stream( nullptr )
+    , m_chunkSize( 0u )
+    , m_discarded( 0u )
+    , m_depth( 0u )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborReader::CborReader( std::istream& stream, size_t chunkSize /* = DEFAULT_CHUNK_SIZE */ )
+    : m_position( 0u )
+    , m_stream( &stream )
+    , m_chunkSize( std::max( chunkSize, size_t( 1u ) ) )
+    , m_discarded( 0u )
+    , m_depth( 0u )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborReader::DepthGuard::DepthGuard( CborReader& reader )
+    : m_reader( reader )
+{
+    if ( m_reader.m_depth == MAX_DEPTH )
+    {
+        throw std::runtime_error( "Invalid CBOR: Data nested deeper than " + std::to_string( MAX_DEPTH ) +
+                                  " levels at " + std::to_string( m_reader.offset() ) );
+    }
+    m_reader.m_depth++;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborReader::DepthGuard::~DepthGuard()
+{
+    m_reader.m_depth--;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborReader::atEnd()
+{
+    return !fill( 1u );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint8_t CborReader::peek()
+{
+    require( 1u );
+    return m_bytes[m_position];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint8_t CborReader::peekMajorType()
+{
+    return peek() >> 5;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborReader::peekNull()
+{
+    return peek() == Cbor::CBOR_NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborReader::readBreak()
+{
+    if ( peek() != Cbor::CBOR_BREAK ) return false;
+    ++m_position;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CborReader::Head CborReader::readHead()
+{
+    const std::uint8_t initial    = readByte();
+    const std::uint8_t majorType  = initial >> 5;
+    const std::uint8_t additional = initial & 0x1f;
+
+    if ( additional < 24u ) return { majorType, additional, additional, false };
+    if ( additional <= 27u )
+    {
+        return { majorType, additional, readBigEndian( size_t( 1u ) << ( additional - 24u ) ), false };
+    }
+    if ( additional == 31u && majorType != Cbor::UNSIGNED_INTEGER && majorType != Cbor::NEGATIVE_INTEGER &&
+         majorType != Cbor::TAG )
+    {
+        return { majorType, additional, 0u, true };
+    }
+    throw std::runtime_error( "Invalid CBOR: Malformed initial byte at " + std::to_string( offset() - 1u ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::optional<std::uint64_t> CborReader::readContainer( std::uint8_t expectedMajorType )
+{
+    auto head = readHead();
+    if ( head.majorType != expectedMajorType )
+    {
+        throw std::runtime_error( "Invalid CBOR: Unexpected data item at " + std::to_string( offset() ) );
+    }
+    if ( head.indefinite ) return std::nullopt;
+    return head.argument;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborReader::hasNext( std::optional<std::uint64_t>& remaining )
+{
+    if ( !remaining ) return !readBreak();
+    if ( *remaining == 0u ) return false;
+    --*remaining;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string CborReader::readText()
+{
+    auto head = readHead();
+    if ( head.majorType != Cbor::TEXT_STRING )
+    {
+        throw std::runtime_error( "Invalid CBOR: Expected text string at " + std::to_string( offset() ) );
+    }
+    return readStringContent( head );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value CborReader::readValue()
+{
+    auto head = readHead();
+    switch ( head.majorType )
+    {
+        case Cbor::UNSIGNED_INTEGER:
+            if ( head.argument <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() ) )
+            {
+                return json::value( static_cast<std::int64_t>( head.argument ) );
+            }
+            return json::value( head.argument );
+        case Cbor::NEGATIVE_INTEGER:
+            if ( head.argument <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() ) )
+            {
+                return json::value( -1 - static_cast<std::int64_t>( head.argument ) );
+            }
+            return json::value( -1.0 - static_cast<double>( head.argument ) );
+        case Cbor::BYTE_STRING:
+            return json::value( StringTools::encodeBase64( readStringContent( head ) ) );
+        case Cbor::TEXT_STRING:
+            return json::value( readStringContent( head ) );
+        case Cbor::ARRAY:
+        {
+            DepthGuard                   guard( *this );
+            json::array                  array;
+            std::optional<std::uint64_t> remaining;
+            if ( !head.indefinite )
+            {
+                remaining = head.argument;
+                array.reserve( static_cast<size_t>( std::min<std::uint64_t>( head.argument, bufferedBytes() ) ) );
+            }
+            while ( hasNext( remaining ) )
+            {
+                array.push_back( readValue() );
+            }
+            return array;
+        }
+        case Cbor::MAP:
+        {
+            DepthGuard                   guard( *this );
+            json::object                 object;
+            std::optional<std::uint64_t> remaining;
+            if ( !head.indefinite ) remaining = head.argument;
+            while ( hasNext( remaining ) )
+            {
+                auto key    = readText();
+                object[key] = readValue();
+            }
+            return object;
+        }
+        case Cbor::TAG:
+        {
+            if ( head.argument >= Cbor::TYPED_ARRAY_FIRST_TAG && head.argument <= Cbor::TYPED_ARRAY_LAST_TAG &&
+                 peekMajorType() == Cbor::BYTE_STRING )
+            {
+                return readTypedArrayValue( head.argument );
+            }
+            // Other tags carry no meaning for JSON values
+            DepthGuard guard( *this );
+            return readValue();
+        }
+        default:
+            return readSimple( head );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborReader::skipValue()
+{
+    auto head = readHead();
+    switch ( head.majorType )
+    {
+        case Cbor::BYTE_STRING:
+        case Cbor::TEXT_STRING:
+            if ( head.indefinite )
+            {
+                DepthGuard guard( *this );
+                while ( !readBreak() )
+                {
+                    skipValue();
+                }
+            }
+            else
+            {
+                skipBytes( head.argument );
+            }
+            break;
+        case Cbor::ARRAY:
+        case Cbor::MAP:
+        {
+            DepthGuard                   guard( *this );
+            const std::uint64_t          itemsPerEntry = head.majorType == Cbor::MAP ? 2u : 1u;
+            std::optional<std::uint64_t> remaining;
+            if ( !head.indefinite ) remaining = head.argument;
+            while ( hasNext( remaining ) )
+            {
+                for ( std::uint64_t i = 0u; i < itemsPerEntry; ++i )
+                {
+                    skipValue();
+                }
+            }
+            break;
+        }
+        case Cbor::TAG:
+        {
+            DepthGuard guard( *this );
+            skipValue();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The bytes of the item are kept in the stream buffer until the item has been copied
+//--------------------------------------------------------------------------------------------------
+CborWriter::Bytes CborReader::readEncodedValue()
+{
+    m_mark = m_position;
+    skipValue();
+
+    CborWriter::Bytes encoded( m_bytes.begin() + *m_mark, m_bytes.begin() + m_position );
+    m_mark.reset();
+    return encoded;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool CborReader::readBoolean()
+{
+    const auto value = readByte();
+    if ( value != Cbor::CBOR_TRUE && value != Cbor::CBOR_FALSE )
+    {
+        throw std::runtime_error( "Invalid CBOR: Expected a boolean at " + std::to_string( offset() - 1u ) );
+    }
+    return value == Cbor::CBOR_TRUE;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint8_t CborReader::readByte()
+{
+    require( 1u );
+    return m_bytes[m_position++];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t CborReader::readBigEndian( size_t size )
+{
+    require( size );
+    std::uint64_t value = 0u;
+    for ( size_t i = 0u; i < size; ++i )
+    {
+        value = ( value << 8 ) | m_bytes[m_position++];
+    }
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t CborReader::readEndian( size_t size, bool littleEndian )
+{
+    if ( !littleEndian ) return readBigEndian( size );
+
+    require( size );
+    std::uint64_t value = 0u;
+    for ( size_t i = 0u; i < size; ++i )
+    {
+        value |= static_cast<std::uint64_t>( m_bytes[m_position++] ) << ( 8u * i );
+    }
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborReader::skipBytes( std::uint64_t size )
+{
+    require( size );
+    m_position += static_cast<size_t>( size );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string CborReader::readStringContent( const Head& head )
+{
+    if ( !head.indefinite )
+    {
+        require( head.argument );
+        std::string string( reinterpret_cast<const char*>( m_bytes.data() + m_position ),
+                            static_cast<size_t>( head.argument ) );
+        m_position += static_cast<size_t>( head.argument );
+        return string;
+    }
+
+    // Indefinite length strings are a sequence of definite length chunks of the same major type
+    std::string string;
+    while ( !readBreak() )
+    {
+        auto chunk = readHead();
+        if ( chunk.majorType != head.majorType || chunk.indefinite )
+        {
+            throw std::runtime_error( "Invalid CBOR: Malformed string chunk at " + std::to_string( offset() ) );
+        }
+        string += readStringContent( chunk );
+    }
+    return string;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read the byte string header of a typed array and make sure all the data is available
+//--------------------------------------------------------------------------------------------------
+CborReader::TypedArrayLayout CborReader::readTypedArrayLayout( std::uint64_t tag )
+{
+    const auto data = readHead();
+    if ( data.indefinite )
+    {
+        throw std::runtime_error( "Invalid CBOR: Typed arrays have to be definite length" );
+    }
+
+    const size_t exponent = static_cast<size_t>( tag & Cbor::TYPED_ARRAY_LENGTH_BITS );
+
+    TypedArrayLayout layout;
+    layout.isFloat      = ( tag & Cbor::TYPED_ARRAY_FLOAT_BIT ) != 0u;
+    layout.isSigned     = ( tag & Cbor::TYPED_ARRAY_SIGNED_BIT ) != 0u;
+    layout.littleEndian = ( tag & Cbor::TYPED_ARRAY_LITTLE_BIT ) != 0u;
+    layout.elementSize  = layout.isFloat ? ( size_t( 2u ) << exponent ) : ( size_t( 1u ) << exponent );
+
+    if ( layout.isFloat && layout.elementSize == 16u )
+    {
+        throw std::runtime_error( "Invalid CBOR: 128 bit floating point typed arrays are not supported" );
+    }
+    if ( data.argument % layout.elementSize != 0u )
+    {
+        throw std::runtime_error( "Invalid CBOR: Typed array length is not a multiple of the element size" );
+    }
+    require( data.argument );
+
+    layout.count = static_cast<size_t>( data.argument / layout.elementSize );
+    return layout;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value CborReader::readTypedArrayValue( std::uint64_t tag )
+{
+    const auto layout = readTypedArrayLayout( tag );
+
+    json::array array;
+    array.reserve( layout.count );
+    for ( size_t i = 0u; i < layout.count; ++i )
+    {
+        const std::uint64_t bits = readEndian( layout.elementSize, layout.littleEndian );
+        if ( layout.isFloat )
+        {
+            array.emplace_back( floatFromBits( bits, layout.elementSize ) );
+        }
+        else if ( layout.isSigned )
+        {
+            array.emplace_back( signExtend( bits, layout.elementSize ) );
+        }
+        else if ( bits <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() ) )
+        {
+            array.emplace_back( static_cast<std::int64_t>( bits ) );
+        }
+        else
+        {
+            array.emplace_back( bits );
+        }
+    }
+    return array;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value CborReader::readSimple( const Head& head )
+{
+    if ( head.indefinite )
+    {
+        throw std::runtime_error( "Invalid CBOR: Unexpected break at " + std::to_string( offset() - 1u ) );
+    }
+    if ( const auto value = floatingPoint( head ); value )
+    {
+        return json::value( *value );
+    }
+
+    switch ( head.additional )
+    {
+        case 20u:
+            return json::value( false );
+        case 21u:
+            return json::value( true );
+        case 22u:
+        case 23u:
+            return json::value( nullptr );
+        default:
+            throw std::runtime_error( "Invalid CBOR: Unsupported simple value " + std::to_string( head.argument ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The value of a half, single or double precision head
+//--------------------------------------------------------------------------------------------------
+std::optional<double> CborReader::floatingPoint( const Head& head ) const
+{
+    if ( head.majorType != Cbor::SIMPLE || head.additional < 25u || head.additional > 27u ) return std::nullopt;
+
+    return floatFromBits( head.argument, size_t( 1u ) << ( head.additional - 24u ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double CborReader::halfToDouble( std::uint16_t half )
+{
+    const int exponent = ( half >> 10 ) & 0x1f;
+    const int mantissa = half & 0x3ff;
+
+    double value = 0.0;
+    if ( exponent == 0 )
+        value = std::ldexp( mantissa, -24 );
+    else if ( exponent != 31 )
+        value = std::ldexp( mantissa + 1024, exponent - 25 );
+    else
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+
+    return ( half & 0x8000 ) ? -value : value;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double CborReader::floatFromBits( std::uint64_t bits, size_t size )
+{
+    if ( size == 2u ) return halfToDouble( static_cast<std::uint16_t>( bits ) );
+    if ( size == 4u ) return static_cast<double>( std::bit_cast<float>( static_cast<std::uint32_t>( bits ) ) );
+    return std::bit_cast<double>( bits );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t CborReader::signExtend( std::uint64_t bits, size_t size )
+{
+    const size_t shift = 64u - 8u * size;
+    return static_cast<std::int64_t>( bits << shift ) >> shift;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Bytes which have been read are dropped from the stream buffer before reading more, unless readEncodedValue needs
+/// them.
+//--------------------------------------------------------------------------------------------------
+bool CborReader::fill( std::uint64_t size )
+{
+    if ( size <= bufferedBytes() ) return true;
+    if ( !m_stream ) return false;
+
+    const size_t keep = m_mark ? *m_mark : m_position;
+    m_buffer.erase( m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>( keep ) );
+    m_discarded += keep;
+    m_position -= keep;
+    if ( m_mark ) *m_mark -= keep;
+
+    // The stream is read a chunk at a time, so a corrupt length cannot make the buffer grow beyond the data
+    while ( size > m_buffer.size() - m_position && *m_stream )
+    {
+        const size_t start = m_buffer.size();
+        m_buffer.resize( start + m_chunkSize );
+        m_stream->read( reinterpret_cast<char*>( m_buffer.data() + start ),
+                        static_cast<std::streamsize>( m_chunkSize ) );
+        m_buffer.resize( start + static_cast<size_t>( m_stream->gcount() ) );
+    }
+    m_bytes = m_buffer;
+    return size <= bufferedBytes();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CborReader::require( std::uint64_t size )
+{
+    if ( !fill( size ) )
+    {
+        throw std::runtime_error( "Invalid CBOR: Data ends prematurely at " +
+                                  std::to_string( m_discarded + m_bytes.size() ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t CborReader::bufferedBytes() const
+{
+    return m_bytes.size() - m_position;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The position in the data as a whole, for error messages
+//--------------------------------------------------------------------------------------------------
+size_t CborReader::offset() const
+{
+    return m_discarded + m_position;
+}
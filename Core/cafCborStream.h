@@ -0,0 +1,669 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace caffa::Cbor
+{
+enum MajorType : std::uint8_t
+{
+    UNSIGNED_INTEGER = 0,
+    NEGATIVE_INTEGER = 1,
+    BYTE_STRING      = 2,
+    TEXT_STRING      = 3,
+    ARRAY            = 4,
+    MAP              = 5,
+    TAG              = 6,
+    SIMPLE           = 7
+};
+
+constexpr std::uint8_t CBOR_FALSE   = 0xf4;
+constexpr std::uint8_t CBOR_TRUE    = 0xf5;
+constexpr std::uint8_t CBOR_NULL    = 0xf6;
+constexpr std::uint8_t CBOR_FLOAT32 = 0xfa;
+constexpr std::uint8_t CBOR_FLOAT64 = 0xfb;
+constexpr std::uint8_t CBOR_BREAK   = 0xff;
+
+// RFC 8746 typed array tags are 0b010fsell: float, signed, little endian and a two bit size exponent
+constexpr std::uint64_t TYPED_ARRAY_FIRST_TAG   = 64;
+constexpr std::uint64_t TYPED_ARRAY_LAST_TAG    = 87;
+constexpr std::uint64_t TYPED_ARRAY_FLOAT_BIT   = 0x10;
+constexpr std::uint64_t TYPED_ARRAY_SIGNED_BIT  = 0x08;
+constexpr std::uint64_t TYPED_ARRAY_LITTLE_BIT  = 0x04;
+constexpr std::uint64_t TYPED_ARRAY_LENGTH_BITS = 0x03;
+
+/**
+ * Numbers with a typed array element type. Character types are left out, since they are not numbers in JSON either.
+ */
+template <typename T>
+concept Number = std::same_as<T, float> || std::same_as<T, double> ||
+                 ( std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char> &&
+                   !std::same_as<T, wchar_t> && !std::same_as<T, char8_t> && !std::same_as<T, char16_t> &&
+                   !std::same_as<T, char32_t> );
+
+template <typename T>
+struct IsNumberVector : std::false_type
+{
+};
+
+template <Number T>
+struct IsNumberVector<std::vector<T>> : std::true_type
+{
+};
+
+/**
+ * Values which are encoded and decoded directly, without going through their JSON representation
+ */
+template <typename T>
+concept Value = std::same_as<T, bool> || Number<T> || std::same_as<T, std::string> ||
+                std::same_as<T, std::vector<std::string>> || IsNumberVector<T>::value;
+
+/**
+ * The little endian typed array tag of an element type
+ */
+template <Number T>
+constexpr std::uint64_t typedArrayTag()
+{
+    if constexpr ( std::floating_point<T> )
+    {
+        return TYPED_ARRAY_FIRST_TAG | TYPED_ARRAY_FLOAT_BIT | TYPED_ARRAY_LITTLE_BIT | ( sizeof( T ) == 4u ? 1u : 2u );
+    }
+    else
+    {
+        const std::uint64_t signedBit = std::is_signed_v<T> ? TYPED_ARRAY_SIGNED_BIT : 0u;
+        if constexpr ( sizeof( T ) == 1u )
+        {
+            return TYPED_ARRAY_FIRST_TAG | signedBit;
+        }
+        else
+        {
+            return TYPED_ARRAY_FIRST_TAG | signedBit | TYPED_ARRAY_LITTLE_BIT |
+                   static_cast<std::uint64_t>( std::countr_zero( sizeof( T ) ) );
+        }
+    }
+}
+
+} // namespace caffa::Cbor
+
+namespace caffa
+{
+/**
+ * Appends CBOR (RFC 8949) data items to a byte array.
+ *
+ * Numeric vectors are written as RFC 8746 little endian typed arrays, using the narrowest element type that holds
+ * every value exactly. Vectors of bytes are byte data and are written as plain byte strings.
+ */
+class CborWriter
+{
+public:
+    using Bytes = std::vector<std::uint8_t>;
+
+    /**
+     * Construct a writer appending to a byte array
+     * @param output The byte array to append to
+     */
+    explicit CborWriter( Bytes& output );
+
+    /**
+     * Write the initial byte and argument of a data item
+     * @param majorType The major type of the data item
+     * @param argument The value, length or number of entries depending on the major type
+     */
+    void head( std::uint8_t majorType, std::uint64_t argument );
+
+    void null();
+    void boolean( bool value );
+    void integer( std::int64_t value );
+    void unsignedInteger( std::uint64_t value );
+    void text( std::string_view text );
+    void bytes( std::span<const std::uint8_t> bytes );
+
+    /**
+     * Write a floating point number, in single precision if that represents the value exactly
+     * @param value The number
+     */
+    void floatingPoint( double value );
+
+    /**
+     * Write a JSON value. Arrays of numbers are written as typed arrays.
+     * @param value The JSON value
+     */
+    void value( const json::value& value );
+
+    /**
+     * Write a value directly from its C++ type
+     * @param value The value
+     */
+    template <Cbor::Value T>
+    void write( const T& value );
+
+    /**
+     * Write numbers as a typed array, or as a byte string for bytes. Fewer than two numbers are written as an array.
+     * @param values The numbers
+     */
+    template <Cbor::Number T>
+    void numbers( std::span<const T> values );
+
+private:
+    bool numberArray( const json::array& array );
+
+    template <Cbor::Number Element, Cbor::Number T>
+    void typedArray( std::span<const T> values );
+
+    void bigEndian( std::uint64_t value, size_t size );
+
+    Bytes& m_output;
+};
+
+/**
+ * Reads CBOR (RFC 8949) data items from a byte array or from a stream.
+ *
+ * A stream is read in chunks as the data is needed, so only the data item being read has to be held in memory.
+ * Throws std::runtime_error on invalid or truncated data, and on data nested deeper than MAX_DEPTH.
+ */
+class CborReader
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64u * 1024u;
+    /// The same as the default boost::json::parse_options::max_depth, so CBOR nests as deep as JSON
+    static constexpr size_t MAX_DEPTH = 32u;
+
+    struct Head
+    {
+        std::uint8_t  majorType;
+        std::uint8_t  additional;
+        std::uint64_t argument;
+        bool          indefinite;
+    };
+
+    /**
+     * Construct a reader reading from a byte array
+     * @param bytes The CBOR data. Has to outlive the reader.
+     */
+    explicit CborReader( std::span<const std::uint8_t> bytes );
+
+    /**
+     * Construct a reader reading from a stream. The reader may read past the end of the last data item it decodes.
+     * @param stream The input stream
+     * @param chunkSize The number of bytes to read from the stream at a time
+     */
+    explicit CborReader( std::istream& stream, size_t chunkSize = DEFAULT_CHUNK_SIZE );
+
+    CborReader( const CborReader& )            = delete;
+    CborReader& operator=( const CborReader& ) = delete;
+
+    /**
+     * Counts one level of nesting for as long as it lives. Readers of nested data hold one per container, so crafted
+     * data can not nest deep enough to overflow the stack. Throws std::runtime_error beyond MAX_DEPTH levels.
+     */
+    class DepthGuard
+    {
+    public:
+        explicit DepthGuard( CborReader& reader );
+        ~DepthGuard();
+
+        DepthGuard( const DepthGuard& )            = delete;
+        DepthGuard& operator=( const DepthGuard& ) = delete;
+
+    private:
+        CborReader& m_reader;
+    };
+
+    [[nodiscard]] bool         atEnd();
+    [[nodiscard]] std::uint8_t peek();
+    [[nodiscard]] std::uint8_t peekMajorType();
+    [[nodiscard]] bool         peekNull();
+
+    /**
+     * Consume a break code if there is one. Used to end indefinite length items.
+     */
+    bool readBreak();
+
+    Head readHead();
+
+    /**
+     * Read a map or array header
+     * @return the number of entries or nullopt for indefinite length
+     */
+    std::optional<std::uint64_t> readContainer( std::uint8_t expectedMajorType );
+
+    /**
+     * Check if there are more entries in a container opened with readContainer
+     */
+    bool hasNext( std::optional<std::uint64_t>& remaining );
+
+    std::string readText();
+
+    /**
+     * Read a data item as a JSON value. Typed arrays become arrays of numbers and byte strings become base64 strings.
+     * @return the JSON value
+     */
+    json::value readValue();
+
+    void skipValue();
+
+    /**
+     * Read the next data item without decoding it
+     * @return the encoded data item
+     */
+    CborWriter::Bytes readEncodedValue();
+
+    /**
+     * Read a value directly into its C++ type. Numbers are converted to the type if they fit, numeric vectors are read
+     * from arrays, typed arrays and byte strings.
+     * @return the value
+     */
+    template <Cbor::Value T>
+    T read();
+
+private:
+    struct TypedArrayLayout
+    {
+        size_t elementSize;
+        size_t count;
+        bool   isFloat;
+        bool   isSigned;
+        bool   littleEndian;
+    };
+
+    template <Cbor::Number T>
+    T readNumber();
+
+    template <Cbor::Number T>
+    std::vector<T> readNumbers();
+
+    template <Cbor::Number T>
+    std::vector<T> readTypedArray( std::uint64_t tag );
+
+    template <Cbor::Number T, typename Source>
+    T convertNumber( Source value ) const;
+
+    bool                  readBoolean();
+    std::uint8_t          readByte();
+    std::uint64_t         readBigEndian( size_t size );
+    std::uint64_t         readEndian( size_t size, bool littleEndian );
+    void                  skipBytes( std::uint64_t size );
+    std::string           readStringContent( const Head& head );
+    TypedArrayLayout      readTypedArrayLayout( std::uint64_t tag );
+    json::value           readTypedArrayValue( std::uint64_t tag );
+    json::value           readSimple( const Head& head );
+    std::optional<double> floatingPoint( const Head& head ) const;
+
+    static double       halfToDouble( std::uint16_t half );
+    static double       floatFromBits( std::uint64_t bits, size_t size );
+    static std::int64_t signExtend( std::uint64_t bits, size_t size );
+
+    /**
+     * Make sure the given number of bytes is available from the current position, reading from the stream if needed
+     * @return false if the data ends before that
+     */
+    bool fill( std::uint64_t size );
+    void require( std::uint64_t size );
+
+    [[nodiscard]] size_t bufferedBytes() const;
+    [[nodiscard]] size_t offset() const;
+
+    std::span<const std::uint8_t> m_bytes;
+    size_t                        m_position;
+    std::istream*                 m_stream;
+    size_t                        m_chunkSize;
+    std::vector<std::uint8_t>     m_buffer;
+    size_t                        m_discarded;
+    std::optional<size_t>         m_mark;
+    size_t                        m_depth;
+};
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Value T>
+void CborWriter::write( const T& value )
+{
+    if constexpr ( std::same_as<T, bool> )
+    {
+        boolean( value );
+    }
+    else if constexpr ( std::floating_point<T> )
+    {
+        floatingPoint( value );
+    }
+    else if constexpr ( std::signed_integral<T> )
+    {
+        integer( value );
+    }
+    else if constexpr ( std::unsigned_integral<T> )
+    {
+        unsignedInteger( value );
+    }
+    else if constexpr ( std::same_as<T, std::string> )
+    {
+        text( value );
+    }
+    else if constexpr ( std::same_as<T, std::vector<std::string>> )
+    {
+        head( Cbor::ARRAY, value.size() );
+        for ( const auto& entry : value )
+        {
+            text( entry );
+        }
+    }
+    else
+    {
+        numbers( std::span<const typename T::value_type>( value ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number T>
+void CborWriter::numbers( std::span<const T> values )
+{
+    if constexpr ( std::same_as<T, std::uint8_t> )
+    {
+        bytes( values );
+        return;
+    }
+
+    if ( values.size() < 2u )
+    {
+        head( Cbor::ARRAY, values.size() );
+        for ( const T value : values )
+        {
+            write( value );
+        }
+        return;
+    }
+
+    if constexpr ( std::floating_point<T> )
+    {
+        auto isSingle = []( T value ) { return static_cast<T>( static_cast<float>( value ) ) == value; };
+        if ( std::ranges::all_of( values, isSingle ) )
+        {
+            typedArray<float>( values );
+        }
+        else
+        {
+            typedArray<double>( values );
+        }
+    }
+    else
+    {
+        std::int64_t  minimum = 0;
+        std::uint64_t maximum = 0u;
+        for ( const T value : values )
+        {
+            if constexpr ( std::is_signed_v<T> )
+            {
+                minimum = std::min( minimum, static_cast<std::int64_t>( value ) );
+            }
+            if ( value > 0 )
+            {
+                maximum = std::max( maximum, static_cast<std::uint64_t>( value ) );
+            }
+        }
+
+        constexpr auto int32Max = static_cast<std::uint64_t>( std::numeric_limits<std::int32_t>::max() );
+        constexpr auto int64Max = static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() );
+
+        if ( minimum == 0 && maximum <= UINT8_MAX )
+        {
+            typedArray<std::uint8_t>( values );
+        }
+        else if ( minimum >= std::numeric_limits<std::int32_t>::min() && maximum <= int32Max )
+        {
+            typedArray<std::int32_t>( values );
+        }
+        else if ( maximum <= int64Max )
+        {
+            typedArray<std::int64_t>( values );
+        }
+        else
+        {
+            typedArray<std::uint64_t>( values );
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the values as a typed array of the given element type. The values have to fit in the element type.
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number Element, Cbor::Number T>
+void CborWriter::typedArray( std::span<const T> values )
+{
+    head( Cbor::TAG, Cbor::typedArrayTag<Element>() );
+    head( Cbor::BYTE_STRING, values.size() * sizeof( Element ) );
+
+    const size_t start = m_output.size();
+    m_output.resize( start + values.size() * sizeof( Element ) );
+    auto* data = m_output.data() + start;
+    if constexpr ( std::same_as<Element, T> && std::endian::native == std::endian::little )
+    {
+        std::memcpy( data, values.data(), values.size_bytes() );
+    }
+    else
+    {
+        for ( const T value : values )
+        {
+            const auto element = static_cast<Element>( value );
+            std::memcpy( data, &element, sizeof( Element ) );
+            if constexpr ( std::endian::native == std::endian::big )
+            {
+                std::reverse( data, data + sizeof( Element ) );
+            }
+            data += sizeof( Element );
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Value T>
+T CborReader::read()
+{
+    if constexpr ( std::same_as<T, bool> )
+    {
+        return readBoolean();
+    }
+    else if constexpr ( Cbor::Number<T> )
+    {
+        return readNumber<T>();
+    }
+    else if constexpr ( std::same_as<T, std::string> )
+    {
+        return readText();
+    }
+    else if constexpr ( std::same_as<T, std::vector<std::string>> )
+    {
+        T    values;
+        auto remaining = readContainer( Cbor::ARRAY );
+        while ( hasNext( remaining ) )
+        {
+            values.push_back( readText() );
+        }
+        return values;
+    }
+    else
+    {
+        return readNumbers<typename T::value_type>();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number T>
+T CborReader::readNumber()
+{
+    const auto head = readHead();
+    switch ( head.majorType )
+    {
+        case Cbor::UNSIGNED_INTEGER:
+            return convertNumber<T>( head.argument );
+        case Cbor::NEGATIVE_INTEGER:
+            if ( head.argument <= static_cast<std::uint64_t>( std::numeric_limits<std::int64_t>::max() ) )
+            {
+                return convertNumber<T>( -1 - static_cast<std::int64_t>( head.argument ) );
+            }
+            return convertNumber<T>( -1.0 - static_cast<double>( head.argument ) );
+        case Cbor::TAG:
+        {
+            DepthGuard guard( *this );
+            return readNumber<T>();
+        }
+        case Cbor::SIMPLE:
+            if ( const auto value = floatingPoint( head ); value )
+            {
+                return convertNumber<T>( *value );
+            }
+            break;
+        default:
+            break;
+    }
+    throw std::runtime_error( "Invalid CBOR: Expected a number at " + std::to_string( offset() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number T>
+std::vector<T> CborReader::readNumbers()
+{
+    const auto head = readHead();
+    if ( head.majorType == Cbor::TAG )
+    {
+        if ( head.argument >= Cbor::TYPED_ARRAY_FIRST_TAG && head.argument <= Cbor::TYPED_ARRAY_LAST_TAG &&
+             peekMajorType() == Cbor::BYTE_STRING )
+        {
+            return readTypedArray<T>( head.argument );
+        }
+        DepthGuard guard( *this );
+        return readNumbers<T>();
+    }
+
+    std::vector<T> values;
+    if ( head.majorType == Cbor::BYTE_STRING )
+    {
+        const auto bytes = readStringContent( head );
+        values.reserve( bytes.size() );
+        for ( const char byte : bytes )
+        {
+            values.push_back( convertNumber<T>( static_cast<std::uint64_t>( static_cast<std::uint8_t>( byte ) ) ) );
+        }
+        return values;
+    }
+    if ( head.majorType != Cbor::ARRAY )
+    {
+        throw std::runtime_error( "Invalid CBOR: Expected an array at " + std::to_string( offset() ) );
+    }
+
+    std::optional<std::uint64_t> remaining;
+    if ( !head.indefinite )
+    {
+        remaining = head.argument;
+        values.reserve( static_cast<size_t>( std::min<std::uint64_t>( head.argument, bufferedBytes() ) ) );
+    }
+    while ( hasNext( remaining ) )
+    {
+        values.push_back( readNumber<T>() );
+    }
+    return values;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read a typed array, copying the data straight into the vector if the element type is the same
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number T>
+std::vector<T> CborReader::readTypedArray( std::uint64_t tag )
+{
+    const auto layout = readTypedArrayLayout( tag );
+
+    std::vector<T> values( layout.count );
+    if constexpr ( std::endian::native == std::endian::little )
+    {
+        if ( tag == Cbor::typedArrayTag<T>() )
+        {
+            std::memcpy( values.data(), m_bytes.data() + m_position, layout.count * sizeof( T ) );
+            m_position += layout.count * sizeof( T );
+            return values;
+        }
+    }
+
+    for ( auto& value : values )
+    {
+        const std::uint64_t bits = readEndian( layout.elementSize, layout.littleEndian );
+        if ( layout.isFloat )
+        {
+            value = convertNumber<T>( floatFromBits( bits, layout.elementSize ) );
+        }
+        else if ( layout.isSigned )
+        {
+            value = convertNumber<T>( signExtend( bits, layout.elementSize ) );
+        }
+        else
+        {
+            value = convertNumber<T>( bits );
+        }
+    }
+    return values;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <Cbor::Number T, typename Source>
+T CborReader::convertNumber( Source value ) const
+{
+    if constexpr ( std::floating_point<T> )
+    {
+        return static_cast<T>( value );
+    }
+    else if constexpr ( std::floating_point<Source> )
+    {
+        throw std::runtime_error( "Invalid CBOR: Expected an integer at " + std::to_string( offset() ) );
+    }
+    else
+    {
+        if ( !std::in_range<T>( value ) )
+        {
+            throw std::runtime_error( "Invalid CBOR: Integer out of range at " + std::to_string( offset() ) );
+        }
+        return static_cast<T>( value );
+    }
+}
+
+} // namespace caffa
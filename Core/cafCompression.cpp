@@ -0,0 +1,528 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafCompression.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+#ifdef CAFFA_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CAFFA_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace caffa;
+
+//==================================================================================================
+///
+//==================================================================================================
+class CompressingStreamBuffer::Encoder
+{
+public:
+    virtual ~Encoder() = default;
+
+    virtual void write( std::string_view data ) = 0;
+    virtual void finish()                       = 0;
+};
+
+//==================================================================================================
+///
+//==================================================================================================
+class Decompressor::Decoder
+{
+public:
+    virtual ~Decoder() = default;
+
+    virtual void write( std::string_view chunk, const Decompressor::Sink& sink ) = 0;
+    virtual void finish()                                                       = 0;
+};
+
+namespace
+{
+using Encoder = CompressingStreamBuffer::Encoder;
+using Decoder = Decompressor::Decoder;
+
+std::string compressionLabel( Compression compression )
+{
+    switch ( compression )
+    {
+        case Compression::NONE:
+            return "uncompressed";
+        case Compression::GZIP:
+            return "gzip";
+        case Compression::ZSTD:
+            return "zstd";
+    }
+    return "unknown";
+}
+
+#ifdef CAFFA_HAS_ZLIB
+// zlib counts in unsigned int, so larger inputs are handed over in slices
+constexpr size_t MAX_ZLIB_SLICE = 1u << 30u;
+
+//==================================================================================================
+///
+//==================================================================================================
+class GzipEncoder : public Encoder
+{
+public:
+    GzipEncoder( std::ostream& stream, int level )
+        : m_stream( stream )
+        , m_zStream{}
+        , m_output( CompressingStreamBuffer::BUFFER_SIZE )
+    {
+        // 16 added to the window bits gives a gzip header and trailer instead of a zlib one
+        if ( deflateInit2( &m_zStream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+        {
+            throw std::runtime_error( "Failed to initialise gzip compression with level " + std::to_string( level ) );
+        }
+    }
+    ~GzipEncoder() override { deflateEnd( &m_zStream ); }
+
+    void write( std::string_view data ) override
+    {
+        while ( !data.empty() )
+        {
+            const auto slice = data.substr( 0u, MAX_ZLIB_SLICE );
+            data.remove_prefix( slice.size() );
+            deflateSlice( slice, Z_NO_FLUSH );
+        }
+    }
+
+    void finish() override { deflateSlice( {}, Z_FINISH ); }
+
+private:
+    void deflateSlice( std::string_view slice, int flush )
+    {
+        m_zStream.next_in  = reinterpret_cast<Bytef*>( const_cast<char*>( slice.data() ) );
+        m_zStream.avail_in = static_cast<uInt>( slice.size() );
+
+        int result = Z_OK;
+        do
+        {
+            m_zStream.next_out  = reinterpret_cast<Bytef*>( m_output.data() );
+            m_zStream.avail_out = static_cast<uInt>( m_output.size() );
+
+            result = deflate( &m_zStream, flush );
+            if ( result == Z_STREAM_ERROR )
+            {
+                throw std::runtime_error( "gzip compression failed" );
+            }
+            m_stream.write( m_output.data(), static_cast<std::streamsize>( m_output.size() - m_zStream.avail_out ) );
+        } while ( m_zStream.avail_out == 0u || ( flush == Z_FINISH && result != Z_STREAM_END ) );
+    }
+
+    std::ostream&     m_stream;
+    z_stream          m_zStream;
+    std::vector<char> m_output;
+};
+
+//==================================================================================================
+///
+//==================================================================================================
+class GzipDecoder : public Decoder
+{
+public:
+    GzipDecoder()
+        : m_zStream{}
+        , m_output( CompressingStreamBuffer::BUFFER_SIZE )
+        , m_streamEnded( false )
+    {
+        // 32 added to the window bits detects gzip and zlib headers automatically
+        if ( inflateInit2( &m_zStream, 15 + 32 ) != Z_OK )
+        {
+            throw std::runtime_error( "Failed to initialise gzip decompression" );
+        }
+    }
+    ~GzipDecoder() override { inflateEnd( &m_zStream ); }
+
+    void write( std::string_view chunk, const Decompressor::Sink& sink ) override
+    {
+        while ( !chunk.empty() )
+        {
+            const auto slice = chunk.substr( 0u, MAX_ZLIB_SLICE );
+            chunk.remove_prefix( slice.size() );
+            inflateSlice( slice, sink );
+        }
+    }
+
+    void finish() override
+    {
+        if ( !m_streamEnded )
+        {
+            throw std::runtime_error( "The gzip compressed stream is incomplete" );
+        }
+    }
+
+private:
+    void inflateSlice( std::string_view slice, const Decompressor::Sink& sink )
+    {
+        m_zStream.next_in  = reinterpret_cast<Bytef*>( const_cast<char*>( slice.data() ) );
+        m_zStream.avail_in = static_cast<uInt>( slice.size() );
+
+        // Keep going while there is input left or the last call filled the output, as more may be buffered
+        do
+        {
+            // Concatenated gzip members make up a single stream
+            if ( m_streamEnded )
+            {
+                if ( m_zStream.avail_in == 0u ) break;
+                inflateReset( &m_zStream );
+                m_streamEnded = false;
+            }
+
+            m_zStream.next_out  = reinterpret_cast<Bytef*>( m_output.data() );
+            m_zStream.avail_out = static_cast<uInt>( m_output.size() );
+
+            const int result = inflate( &m_zStream, Z_NO_FLUSH );
+            if ( result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR )
+            {
+                throw std::runtime_error( std::string( "Invalid gzip compressed data: " ) +
+                                          ( m_zStream.msg ? m_zStream.msg : "unknown error" ) );
+            }
+            m_streamEnded = result == Z_STREAM_END;
+
+            if ( const size_t produced = m_output.size() - m_zStream.avail_out; produced > 0u )
+            {
+                sink( std::string_view( m_output.data(), produced ) );
+            }
+
+            // No progress is possible without more input
+            if ( result == Z_BUF_ERROR ) break;
+        } while ( m_zStream.avail_in > 0u || m_zStream.avail_out == 0u );
+    }
+
+    z_stream          m_zStream;
+    std::vector<char> m_output;
+    bool              m_streamEnded;
+};
+#endif
+
+#ifdef CAFFA_HAS_ZSTD
+//==================================================================================================
+///
+//==================================================================================================
+class ZstdEncoder : public Encoder
+{
+public:
+    ZstdEncoder( std::ostream& stream, int level )
+        : m_stream( stream )
+        , m_context( ZSTD_createCCtx() )
+        , m_output( ZSTD_CStreamOutSize() )
+    {
+        if ( !m_context || ZSTD_isError( ZSTD_CCtx_setParameter( m_context, ZSTD_c_compressionLevel, level ) ) )
+        {
+            ZSTD_freeCCtx( m_context );
+            throw std::runtime_error( "Failed to initialise zstd compression with level " + std::to_string( level ) );
+        }
+    }
+    ~ZstdEncoder() override { ZSTD_freeCCtx( m_context ); }
+
+    void write( std::string_view data ) override
+    {
+        ZSTD_inBuffer input{ data.data(), data.size(), 0u };
+        while ( input.pos < input.size )
+        {
+            compress( input, ZSTD_e_continue );
+        }
+    }
+
+    void finish() override
+    {
+        ZSTD_inBuffer input{ nullptr, 0u, 0u };
+        while ( compress( input, ZSTD_e_end ) > 0u )
+        {
+        }
+    }
+
+private:
+    size_t compress( ZSTD_inBuffer& input, ZSTD_EndDirective directive )
+    {
+        ZSTD_outBuffer output{ m_output.data(), m_output.size(), 0u };
+
+        const size_t remaining = ZSTD_compressStream2( m_context, &output, &input, directive );
+        if ( ZSTD_isError( remaining ) )
+        {
+            throw std::runtime_error( std::string( "zstd compression failed: " ) + ZSTD_getErrorName( remaining ) );
+        }
+        m_stream.write( m_output.data(), static_cast<std::streamsize>( output.pos ) );
+        return remaining;
+    }
+
+    std::ostream&     m_stream;
+    ZSTD_CCtx*        m_context;
+    std::vector<char> m_output;
+};
+
+//==================================================================================================
+///
+//==================================================================================================
+class ZstdDecoder : public Decoder
+{
+public:
+    ZstdDecoder()
+        : m_context( ZSTD_createDCtx() )
+        , m_output( ZSTD_DStreamOutSize() )
+        , m_frameEnded( false )
+    {
+        if ( !m_context )
+        {
+            throw std::runtime_error( "Failed to initialise zstd decompression" );
+        }
+    }
+    ~ZstdDecoder() override { ZSTD_freeDCtx( m_context ); }
+
+    void write( std::string_view chunk, const Decompressor::Sink& sink ) override
+    {
+        ZSTD_inBuffer input{ chunk.data(), chunk.size(), 0u };
+        bool          outputFull = false;
+
+        // Keep going while there is input left or the last call filled the output, as more may be buffered
+        while ( input.pos < input.size || outputFull )
+        {
+            ZSTD_outBuffer output{ m_output.data(), m_output.size(), 0u };
+
+            const size_t result = ZSTD_decompressStream( m_context, &output, &input );
+            if ( ZSTD_isError( result ) )
+            {
+                throw std::runtime_error( std::string( "Invalid zstd compressed data: " ) +
+                                          ZSTD_getErrorName( result ) );
+            }
+            m_frameEnded = result == 0u;
+            outputFull   = output.pos == output.size;
+
+            if ( output.pos > 0u )
+            {
+                sink( std::string_view( m_output.data(), output.pos ) );
+            }
+        }
+    }
+
+    void finish() override
+    {
+        if ( !m_frameEnded )
+        {
+            throw std::runtime_error( "The zstd compressed stream is incomplete" );
+        }
+    }
+
+private:
+    ZSTD_DCtx*        m_context;
+    std::vector<char> m_output;
+    bool              m_frameEnded;
+};
+#endif
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool caffa::isCompressionSupported( Compression compression )
+{
+    switch ( compression )
+    {
+        case Compression::NONE:
+            return true;
+        case Compression::GZIP:
+#ifdef CAFFA_HAS_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case Compression::ZSTD:
+#ifdef CAFFA_HAS_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Compression caffa::detectCompression( std::string_view header )
+{
+    if ( header.starts_with( "\x1f\x8b" ) ) return Compression::GZIP;
+    if ( header.starts_with( "\x28\xb5\x2f\xfd" ) ) return Compression::ZSTD;
+    return Compression::NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CompressingStreamBuffer::CompressingStreamBuffer( std::ostream&      stream,
+                                                  Compression        compression,
+                                                  std::optional<int> level /* = std::nullopt */ )
+    : m_buffer( BUFFER_SIZE )
+    , m_finished( false )
+{
+    setp( m_buffer.data(), m_buffer.data() + m_buffer.size() );
+
+#ifdef CAFFA_HAS_ZLIB
+    if ( compression == Compression::GZIP )
+    {
+        m_encoder = std::make_unique<GzipEncoder>( stream, level.value_or( Z_DEFAULT_COMPRESSION ) );
+    }
+#endif
+#ifdef CAFFA_HAS_ZSTD
+    if ( compression == Compression::ZSTD )
+    {
+        m_encoder = std::make_unique<ZstdEncoder>( stream, level.value_or( ZSTD_CLEVEL_DEFAULT ) );
+    }
+#endif
+    if ( !m_encoder )
+    {
+        throw std::runtime_error( "Compressing to " + compressionLabel( compression ) + " is not supported" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CompressingStreamBuffer::~CompressingStreamBuffer() = default;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CompressingStreamBuffer::finish()
+{
+    if ( m_finished ) return;
+
+    flushBuffer();
+    m_finished = true;
+    m_encoder->finish();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::streamsize CompressingStreamBuffer::xsputn( const char* data, std::streamsize count )
+{
+    if ( m_finished ) return 0;
+
+    // Small writes are gathered in the put area, large ones go straight to the encoder
+    if ( count <= epptr() - pptr() )
+    {
+        std::copy_n( data, count, pptr() );
+        pbump( static_cast<int>( count ) );
+        return count;
+    }
+
+    flushBuffer();
+    if ( static_cast<size_t>( count ) < m_buffer.size() )
+    {
+        std::copy_n( data, count, pptr() );
+        pbump( static_cast<int>( count ) );
+    }
+    else
+    {
+        m_encoder->write( std::string_view( data, static_cast<size_t>( count ) ) );
+    }
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Called when the put area is full
+//--------------------------------------------------------------------------------------------------
+CompressingStreamBuffer::int_type CompressingStreamBuffer::overflow( int_type character )
+{
+    if ( m_finished ) return traits_type::eof();
+
+    flushBuffer();
+    if ( !traits_type::eq_int_type( character, traits_type::eof() ) )
+    {
+        *pptr() = traits_type::to_char_type( character );
+        pbump( 1 );
+    }
+    return traits_type::not_eof( character );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Hands the put area to the encoder. The encoder may hold on to the data until it has a full block.
+//--------------------------------------------------------------------------------------------------
+int CompressingStreamBuffer::sync()
+{
+    if ( m_finished ) return 0;
+
+    flushBuffer();
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CompressingStreamBuffer::flushBuffer()
+{
+    if ( pptr() > pbase() )
+    {
+        m_encoder->write( std::string_view( pbase(), static_cast<size_t>( pptr() - pbase() ) ) );
+    }
+    setp( m_buffer.data(), m_buffer.data() + m_buffer.size() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Decompressor::Decompressor( Compression compression )
+{
+#ifdef CAFFA_HAS_ZLIB
+    if ( compression == Compression::GZIP )
+    {
+        m_decoder = std::make_unique<GzipDecoder>();
+    }
+#endif
+#ifdef CAFFA_HAS_ZSTD
+    if ( compression == Compression::ZSTD )
+    {
+        m_decoder = std::make_unique<ZstdDecoder>();
+    }
+#endif
+    if ( !m_decoder )
+    {
+        throw std::runtime_error( "Decompressing " + compressionLabel( compression ) + " is not supported" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Decompressor::~Decompressor() = default;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void Decompressor::write( std::string_view chunk, const Sink& sink )
+{
+    m_decoder->write( chunk, sink );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void Decompressor::finish()
+{
+    m_decoder->finish();
+}
@@ -0,0 +1,135 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+namespace caffa
+{
+/**
+ * Compression formats for document streams
+ */
+enum class Compression
+{
+    NONE,
+    GZIP,
+    ZSTD
+};
+
+/**
+ * Check whether Caffa was built with support for a compression format
+ * @param compression The compression format
+ * @return true if streams can be compressed and decompressed with the format
+ */
+[[nodiscard]] bool isCompressionSupported( Compression compression );
+
+/**
+ * Detect the compression of a stream from the magic bytes at its start
+ * @param header The first bytes of the stream. Four bytes are enough for every supported format.
+ * @return the detected format or Compression::NONE if no known magic bytes are found
+ */
+[[nodiscard]] Compression detectCompression( std::string_view header );
+
+/**
+ * Output stream buffer compressing everything written to it on to another stream.
+ *
+ * Data is compressed in pieces as it is written, so the uncompressed document is never held in memory as a whole.
+ * finish() has to be called after the last write to complete the compressed stream.
+ */
+class CompressingStreamBuffer : public std::streambuf
+{
+public:
+    static constexpr size_t BUFFER_SIZE = 64u * 1024u;
+
+    /**
+     * Constructor. Throws std::runtime_error if the compression format is not supported.
+     * @param stream The stream receiving the compressed data
+     * @param compression The compression format
+     * @param level The compression level. Uses the default level of the format if not provided.
+     */
+    CompressingStreamBuffer( std::ostream& stream, Compression compression, std::optional<int> level = std::nullopt );
+    ~CompressingStreamBuffer() override;
+
+    CompressingStreamBuffer( const CompressingStreamBuffer& )            = delete;
+    CompressingStreamBuffer& operator=( const CompressingStreamBuffer& ) = delete;
+
+    /**
+     * Compress any remaining data and write the end of the compressed stream
+     */
+    void finish();
+
+    class Encoder;
+
+protected:
+    std::streamsize xsputn( const char* data, std::streamsize count ) override;
+    int_type        overflow( int_type character ) override;
+    int             sync() override;
+
+private:
+    void flushBuffer();
+
+    std::unique_ptr<Encoder> m_encoder;
+    std::vector<char>        m_buffer;
+    bool                     m_finished;
+};
+
+/**
+ * Incremental decompressor. Compressed data can be supplied in chunks of any size.
+ */
+class Decompressor
+{
+public:
+    using Sink = std::function<void( std::string_view decompressed )>;
+
+    /**
+     * Constructor. Throws std::runtime_error if the compression format is not supported.
+     * @param compression The compression format
+     */
+    explicit Decompressor( Compression compression );
+    ~Decompressor();
+
+    Decompressor( const Decompressor& )            = delete;
+    Decompressor& operator=( const Decompressor& ) = delete;
+
+    /**
+     * Decompress the next chunk. Throws std::runtime_error on corrupt data.
+     * @param chunk The compressed data
+     * @param sink Receives the decompressed data, possibly in several pieces
+     */
+    void write( std::string_view chunk, const Sink& sink );
+
+    /**
+     * Signal the end of the compressed data. Throws std::runtime_error if the compressed stream is incomplete.
+     */
+    void finish();
+
+    class Decoder;
+
+private:
+    std::unique_ptr<Decoder> m_decoder;
+};
+
+} // namespace caffa
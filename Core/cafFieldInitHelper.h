@@ -21,6 +21,7 @@
 
 #include "cafDataFieldAccessor.h"
 
+#include "cafFieldIoCapability.h"
 #include "cafFieldProxyAccessor.h"
 #include "cafFieldScriptingCapability.h"
 #include "cafFieldValidator.h"
@@ -102,6 +103,18 @@ public:
         return *this;
     }
 
+    /**
+     * Write the numeric vector held by the field as a base64 encoded binary blob. See cafJsonPackedArray.h.
+     */
+    FieldInitHelper& withPackedNumericArrays()
+    {
+        if ( auto ioCapability = m_field.template capability<FieldIoCapability>(); ioCapability )
+        {
+            ioCapability->setPackNumericArrays( true );
+        }
+        return *this;
+    }
+
     FieldInitHelper& markDeprecated()
     {
         m_field.markDeprecated();
@@ -1,10 +1,14 @@
 #include "cafFieldIoCapability.h"
 
 #include "cafAssert.h"
+#include "cafCborStream.h"
 #include "cafFieldHandle.h"
+#include "cafJsonSerializationContext.h"
+#include "cafJsonStreamWriter.h"
 #include "cafLogger.h"
 #include "cafObjectHandle.h"
 
+#include <cmath>
 #include <iostream>
 
 using namespace caffa;
@@ -12,7 +16,104 @@ using namespace caffa;
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
-FieldIoCapability::FieldIoCapability() = default;
+FieldIoCapability::FieldIoCapability()
+    : m_packNumericArrays( false )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::writeToJson( json::value&                    value,
+                                     const JsonSerializer&           serializer,
+                                     const JsonSerializationContext& context ) const
+{
+    writeToJson( value, serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::writeToStream( JsonStreamWriter& writer, const JsonSerializer& serializer ) const
+{
+    writeToStream( writer, serializer, JsonSerializationContext() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::writeToStream( JsonStreamWriter&               writer,
+                                       const JsonSerializer&           serializer,
+                                       const JsonSerializationContext& context ) const
+{
+    json::value value;
+    writeToJson( value, serializer, context );
+    if ( !value.is_null() )
+    {
+        writer.key( owner()->keyword() );
+        writer.value( value );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::writeToCbor( CborWriter& writer, const JsonSerializer& serializer ) const
+{
+    json::value value;
+    writeToJson( value, serializer );
+    writer.value( value );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::readFromCbor( CborReader& reader, const JsonSerializer& serializer )
+{
+    readFromJson( reader.readValue(), serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::copyFrom( const FieldHandle* source, const JsonSerializer& serializer )
+{
+    const auto* sourceCapability = source->capability<FieldIoCapability>();
+    CAFFA_ASSERT( sourceCapability );
+
+    json::value value;
+    sourceCapability->writeToJson( value, serializer );
+    if ( !value.is_null() )
+    {
+        readFromJson( value, serializer );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool FieldIoCapability::writesNull( const JsonSerializer& serializer ) const
+{
+    json::value value;
+    writeToJson( value, serializer );
+    return value.is_null() || ( value.is_double() && std::isnan( value.get_double() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldIoCapability::setPackNumericArrays( bool packNumericArrays )
+{
+    m_packNumericArrays = packNumericArrays;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool FieldIoCapability::packNumericArrays() const
+{
+    return m_packNumericArrays;
+}
 
 //--------------------------------------------------------------------------------------------------
 ///
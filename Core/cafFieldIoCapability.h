@@ -8,8 +8,12 @@
 
 namespace caffa
 {
+class CborReader;
+class CborWriter;
 class FieldHandle;
+class JsonSerializationContext;
 class JsonSerializer;
+class JsonStreamWriter;
 //==================================================================================================
 //
 //
@@ -23,9 +27,88 @@ public:
     virtual void readFromJson( const json::value& value, const JsonSerializer& serializer ) = 0;
     virtual void writeToJson( json::value& value, const JsonSerializer& serializer ) const  = 0;
 
+    /**
+     * Write the field as part of writing its owner object. This is what the serializer calls.
+     * The default implementation ignores the context and calls writeToJson( value, serializer ), which is fine for
+     * data fields. Fields holding child objects override it and pass the context on when writing the children.
+     * @param value The JSON value to write to
+     * @param serializer The serializer in use
+     * @param context The context for the objects held by the field
+     */
+    virtual void writeToJson( json::value&                    value,
+                              const JsonSerializer&           serializer,
+                              const JsonSerializationContext& context ) const;
+
+    /**
+     * Write the field as an object member straight to a stream writer.
+     * Calls the context version below with a context treating any child object as the top level object.
+     * @param writer The stream writer to write to
+     * @param serializer The serializer in use
+     */
+    void writeToStream( JsonStreamWriter& writer, const JsonSerializer& serializer ) const;
+
+    /**
+     * Write the field as an object member straight to a stream writer.
+     * The default implementation goes through writeToJson, which is fine for data fields, but fields holding
+     * child objects should override it so that the child objects are streamed without building a JSON tree.
+     * @param writer The stream writer to write to
+     * @param serializer The serializer in use
+     * @param context The context for the objects held by the field
+     */
+    virtual void writeToStream( JsonStreamWriter&               writer,
+                                const JsonSerializer&           serializer,
+                                const JsonSerializationContext& context ) const;
+
+    /**
+     * Write the field value as a single CBOR data item (see cafCborSerializer.h).
+     * The default implementation encodes the value written by writeToJson. Data fields of booleans, numbers, strings
+     * and vectors of these encode their value directly.
+     * @param writer The CBOR writer to write to
+     * @param serializer The serializer in use
+     */
+    virtual void writeToCbor( CborWriter& writer, const JsonSerializer& serializer ) const;
+
+    /**
+     * Read the field value from the CBOR data item at the reader position.
+     * The default implementation decodes the data item to JSON and calls readFromJson. Data fields of booleans,
+     * numbers, strings and vectors of these decode their value directly.
+     * @param reader The CBOR reader to read from
+     * @param serializer The serializer in use
+     */
+    virtual void readFromCbor( CborReader& reader, const JsonSerializer& serializer );
+
+    /**
+     * Copy the value of a field of the same type into this field without going through JSON text.
+     * The default implementation goes through writeToJson and readFromJson on the two fields.
+     * @param source The field to copy from
+     * @param serializer The serializer in use
+     */
+    virtual void copyFrom( const FieldHandle* source, const JsonSerializer& serializer );
+
+    /**
+     * Check whether the field value would be written as null. Readers skip null values and leave the field as it was,
+     * so copying skips such fields as well. NaN has no JSON representation and counts as null.
+     * The default implementation goes through writeToJson.
+     * @param serializer The serializer in use
+     * @return true if the value would be written as null
+     */
+    [[nodiscard]] virtual bool writesNull( const JsonSerializer& serializer ) const;
+
     [[nodiscard]] virtual json::object jsonType() const = 0;
 
+    /**
+     * Write numeric vectors as base64 encoded binary blobs (see cafJsonPackedArray.h) regardless of the serializer
+     * setting. Has no effect on fields of other types.
+     * @param packNumericArrays true to write packed arrays
+     */
+    void setPackNumericArrays( bool packNumericArrays );
+
+    [[nodiscard]] bool packNumericArrays() const;
+
 protected:
     void assertValid() const;
+
+private:
+    bool m_packNumericArrays;
 };
 } // End of namespace caffa
@@ -20,11 +20,17 @@ public:
     // Json Serializing
     void readFromJson( const json::value& jsonElement, const JsonSerializer& serializer ) override;
     void writeToJson( json::value& jsonElement, const JsonSerializer& serializer ) const override;
+    void writeToCbor( CborWriter& writer, const JsonSerializer& serializer ) const override;
+    void readFromCbor( CborReader& reader, const JsonSerializer& serializer ) override;
+    void copyFrom( const FieldHandle* source, const JsonSerializer& serializer ) override;
+    [[nodiscard]] bool writesNull( const JsonSerializer& serializer ) const override;
 
     [[nodiscard]] json::object jsonType() const override;
 
 private:
     FieldType* typedOwner() const { return dynamic_cast<FieldType*>( this->owner() ); }
+
+    static typename FieldType::FieldDataType valueFromJson( const json::value& jsonValue );
 };
 
 template <typename DataType>
@@ -38,11 +44,23 @@ public:
     // Json Serializing
     void readFromJson( const json::value& jsonElement, const JsonSerializer& serializer ) override;
     void writeToJson( json::value& jsonElement, const JsonSerializer& serializer ) const override;
+    void writeToJson( json::value&                    jsonElement,
+                      const JsonSerializer&           serializer,
+                      const JsonSerializationContext& context ) const override;
+    void writeToStream( JsonStreamWriter&               writer,
+                        const JsonSerializer&           serializer,
+                        const JsonSerializationContext& context ) const override;
+    void copyFrom( const FieldHandle* source, const JsonSerializer& serializer ) override;
+    [[nodiscard]] bool writesNull( const JsonSerializer& serializer ) const override;
 
     [[nodiscard]] json::object jsonType() const override;
 
 private:
     FieldType* typedOwner() const { return dynamic_cast<FieldType*>( this->owner() ); }
+
+    std::shared_ptr<DataType> readNewChildFromJson( const json::object&   jsonObject,
+                                                    const std::string&    className,
+                                                    const JsonSerializer& serializer ) const;
 };
 
 template <typename DataType>
@@ -56,11 +74,31 @@ public:
     // Json Serializing
     void readFromJson( const json::value& jsonElement, const JsonSerializer& serializer ) override;
     void writeToJson( json::value& jsonElement, const JsonSerializer& serializer ) const override;
+    void writeToJson( json::value&                    jsonElement,
+                      const JsonSerializer&           serializer,
+                      const JsonSerializationContext& context ) const override;
+    void writeToStream( JsonStreamWriter&               writer,
+                        const JsonSerializer&           serializer,
+                        const JsonSerializationContext& context ) const override;
+    void copyFrom( const FieldHandle* source, const JsonSerializer& serializer ) override;
+    [[nodiscard]] bool writesNull( const JsonSerializer& serializer ) const override;
 
     [[nodiscard]] json::object jsonType() const override;
 
 private:
     FieldType* typedOwner() const { return dynamic_cast<FieldType*>( this->owner() ); }
+
+    std::vector<std::shared_ptr<ObjectHandle>> nonNullChildren() const;
+    std::vector<std::shared_ptr<ObjectHandle>> matchExistingChildren( const json::array& jsonArray ) const;
+    std::shared_ptr<ObjectHandle>              readChildFromJson( const json::value&            jsonEntry,
+                                                                  const JsonSerializer&         serializer,
+                                                                  std::shared_ptr<ObjectHandle> existingChild ) const;
+    std::vector<std::shared_ptr<ObjectHandle>>
+        readChildrenFromJson( const json::array&                         jsonArray,
+                              const JsonSerializer&                      serializer,
+                              std::vector<std::shared_ptr<ObjectHandle>> existingChildren = {} ) const;
+
+    void updateChildren( const std::vector<std::shared_ptr<ObjectHandle>>& objects ) const;
 };
 
 template <typename FieldType>
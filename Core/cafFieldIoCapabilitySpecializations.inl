@@ -1,12 +1,21 @@
 #pragma once
 #include "cafAssert.h"
+#include "cafCborStream.h"
 #include "cafJsonDataType.h"
 #include "cafJsonDataTypeConversion.h"
+#include "cafJsonPackedArray.h"
 #include "cafJsonSerializer.h"
+#include "cafJsonStreamWriter.h"
 #include "cafLogger.h"
 #include "cafObjectFactory.h"
+#include "cafParallelFor.h"
 
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace caffa
 {
@@ -43,7 +52,7 @@ void FieldIoCap<FieldType>::readFromJson( const json::value& jsonElement, const
             {
                 throw std::runtime_error( "Invalid CAFFA JSON: " + json::dump( jsonElement ) );
             }
-            typename FieldType::FieldDataType value = json::from_json<typename FieldType::FieldDataType>( jsonValue );
+            typename FieldType::FieldDataType value = valueFromJson( jsonValue );
             typedOwner()->setValue( value );
         }
         else // Support JSON objects with direct value instead of separate value entry
@@ -59,7 +68,7 @@ void FieldIoCap<FieldType>::readFromJson( const json::value& jsonElement, const
             }
             if ( !valueSet )
             {
-                typename FieldType::FieldDataType value = json::from_json<typename FieldType::FieldDataType>( jsonElement );
+                typename FieldType::FieldDataType value = valueFromJson( jsonElement );
                 typedOwner()->setValue( value );
             }
         }
@@ -84,11 +93,29 @@ void FieldIoCap<FieldType>::writeToJson( json::value& jsonElement, const JsonSer
 
     if ( serializer.serializationType() == JsonSerializer::SerializationType::DATA_FULL )
     {
-        jsonElement = json::to_json( typedOwner()->value() );
+        if constexpr ( JsonPackedArray::IsPackableVectorV<typename FieldType::FieldDataType> )
+        {
+            if ( serializer.packNumericArrays() || this->packNumericArrays() )
+            {
+                jsonElement = JsonPackedArray::pack( typedOwner()->value() );
+                return;
+            }
+        }
+        jsonElement = json::to_json( typedOwner()->value(), jsonElement.storage() );
     }
     else if ( serializer.serializationType() == JsonSerializer::SerializationType::SCHEMA )
     {
         json::object jsonSchema = JsonDataType<typename FieldType::FieldDataType>::jsonType();
+        if constexpr ( JsonPackedArray::IsPackableVectorV<typename FieldType::FieldDataType> )
+        {
+            // Packed arrays are written as objects, but plain arrays are still accepted when reading
+            if ( serializer.packNumericArrays() || this->packNumericArrays() )
+            {
+                json::object packedSchema;
+                packedSchema["oneOf"] = { std::move( jsonSchema ), JsonPackedArray::jsonSchema() };
+                jsonSchema            = std::move( packedSchema );
+            }
+        }
         if ( !typedOwner()->isReadable() && typedOwner()->isWritable() )
         {
             jsonSchema["writeOnly"] = true;
@@ -121,6 +148,115 @@ void FieldIoCap<FieldType>::writeToJson( json::value& jsonElement, const JsonSer
     CAFFA_TRACE( "Writing field to json " << typedOwner()->keyword() << "(" << typedOwner()->dataType() << ") = " );
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename FieldType>
+void FieldIoCap<FieldType>::writeToCbor( CborWriter& writer, const JsonSerializer& serializer ) const
+{
+    if constexpr ( Cbor::Value<typename FieldType::FieldDataType> )
+    {
+        if ( serializer.serializationType() == JsonSerializer::SerializationType::DATA_FULL )
+        {
+            this->assertValid();
+            writer.write( typedOwner()->value() );
+            return;
+        }
+    }
+    FieldIoCapability::writeToCbor( writer, serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// String fields also accept other values, stored as their JSON text, which is left to readFromJson
+//--------------------------------------------------------------------------------------------------
+template <typename FieldType>
+void FieldIoCap<FieldType>::readFromCbor( CborReader& reader, const JsonSerializer& serializer )
+{
+    using DataType = typename FieldType::FieldDataType;
+    if constexpr ( Cbor::Value<DataType> )
+    {
+        const bool isText = !std::is_same_v<DataType, std::string> || reader.peekMajorType() == Cbor::TEXT_STRING;
+        if ( serializer.serializationType() == JsonSerializer::SerializationType::DATA_FULL && isText &&
+             !reader.peekNull() )
+        {
+            this->assertValid();
+            typedOwner()->setValue( reader.read<DataType>() );
+            return;
+        }
+    }
+    FieldIoCapability::readFromCbor( reader, serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Accepts packed arrays for numeric vectors in addition to the plain JSON representation
+//--------------------------------------------------------------------------------------------------
+template <typename FieldType>
+typename FieldType::FieldDataType FieldIoCap<FieldType>::valueFromJson( const json::value& jsonValue )
+{
+    if constexpr ( JsonPackedArray::IsPackableVectorV<typename FieldType::FieldDataType> )
+    {
+        if ( JsonPackedArray::isPacked( jsonValue ) )
+        {
+            return JsonPackedArray::unpack<typename FieldType::FieldDataType::value_type>( jsonValue.get_object() );
+        }
+    }
+    return json::from_json<typename FieldType::FieldDataType>( jsonValue );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename FieldType>
+void FieldIoCap<FieldType>::copyFrom( const FieldHandle* source, const JsonSerializer& serializer )
+{
+    this->assertValid();
+
+    const auto* typedSource = dynamic_cast<const FieldType*>( source );
+    if ( !typedSource || serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL )
+    {
+        FieldIoCapability::copyFrom( source, serializer );
+        return;
+    }
+
+    // Null values are skipped, same as when reading JSON
+    if ( const auto* sourceCapability = typedSource->template capability<FieldIoCapability>();
+         sourceCapability && sourceCapability->writesNull( serializer ) )
+    {
+        return;
+    }
+
+    typedOwner()->setValue( typedSource->value() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename FieldType>
+bool FieldIoCap<FieldType>::writesNull( const JsonSerializer& serializer ) const
+{
+    this->assertValid();
+
+    using DataType = typename FieldType::FieldDataType;
+    if ( serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL )
+    {
+        return FieldIoCapability::writesNull( serializer );
+    }
+
+    if constexpr ( std::is_floating_point_v<DataType> )
+    {
+        return std::isnan( typedOwner()->value() );
+    }
+    else if constexpr ( std::is_arithmetic_v<DataType> || std::is_same_v<DataType, std::string> ||
+                        JsonPackedArray::IsPackableVectorV<DataType> )
+    {
+        return false;
+    }
+    else
+    {
+        return FieldIoCapability::writesNull( serializer );
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -189,31 +325,61 @@ void FieldIoCap<ChildField<DataType*>>::readFromJson( const json::value& jsonEle
         uuid = json::from_json<std::string>( it->value() );
     }
 
-    auto object = typedOwner()->object();
-    if ( object && !uuid.empty() && object->uuid() == uuid )
+    // Checked before looking at the current child, since that would load a child still pending from an earlier read
+    if ( serializer.lazyChildren() && serializer.objectFactory() )
     {
-        CAFFA_TRACE( "Had existing matching object! Overwriting field values!" );
+        // The JSON read from may be released before the child is accessed, so keep a copy on the heap
+        auto reader = std::make_shared<JsonSerializer>( serializer );
+        reader->setMemoryResource( {} );
+        typedOwner()->setObjectLoader(
+            [this, reader, className, jsonChild = json::object( jsonObject, json::storage_ptr() )]()
+            { return readNewChildFromJson( jsonChild, className, *reader ); } );
+        return;
     }
-    else
-    {
-        // Create a new object
-        auto objectFactory = serializer.objectFactory();
-
-        if ( !objectFactory )
-        {
-            CAFFA_ASSERT( false && "No object factory!" );
-            return;
-        }
 
-        object = std::dynamic_pointer_cast<DataType>( objectFactory->create( className ) );
-        if ( !object )
+    if ( auto object = typedOwner()->object(); object && !uuid.empty() && object->uuid() == uuid )
+    {
+        CAFFA_TRACE( "Had existing matching object! Overwriting field values!" );
+        if ( !ObjectHandle::matchesClassKeyword( className, object->classInheritanceStack() ) )
         {
+            // Error: Field contains different class type than in the JSON
             CAFFA_ERROR( "Unknown object type with class name: " << className << " found while reading the field : "
                                                                  << typedOwner()->keyword() );
+            CAFFA_ERROR( "                     Expected class name: " << object->classKeyword() );
             return;
         }
+        serializer.readObjectFromJson( object.get(), jsonObject );
+        return;
+    }
+
+    if ( !serializer.objectFactory() )
+    {
+        CAFFA_ASSERT( false && "No object factory!" );
+        return;
+    }
+
+    if ( auto object = readNewChildFromJson( jsonObject, className, serializer ); object )
+    {
         typedOwner()->setObject( object );
     }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Create and read a new child object. Returns nullptr if the class is unknown.
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+std::shared_ptr<DataType>
+    FieldIoCap<ChildField<DataType*>>::readNewChildFromJson( const json::object&   jsonObject,
+                                                             const std::string&    className,
+                                                             const JsonSerializer& serializer ) const
+{
+    auto object = std::dynamic_pointer_cast<DataType>( serializer.objectFactory()->create( className ) );
+    if ( !object )
+    {
+        CAFFA_ERROR( "Unknown object type with class name: " << className << " found while reading the field : "
+                                                             << typedOwner()->keyword() );
+        return nullptr;
+    }
 
     if ( !ObjectHandle::matchesClassKeyword( className, object->classInheritanceStack() ) )
     {
@@ -221,12 +387,12 @@ void FieldIoCap<ChildField<DataType*>>::readFromJson( const json::value& jsonEle
         CAFFA_ERROR( "Unknown object type with class name: " << className << " found while reading the field : "
                                                              << typedOwner()->keyword() );
         CAFFA_ERROR( "                     Expected class name: " << object->classKeyword() );
-
-        return;
+        return nullptr;
     }
 
     // Everything seems ok, so read the contents of the object:
     serializer.readObjectFromJson( object.get(), jsonObject );
+    return object;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -234,12 +400,23 @@ void FieldIoCap<ChildField<DataType*>>::readFromJson( const json::value& jsonEle
 //--------------------------------------------------------------------------------------------------
 template <typename DataType>
 void FieldIoCap<ChildField<DataType*>>::writeToJson( json::value& jsonElement, const JsonSerializer& serializer ) const
+{
+    writeToJson( jsonElement, serializer, JsonSerializationContext() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildField<DataType*>>::writeToJson( json::value&                    jsonElement,
+                                                     const JsonSerializer&           serializer,
+                                                     const JsonSerializationContext& context ) const
 {
     if ( auto object = typedOwner()->object(); object )
     {
-        json::object jsonObject;
-        serializer.writeObjectToJson( object.get(), jsonObject );
-        jsonElement = jsonObject;
+        json::object jsonObject( jsonElement.storage() );
+        serializer.writeObjectToJson( object.get(), jsonObject, context );
+        jsonElement = std::move( jsonObject );
     }
 
     if ( serializer.serializationType() == JsonSerializer::SerializationType::SCHEMA )
@@ -261,6 +438,66 @@ void FieldIoCap<ChildField<DataType*>>::writeToJson( json::value& jsonElement, c
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildField<DataType*>>::writeToStream( JsonStreamWriter&               writer,
+                                                       const JsonSerializer&           serializer,
+                                                       const JsonSerializationContext& context ) const
+{
+    if ( serializer.serializationType() == JsonSerializer::SerializationType::SCHEMA )
+    {
+        FieldIoCapability::writeToStream( writer, serializer, context );
+        return;
+    }
+
+    if ( auto object = typedOwner()->object(); object )
+    {
+        writer.key( typedOwner()->keyword() );
+        serializer.writeObjectToStream( object.get(), writer, context );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildField<DataType*>>::copyFrom( const FieldHandle* source, const JsonSerializer& serializer )
+{
+    const auto* sourceField = dynamic_cast<const ChildFieldBaseHandle*>( source );
+    if ( !sourceField || serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL )
+    {
+        FieldIoCapability::copyFrom( source, serializer );
+        return;
+    }
+
+    // An empty source is skipped, same as a null value in JSON
+    auto sourceObjects = sourceField->childObjects();
+    if ( sourceObjects.empty() || !sourceObjects.front() ) return;
+
+    auto object = std::dynamic_pointer_cast<DataType>( serializer.copyObject( sourceObjects.front().get() ) );
+    if ( !object )
+    {
+        CAFFA_ERROR( "Unknown object type with class name: " << sourceObjects.front()->classKeyword()
+                                                             << " found while copying the field : "
+                                                             << typedOwner()->keyword() );
+        return;
+    }
+    typedOwner()->setObject( object );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+bool FieldIoCap<ChildField<DataType*>>::writesNull( const JsonSerializer& serializer ) const
+{
+    if ( serializer.serializationType() == JsonSerializer::SerializationType::SCHEMA ) return false;
+
+    return !typedOwner()->object();
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -276,82 +513,244 @@ json::object FieldIoCap<ChildField<DataType*>>::jsonType() const
 template <typename DataType>
 void FieldIoCap<ChildArrayField<DataType*>>::readFromJson( const json::value& jsonElement, const JsonSerializer& serializer )
 {
-    typedOwner()->clear();
-
     CAFFA_TRACE( "Writing " << json::dump( jsonElement ) << " to ChildArrayField " << typedOwner()->keyword() );
 
-    json::array jsonArray;
-    if ( jsonElement.is_array() )
+    const json::array* jsonArray = jsonElement.if_array();
+    if ( const auto* jsonObject = jsonElement.if_object(); jsonObject )
     {
-        jsonArray = jsonElement.get_array();
+        if ( const auto it = jsonObject->find( "value" ); it != jsonObject->end() )
+        {
+            jsonArray = it->value().if_array();
+        }
     }
-    else if ( const auto* jsonObject = jsonElement.if_object(); jsonObject )
+
+    if ( jsonArray && serializer.reconcileChildren() && serializer.objectFactory() )
     {
-        if ( const auto it = jsonObject->find( "value" ); it != jsonObject->end() && it->value().is_array() )
+        // Matched children are read in place and only the children from the first difference on are removed and
+        // added again, so reading an unchanged array leaves the field untouched
+        if ( auto existingChildren = matchExistingChildren( *jsonArray ); !existingChildren.empty() )
         {
-            jsonArray = it->value().get_array();
+            updateChildren( readChildrenFromJson( *jsonArray, serializer, std::move( existingChildren ) ) );
+            return;
         }
     }
 
-    auto objectFactory = serializer.objectFactory();
+    typedOwner()->clear();
+
+    if ( !jsonArray ) return;
 
-    if ( !objectFactory )
+    if ( !serializer.objectFactory() )
     {
         CAFFA_ASSERT( false && "No object factory!" );
         return;
     }
 
-    for ( const auto& jsonEntry : jsonArray )
+    if ( serializer.lazyChildren() && !jsonArray->empty() )
     {
-        const auto* jsonObject = jsonEntry.if_object();
+        // The JSON read from may be released before the children are accessed, so keep a copy on the heap
+        auto reader = std::make_shared<JsonSerializer>( serializer );
+        reader->setMemoryResource( {} );
+        typedOwner()->setObjectsLoader( [this, reader, jsonChildren = json::array( *jsonArray, json::storage_ptr() )]()
+                                        { return readChildrenFromJson( jsonChildren, *reader ); } );
+        return;
+    }
+
+    auto objects = readChildrenFromJson( *jsonArray, serializer );
+
+    CAFFA_TRACE( "Inserting " << objects.size() << " objects into " << typedOwner()->keyword() );
+    typedOwner()->push_back_objs( std::move( objects ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Find the current children with the same uuid and class as the entries in a JSON array.
+/// Returns one child or nullptr per entry, or an empty list if no children match.
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+std::vector<std::shared_ptr<ObjectHandle>>
+    FieldIoCap<ChildArrayField<DataType*>>::matchExistingChildren( const json::array& jsonArray ) const
+{
+    std::unordered_map<std::string_view, std::shared_ptr<ObjectHandle>> childrenByUuid;
+    for ( auto& child : typedOwner()->objects() )
+    {
+        if ( child && !child->uuid().empty() ) childrenByUuid.emplace( child->uuid(), std::move( child ) );
+    }
+    if ( childrenByUuid.empty() ) return {};
+
+    std::vector<std::shared_ptr<ObjectHandle>> matches( jsonArray.size() );
+
+    bool anyMatch = false;
+    for ( size_t i = 0; i < jsonArray.size(); ++i )
+    {
+        const auto* jsonObject = jsonArray[i].if_object();
         if ( !jsonObject ) continue;
 
-        auto classNameElement = jsonObject->find( "keyword" );
-        if ( classNameElement == jsonObject->end() )
+        const auto* uuid = jsonObject->if_contains( "uuid" );
+        if ( !uuid || !uuid->is_string() ) continue;
+
+        const auto* className = jsonObject->if_contains( "keyword" );
+        if ( !className ) className = jsonObject->if_contains( "class" );
+        if ( !className || !className->is_string() ) continue;
+
+        const auto& uuidString = uuid->get_string();
+        auto        it         = childrenByUuid.find( std::string_view( uuidString.data(), uuidString.size() ) );
+        if ( it == childrenByUuid.end() ) continue;
+
+        // A child of another class is replaced by a new one
+        const auto& classString = className->get_string();
+        if ( !ObjectHandle::matchesClassKeyword( std::string_view( classString.data(), classString.size() ),
+                                                 it->second->classInheritanceStack() ) )
         {
-            classNameElement = jsonObject->find( "class" );
+            continue;
         }
-        if ( classNameElement == jsonObject->end() )
+
+        // Each child is only read into once, so entries with a repeated uuid get new children
+        matches[i] = std::move( it->second );
+        childrenByUuid.erase( it );
+        anyMatch = true;
+    }
+
+    if ( !anyMatch ) return {};
+    return matches;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Make the children of the field the given objects. The children up to the first difference are left in place and
+/// the rest are removed from the back and added again in their new order in one go, so the time taken is linear.
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildArrayField<DataType*>>::updateChildren(
+    const std::vector<std::shared_ptr<ObjectHandle>>& objects ) const
+{
+    auto field   = typedOwner();
+    auto current = field->childObjects();
+
+    const auto [firstChanged, firstNew] =
+        std::mismatch( current.begin(), current.end(), objects.begin(), objects.end() );
+    if ( firstChanged == current.end() && firstNew == objects.end() ) return;
+
+    const size_t keptCount = static_cast<size_t>( firstChanged - current.begin() );
+    for ( size_t i = current.size(); i-- > keptCount; )
+    {
+        field->erase( i );
+    }
+    if ( firstNew != objects.end() )
+    {
+        field->push_back_objs( std::vector<std::shared_ptr<ObjectHandle>>( firstNew, objects.end() ) );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Create and read the children in a JSON array, in parallel if the array is large enough.
+/// Entries with an existing child are read into that child instead. Entries which should be skipped are left out.
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+std::vector<std::shared_ptr<ObjectHandle>> FieldIoCap<ChildArrayField<DataType*>>::readChildrenFromJson(
+    const json::array&                         jsonArray,
+    const JsonSerializer&                      serializer,
+    std::vector<std::shared_ptr<ObjectHandle>> existingChildren /* = {} */ ) const
+{
+    auto objects = std::move( existingChildren );
+    objects.resize( jsonArray.size() );
+
+    const size_t threshold = serializer.parallelReadThreshold();
+    if ( threshold > 0u && jsonArray.size() >= threshold )
+    {
+        // Use a few chunks per thread, since the children may differ a lot in size
+        const size_t grainSize = std::max( jsonArray.size() / ( parallelThreadCount() * 8u ), size_t( 1u ) );
+        parallelFor( jsonArray.size(),
+                     grainSize,
+                     [this, &jsonArray, &objects, &serializer]( size_t begin, size_t end )
+                     {
+                         for ( size_t i = begin; i < end; ++i )
+                         {
+                             objects[i] = readChildFromJson( jsonArray[i], serializer, std::move( objects[i] ) );
+                         }
+                     } );
+    }
+    else
+    {
+        for ( size_t i = 0; i < jsonArray.size(); ++i )
         {
-            throw std::runtime_error( "Invalid JSON. Could not find keyword tag" );
+            objects[i] = readChildFromJson( jsonArray[i], serializer, std::move( objects[i] ) );
         }
+    }
 
-        const auto className = json::from_json<std::string>( classNameElement->value() );
+    std::erase( objects, nullptr );
+    return objects;
+}
 
-        std::shared_ptr<ObjectHandle> object = objectFactory->create( className );
+//--------------------------------------------------------------------------------------------------
+/// Read a single child object, into the existing child if there is one and otherwise into a new object.
+/// Returns nullptr for entries which should be skipped.
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+std::shared_ptr<ObjectHandle>
+    FieldIoCap<ChildArrayField<DataType*>>::readChildFromJson( const json::value&            jsonEntry,
+                                                               const JsonSerializer&         serializer,
+                                                               std::shared_ptr<ObjectHandle> existingChild ) const
+{
+    const auto* jsonObject = jsonEntry.if_object();
+    if ( !jsonObject ) return nullptr;
 
-        if ( !object )
-        {
-            // Warning: Unknown className read
-            // Skip to corresponding end element
+    if ( existingChild )
+    {
+        serializer.readObjectFromJson( existingChild.get(), *jsonObject );
+        return existingChild;
+    }
 
-            CAFFA_ERROR( "Warning: Unknown object type with class name: "
-                         << className << " found while reading the field : " << typedOwner()->keyword() );
+    auto classNameElement = jsonObject->find( "keyword" );
+    if ( classNameElement == jsonObject->end() )
+    {
+        classNameElement = jsonObject->find( "class" );
+    }
+    if ( classNameElement == jsonObject->end() )
+    {
+        throw std::runtime_error( "Invalid JSON. Could not find keyword tag" );
+    }
 
-            continue;
-        }
+    const auto className = json::from_json<std::string>( classNameElement->value() );
 
-        if ( !ObjectHandle::matchesClassKeyword( className, object->classInheritanceStack() ) )
-        {
-            CAFFA_ASSERT( false ); // There is an inconsistency in the factory. It creates objects of type not
-                                   // matching the ClassKeyword
+    std::shared_ptr<ObjectHandle> object = serializer.objectFactory()->create( className );
 
-            continue;
-        }
+    if ( !object )
+    {
+        // Warning: Unknown className read
+        // Skip to corresponding end element
 
-        serializer.readObjectFromJson( object.get(), *jsonObject );
+        CAFFA_ERROR( "Warning: Unknown object type with class name: "
+                     << className << " found while reading the field : " << typedOwner()->keyword() );
 
-        size_t currentSize = typedOwner()->size();
-        CAFFA_TRACE( "Inserting new object into " << typedOwner()->keyword() << " at position " << currentSize );
+        return nullptr;
+    }
+
+    if ( !ObjectHandle::matchesClassKeyword( className, object->classInheritanceStack() ) )
+    {
+        CAFFA_ASSERT( false ); // There is an inconsistency in the factory. It creates objects of type not
+                               // matching the ClassKeyword
 
-        typedOwner()->insertAt( currentSize, object );
+        return nullptr;
     }
+
+    serializer.readObjectFromJson( object.get(), *jsonObject );
+    return object;
 }
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
 template <typename DataType>
 void FieldIoCap<ChildArrayField<DataType*>>::writeToJson( json::value& jsonElement, const JsonSerializer& serializer ) const
+{
+    writeToJson( jsonElement, serializer, JsonSerializationContext() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildArrayField<DataType*>>::writeToJson( json::value&                    jsonElement,
+                                                          const JsonSerializer&           serializer,
+                                                          const JsonSerializationContext& context ) const
 {
     if ( serializer.serializationType() == JsonSerializer::SerializationType::SCHEMA )
     {
@@ -373,21 +772,140 @@ void FieldIoCap<ChildArrayField<DataType*>>::writeToJson( json::value& jsonEleme
     else if ( serializer.serializationType() == JsonSerializer::SerializationType::DATA_FULL ||
               serializer.serializationType() == JsonSerializer::SerializationType::DATA_SKELETON )
     {
-        json::array jsonArray;
+        auto jsonObjects = serializer.writeObjectsToJson( nonNullChildren(), context, jsonElement.storage() );
+
+        json::array jsonArray( jsonElement.storage() );
+        jsonArray.reserve( jsonObjects.size() );
+        for ( auto& jsonObject : jsonObjects )
+        {
+            jsonArray.emplace_back( std::move( jsonObject ) );
+        }
+        jsonElement = std::move( jsonArray );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildArrayField<DataType*>>::writeToStream( JsonStreamWriter&               writer,
+                                                            const JsonSerializer&           serializer,
+                                                            const JsonSerializationContext& context ) const
+{
+    if ( serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL &&
+         serializer.serializationType() != JsonSerializer::SerializationType::DATA_SKELETON )
+    {
+        FieldIoCapability::writeToStream( writer, serializer, context );
+        return;
+    }
 
+    writer.key( typedOwner()->keyword() );
+    writer.beginArray();
+    const size_t grainSize = serializer.parallelWriteGrainSize();
+    if ( grainSize > 0u && typedOwner()->size() > grainSize )
+    {
+        // Write a window of chunks at a time in parallel, each chunk into its own text buffer, so only one window is
+        // held in memory. The buffers are reused by the following windows.
+        const auto               children   = nonNullChildren();
+        const size_t             windowSize = grainSize * parallelThreadCount();
+        std::vector<std::string> chunkTexts( parallelThreadCount() );
+        for ( size_t windowStart = 0; windowStart < children.size(); windowStart += windowSize )
+        {
+            const size_t windowLength = std::min( windowSize, children.size() - windowStart );
+            const size_t chunkCount   = ( windowLength + grainSize - 1u ) / grainSize;
+            parallelFor( chunkCount,
+                         1u,
+                         [&]( size_t beginChunk, size_t endChunk )
+                         {
+                             for ( size_t chunk = beginChunk; chunk < endChunk; ++chunk )
+                             {
+                                 const size_t begin = windowStart + chunk * grainSize;
+                                 const size_t end   = std::min( begin + grainSize, windowStart + windowLength );
+
+                                 chunkTexts[chunk].clear();
+                                 JsonStreamWriter chunkWriter( chunkTexts[chunk], writer );
+                                 for ( size_t i = begin; i < end; ++i )
+                                 {
+                                     serializer.writeObjectToStream( children[i].get(), chunkWriter, context );
+                                 }
+                             }
+                         } );
+            for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+            {
+                writer.appendElements( chunkTexts[chunk] );
+            }
+        }
+    }
+    else
+    {
         for ( size_t i = 0; i < typedOwner()->size(); ++i )
         {
             std::shared_ptr<ObjectHandle> object = typedOwner()->at( i );
             if ( !object ) continue;
 
-            json::object jsonValue;
-            serializer.writeObjectToJson( object.get(), jsonValue );
-            jsonArray.push_back( jsonValue );
+            serializer.writeObjectToStream( object.get(), writer, context );
+        }
+    }
+    writer.endArray();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+std::vector<std::shared_ptr<ObjectHandle>> FieldIoCap<ChildArrayField<DataType*>>::nonNullChildren() const
+{
+    std::vector<std::shared_ptr<ObjectHandle>> children;
+    children.reserve( typedOwner()->size() );
+    for ( size_t i = 0; i < typedOwner()->size(); ++i )
+    {
+        if ( auto object = typedOwner()->at( i ); object )
+        {
+            children.push_back( std::move( object ) );
+        }
+    }
+    return children;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+void FieldIoCap<ChildArrayField<DataType*>>::copyFrom( const FieldHandle* source, const JsonSerializer& serializer )
+{
+    const auto* sourceField = dynamic_cast<const ChildArrayFieldHandle*>( source );
+    if ( !sourceField || serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL )
+    {
+        FieldIoCapability::copyFrom( source, serializer );
+        return;
+    }
+
+    typedOwner()->clear();
+
+    for ( const auto& sourceObject : sourceField->childObjects() )
+    {
+        if ( !sourceObject ) continue;
+
+        auto object = std::dynamic_pointer_cast<DataType>( serializer.copyObject( sourceObject.get() ) );
+        if ( !object )
+        {
+            CAFFA_ERROR( "Warning: Unknown object type with class name: "
+                         << sourceObject->classKeyword() << " found while copying the field : " << typedOwner()->keyword() );
+            continue;
         }
-        jsonElement = jsonArray;
+        typedOwner()->push_back( object );
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename DataType>
+bool FieldIoCap<ChildArrayField<DataType*>>::writesNull( const JsonSerializer& serializer ) const
+{
+    return false;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
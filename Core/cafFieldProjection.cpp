@@ -0,0 +1,164 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafFieldProjection.h"
+
+#include <stdexcept>
+
+using namespace caffa;
+
+namespace
+{
+constexpr std::string_view WHITESPACE = " \t\n\r";
+
+std::string_view trimmed( std::string_view text )
+{
+    const auto begin = text.find_first_not_of( WHITESPACE );
+    if ( begin == std::string_view::npos ) return {};
+    return text.substr( begin, text.find_last_not_of( WHITESPACE ) - begin + 1u );
+}
+
+std::vector<std::string> splitPath( const std::string& path )
+{
+    std::vector<std::string> keywords;
+
+    std::string_view remaining = path;
+    while ( true )
+    {
+        const auto       separator = remaining.find( '.' );
+        std::string_view keyword   = remaining.substr( 0u, separator );
+        if ( keyword.ends_with( "[*]" ) )
+        {
+            keyword.remove_suffix( 3u );
+        }
+        if ( keyword.empty() || keyword.find_first_of( "[]" ) != std::string_view::npos )
+        {
+            throw std::runtime_error( "Invalid field path '" + path + "'" );
+        }
+        keywords.emplace_back( keyword );
+
+        if ( separator == std::string_view::npos ) break;
+        remaining.remove_prefix( separator + 1u );
+    }
+    return keywords;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const FieldProjection::Node* FieldProjection::Node::field( std::string_view keyword ) const
+{
+    if ( auto it = m_fields.find( keyword ); it != m_fields.end() )
+    {
+        return it->second.get();
+    }
+    return m_anyField.get();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FieldProjection::Node* FieldProjection::Node::addField( const std::string& keyword )
+{
+    auto& node = keyword == "*" ? m_anyField : m_fields[keyword];
+    if ( !node ) node = std::make_unique<Node>();
+    return node.get();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Add everything selected by another node to this one
+//--------------------------------------------------------------------------------------------------
+void FieldProjection::Node::merge( const Node& other )
+{
+    m_selectsAll = m_selectsAll || other.m_selectsAll;
+    for ( const auto& [keyword, node] : other.m_fields )
+    {
+        addField( keyword )->merge( *node );
+    }
+    if ( other.m_anyField )
+    {
+        addField( "*" )->merge( *other.m_anyField );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// A field matching both its own keyword and a wildcard gets everything selected by either path.
+/// Merging the wildcard into the named fields up front lets a lookup stop at the first match.
+//--------------------------------------------------------------------------------------------------
+void FieldProjection::Node::resolveWildcards()
+{
+    for ( auto& [keyword, node] : m_fields )
+    {
+        if ( m_anyField ) node->merge( *m_anyField );
+        node->resolveWildcards();
+    }
+    if ( m_anyField ) m_anyField->resolveWildcards();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FieldProjection::FieldProjection( std::vector<std::string> paths )
+    : m_paths( std::move( paths ) )
+    , m_root( std::make_unique<Node>() )
+{
+    for ( const auto& path : m_paths )
+    {
+        Node* node = m_root.get();
+        for ( const auto& keyword : splitPath( path ) )
+        {
+            node = node->addField( keyword );
+        }
+        node->m_selectsAll = true;
+    }
+    m_root->resolveWildcards();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FieldProjection FieldProjection::parse( std::string_view paths )
+{
+    std::vector<std::string> pathList;
+    while ( true )
+    {
+        const auto separator = paths.find( ',' );
+        pathList.emplace_back( trimmed( paths.substr( 0u, separator ) ) );
+
+        if ( separator == std::string_view::npos ) break;
+        paths.remove_prefix( separator + 1u );
+    }
+    return FieldProjection( std::move( pathList ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const FieldProjection::Node& FieldProjection::root() const
+{
+    return *m_root;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const std::vector<std::string>& FieldProjection::paths() const
+{
+    return m_paths;
+}
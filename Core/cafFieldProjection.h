@@ -0,0 +1,106 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caffa
+{
+/**
+ * A set of field paths selecting the parts of an object tree to write.
+ *
+ * A path is a list of field keywords separated by dots, like "Children[*].Name". The optional "[*]" after a child
+ * array field is only there for readability, since a path through a child array applies to all of its elements.
+ * A "*" matches any field. A path ending at a field selects all of the field, including every object below it.
+ * The class keyword and uuid of the written objects are always included.
+ *
+ * The paths are compiled once into a tree keyed by field keyword, so whether to write a field, and what to write
+ * below it, is found with a single lookup per field.
+ */
+class FieldProjection
+{
+public:
+    /**
+     * The fields selected for the objects at one position in the tree
+     */
+    class Node
+    {
+    public:
+        /**
+         * Find what is selected below a field of the objects written with this node
+         * @param keyword The field keyword
+         * @return The node for the objects held by the field or nullptr if the field is not selected
+         */
+        [[nodiscard]] const Node* field( std::string_view keyword ) const;
+
+        /**
+         * Check if everything below this node is selected
+         * @return true if all fields are selected all the way down
+         */
+        [[nodiscard]] bool selectsAll() const { return m_selectsAll; }
+
+    private:
+        friend class FieldProjection;
+
+        Node* addField( const std::string& keyword );
+        void  merge( const Node& other );
+        void  resolveWildcards();
+
+        bool                                                      m_selectsAll = false;
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> m_fields;
+        std::unique_ptr<Node>                                     m_anyField;
+    };
+
+    /**
+     * Compile a projection. Throws std::runtime_error on invalid paths.
+     * @param paths The field paths to select
+     */
+    explicit FieldProjection( std::vector<std::string> paths );
+
+    /**
+     * Compile a projection from a comma separated list of paths, like "Children[*].Name,Children[*].Status".
+     * Throws std::runtime_error on invalid paths.
+     * @param paths The comma separated field paths
+     * @return The compiled projection
+     */
+    [[nodiscard]] static FieldProjection parse( std::string_view paths );
+
+    /**
+     * Get the node selecting the fields of the object a write starts from
+     * @return The root node
+     */
+    [[nodiscard]] const Node& root() const;
+
+    /**
+     * Get the paths the projection was compiled from
+     * @return The field paths
+     */
+    [[nodiscard]] const std::vector<std::string>& paths() const;
+
+private:
+    std::vector<std::string> m_paths;
+    std::unique_ptr<Node>    m_root;
+};
+
+} // namespace caffa
@@ -18,51 +18,131 @@
 //
 #include "cafJsonDefinitions.h"
 
-#include "cafStringTools.h"
-
 #include "cafLogger.h"
 
 #include <boost/json.hpp>
 
-#include <chrono>
 #include <string>
 
 namespace caffa::json
 {
-bool isParsableJson( const std::string& str )
+namespace
 {
-    static const std::regex jsonNumber( R"(^-?(0|[1-9]\d*)(\.\d+)?([eE][+-]?\d+)?$)" );
-    auto                    s = caffa::StringTools::trim( str );
+    constexpr std::string_view WHITESPACE = " \t\n\r\f\v";
+
+    std::string_view trimmed( std::string_view text )
+    {
+        const auto begin = text.find_first_not_of( WHITESPACE );
+        if ( begin == std::string_view::npos ) return {};
+        const auto end = text.find_last_not_of( WHITESPACE );
+        return text.substr( begin, end - begin + 1u );
+    }
+
+    bool isDigit( char c )
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * Matches -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+     */
+    bool isJsonNumber( std::string_view text )
+    {
+        size_t i      = 0u;
+        auto   digits = [&text, &i]()
+        {
+            const size_t start = i;
+            while ( i < text.size() && isDigit( text[i] ) )
+            {
+                ++i;
+            }
+            return i > start;
+        };
+
+        if ( i < text.size() && text[i] == '-' ) ++i;
+
+        if ( i < text.size() && text[i] == '0' )
+            ++i;
+        else if ( !digits() )
+            return false;
+
+        if ( i < text.size() && text[i] == '.' )
+        {
+            ++i;
+            if ( !digits() ) return false;
+        }
+
+        if ( i < text.size() && ( text[i] == 'e' || text[i] == 'E' ) )
+        {
+            ++i;
+            if ( i < text.size() && ( text[i] == '+' || text[i] == '-' ) ) ++i;
+            if ( !digits() ) return false;
+        }
+        return i == text.size();
+    }
+
+    bool isEnclosedBy( std::string_view text, char first, char last )
+    {
+        return text.size() >= 2u && text.front() == first && text.back() == last;
+    }
+
+} // namespace
+
+bool isParsableJson( std::string_view text )
+{
+    const auto s = trimmed( text );
     if ( s.empty() ) return false;
-    if ( s == "null" || s == "true" || s == "false" ) return true;
-    if ( s.front() == '"' && s.back() == '"' && s.size() >= 2 ) return true;
-    if ( s.front() == '{' && s.back() == '}' && s.size() >= 2 ) return true;
-    if ( s.front() == '[' && s.back() == ']' && s.size() >= 2 ) return true;
-    if ( std::regex_match( s, jsonNumber ) ) return true;
-    return false;
+
+    switch ( s.front() )
+    {
+        case '"':
+            return isEnclosedBy( s, '"', '"' );
+        case '{':
+            return isEnclosedBy( s, '{', '}' );
+        case '[':
+            return isEnclosedBy( s, '[', ']' );
+        case 'n':
+            return s == "null";
+        case 't':
+            return s == "true";
+        case 'f':
+            return s == "false";
+        default:
+            return isJsonNumber( s );
+    }
 }
 
-value parse( const std::string& string )
+value parse( std::string_view text, ParseError& error, storage_ptr storage /* = {} */ )
 {
-    boost::system::error_code ec;
-    value                     jsonValue;
-    if ( isParsableJson( string ) )
+    if ( !isParsableJson( text ) )
     {
-        // Safe to parse
-        jsonValue = boost::json::parse( string, ec );
+        // A bare string becomes a JSON string without the surrounding whitespace
+        const auto s = trimmed( text );
+        return value( boost::json::string_view( s.data(), s.size() ), std::move( storage ) );
     }
-    else
-    {
-        // Create trimmed and quoted string
-        auto sanitise = []( const std::string& str ) { return "\"" + caffa::StringTools::trim( str ) + "\""; };
 
-        jsonValue = boost::json::parse( sanitise( string ), ec );
-    }
-    if ( ec != boost::system::errc::success )
+    boost::json::parser parser;
+    parser.reset( std::move( storage ) );
+
+    boost::system::error_code ec;
+    const size_t              consumed = parser.write( text.data(), text.size(), ec );
+    if ( ec )
     {
-        CAFFA_ERROR( "Failed to parse " << string << ": " << ec.message() );
+        error.offset  = consumed;
+        error.message = ec.message();
         return value{};
     }
+    return parser.release();
+}
+
+value parse( std::string_view text, storage_ptr storage /* = {} */ )
+{
+    ParseError error;
+    auto       jsonValue = parse( text, error, std::move( storage ) );
+    if ( !error.message.empty() )
+    {
+        CAFFA_ERROR( "Failed to parse " << text << " at byte " << error.offset << ": " << error.message );
+    }
     return jsonValue;
 }
 
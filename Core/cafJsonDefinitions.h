@@ -21,15 +21,47 @@
 #include <boost/json.hpp>
 
 #include <string>
+#include <string_view>
 
 namespace caffa::json
 {
-using array  = boost::json::array;
-using object = boost::json::object;
-using value  = boost::json::value;
+using array       = boost::json::array;
+using object      = boost::json::object;
+using value       = boost::json::value;
+using storage_ptr = boost::json::storage_ptr;
 
-bool        isParsableJson( const std::string& str );
-value       parse( const std::string& string );
+/**
+ * Position and description of an error in JSON text
+ */
+struct ParseError
+{
+    size_t      offset = 0u; ///< Byte offset into the text where parsing failed
+    std::string message;
+};
+
+/**
+ * Check whether the text, ignoring surrounding whitespace, is shaped like a JSON value rather than a bare string.
+ * Only the outer shape is checked, so text which is shaped like JSON may still be invalid.
+ */
+bool isParsableJson( std::string_view text );
+
+/**
+ * Parse JSON text. Text which is not shaped like JSON is a bare string and is returned as a JSON string
+ * without the surrounding whitespace.
+ * @param text The text to parse
+ * @param error Set to the position and cause of the failure if the text is invalid JSON
+ * @param storage The memory resource the value is allocated from
+ * @return The parsed value or null on failure
+ */
+value parse( std::string_view text, ParseError& error, storage_ptr storage = {} );
+
+/**
+ * Parse JSON text like above, but log the error on failure
+ * @param text The text to parse
+ * @param storage The memory resource the value is allocated from
+ * @return The parsed value or null on failure
+ */
+value       parse( std::string_view text, storage_ptr storage = {} );
 std::string dump( const value& value );
 
 template <typename T>
@@ -40,9 +72,9 @@ T from_json( const value& value )
 }
 
 template <typename T>
-value to_json( T&& typedValue )
+value to_json( T&& typedValue, storage_ptr storage = {} )
 {
-    return boost::json::value_from<T>( static_cast<T&&>( typedValue ) );
+    return boost::json::value_from<T>( static_cast<T&&>( typedValue ), std::move( storage ) );
 }
 
 } // namespace caffa::json
@@ -0,0 +1,465 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonDeltaSerializer.h"
+
+#include "cafAssert.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafChildFieldHandle.h"
+#include "cafFieldHandle.h"
+#include "cafFieldIoCapability.h"
+#include "cafLogger.h"
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace caffa;
+
+namespace
+{
+//--------------------------------------------------------------------------------------------------
+/// Collect every object in the tree by UUID, along with the child field holding each object
+//--------------------------------------------------------------------------------------------------
+void collectObjects( ObjectHandle*                                      object,
+                     const FieldHandle*                                 parentField,
+                     std::map<std::string, ObjectHandle*>&              objects,
+                     std::map<const ObjectHandle*, const FieldHandle*>& parentFields )
+{
+    objects[object->uuid()] = object;
+    parentFields[object]    = parentField;
+    for ( auto field : object->fields() )
+    {
+        if ( auto childField = dynamic_cast<ChildFieldBaseHandle*>( field ); childField )
+        {
+            for ( const auto& child : childField->childObjects() )
+            {
+                if ( child ) collectObjects( child.get(), field, objects, parentFields );
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Find the first child field the object sits under which replaces the object or one of its ancestors, if any.
+/// Child fields in replacedFields replace all their children and those in keptChildren all but the kept ones.
+//--------------------------------------------------------------------------------------------------
+const FieldHandle*
+    findReplacingField( const ObjectHandle*                                                object,
+                        const std::set<const FieldHandle*>&                                replacedFields,
+                        const std::map<const FieldHandle*, std::set<const ObjectHandle*>>& keptChildren,
+                        const std::map<const ObjectHandle*, const FieldHandle*>&           parentFields )
+{
+    auto it = parentFields.find( object );
+    while ( it != parentFields.end() && it->second )
+    {
+        const auto [child, field] = *it;
+        if ( replacedFields.contains( field ) ) return field;
+        auto keptIt = keptChildren.find( field );
+        if ( keptIt != keptChildren.end() && !keptIt->second.contains( child ) ) return field;
+        it = parentFields.find( field->ownerObject() );
+    }
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Children of a child array field written with only their class keyword and uuid are kept as they are
+//--------------------------------------------------------------------------------------------------
+bool isKeptChild( const json::object& jsonChild )
+{
+    for ( const auto& [keyword, value] : jsonChild )
+    {
+        if ( keyword != "keyword" && keyword != "class" && keyword != "uuid" ) return false;
+    }
+    return jsonChild.contains( "uuid" );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Find the children a child array field keeps in a delta. Throws if a kept child is not a child of the field.
+//--------------------------------------------------------------------------------------------------
+std::set<const ObjectHandle*> findKeptChildren( const FieldHandle*                                       field,
+                                                const json::array&                                       jsonChildren,
+                                                const std::map<std::string, ObjectHandle*>&              objectsByUuid,
+                                                const std::map<const ObjectHandle*, const FieldHandle*>& parentFields )
+{
+    std::set<const ObjectHandle*> kept;
+    for ( const auto& jsonChild : jsonChildren )
+    {
+        const auto* jsonObject = jsonChild.if_object();
+        if ( !jsonObject || !isKeptChild( *jsonObject ) ) continue;
+
+        const auto* uuid      = jsonObject->if_contains( "uuid" );
+        const auto* className = jsonObject->if_contains( "keyword" );
+        if ( !className ) className = jsonObject->if_contains( "class" );
+        if ( !uuid->is_string() || !className || !className->is_string() )
+        {
+            throw std::runtime_error( "Delta has an invalid child in the field " + field->keyword() + " of " +
+                                      field->ownerObject()->uuid() );
+        }
+
+        const auto uuidString = json::from_json<std::string>( *uuid );
+        auto       it         = objectsByUuid.find( uuidString );
+        if ( it == objectsByUuid.end() || parentFields.at( it->second ) != field )
+        {
+            throw std::runtime_error( "Delta keeps " + uuidString + " which is not a child in the field " +
+                                      field->keyword() + " of " + field->ownerObject()->uuid() );
+        }
+        if ( !ObjectHandle::matchesClassKeyword( json::from_json<std::string>( *className ),
+                                                 it->second->classInheritanceStack() ) )
+        {
+            throw std::runtime_error( "Delta keeps the child " + uuidString + " with the wrong class keyword" );
+        }
+        if ( !kept.insert( it->second ).second )
+        {
+            throw std::runtime_error( "Delta keeps the child " + uuidString + " more than once" );
+        }
+    }
+    return kept;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonDeltaSerializer::JsonDeltaSerializer( ObjectFactory* objectFactory /* = nullptr */ )
+    : m_jsonSerializer( objectFactory )
+    , m_writeVolatileFields( false )
+{
+    m_jsonSerializer.setSerializationType( JsonSerializer::SerializationType::DATA_FULL );
+    // Child arrays are applied element by element, reading kept children in place
+    m_jsonSerializer.setReconcileChildren( true );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonDeltaSerializer& JsonDeltaSerializer::setFieldSelector( FieldSelector fieldSelector )
+{
+    m_jsonSerializer.setFieldSelector( std::move( fieldSelector ) );
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonDeltaSerializer& JsonDeltaSerializer::setWriteVolatileFields( bool writeVolatileFields )
+{
+    m_writeVolatileFields = writeVolatileFields;
+    return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ObjectFactory* JsonDeltaSerializer::objectFactory() const
+{
+    return m_jsonSerializer.objectFactory();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonDeltaSerializer::FieldSelector JsonDeltaSerializer::fieldSelector() const
+{
+    return m_jsonSerializer.fieldSelector();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool JsonDeltaSerializer::writeVolatileFields() const
+{
+    return m_writeVolatileFields;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::object JsonDeltaSerializer::writeDeltaToJson( const ObjectHandle* root, std::uint64_t sinceVersion ) const
+{
+    // Read the version first, so changes made while writing are included in the next delta as well
+    const auto version = FieldHandle::currentVersion();
+
+    json::object delta;
+    delta["version"] = version;
+    delta["objects"] = writeChangedFields(
+        root,
+        [sinceVersion]( const FieldHandle* field ) { return field->lastModifiedVersion() > sinceVersion; },
+        [sinceVersion]( const ObjectHandle* object ) { return object->addedVersion() > sinceVersion; } );
+    return delta;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::object JsonDeltaSerializer::writeDeltaToJson( const ObjectHandle*                   root,
+                                                    std::chrono::system_clock::time_point since ) const
+{
+    const auto version = FieldHandle::currentVersion();
+
+    json::object delta;
+    delta["version"] = version;
+    // Objects only record the version they were added at, so every child of a changed child array is written in full
+    delta["objects"] = writeChangedFields(
+        root,
+        [since]( const FieldHandle* field ) { return field->lastModified() > since; },
+        []( const ObjectHandle* ) { return true; } );
+    return delta;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string JsonDeltaSerializer::writeDeltaToString( const ObjectHandle* root, std::uint64_t sinceVersion ) const
+{
+    return json::dump( writeDeltaToJson( root, sinceVersion ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::object JsonDeltaSerializer::writeChangedFields( const ObjectHandle*    root,
+                                                      const ChangePredicate& changed,
+                                                      const AddedPredicate&  added ) const
+{
+    json::object jsonObjects;
+
+    std::vector<const ObjectHandle*> objectsToVisit;
+    if ( root ) objectsToVisit.push_back( root );
+
+    while ( !objectsToVisit.empty() )
+    {
+        const ObjectHandle* object = objectsToVisit.back();
+        objectsToVisit.pop_back();
+
+        json::object jsonFields;
+        for ( auto field : object->fields() )
+        {
+            if ( this->fieldSelector() && !this->fieldSelector()( field ) ) continue;
+            if ( field->isDeprecated() || !field->isReadable() ) continue;
+
+            const FieldIoCapability* ioCapability = field->capability<FieldIoCapability>();
+            if ( !ioCapability ) continue;
+
+            if ( changed( field ) || ( m_writeVolatileFields && field->isVolatile() ) )
+            {
+                if ( auto childArrayField = dynamic_cast<const ChildArrayFieldHandle*>( field ); childArrayField )
+                {
+                    jsonFields[field->keyword()] = writeChildArrayChanges( childArrayField, added, objectsToVisit );
+                    continue;
+                }
+
+                // Changed child fields are written with their whole sub tree. Null values are kept so removing
+                // the object from a child field can be applied.
+                json::value value;
+                ioCapability->writeToJson( value, m_jsonSerializer );
+                jsonFields[field->keyword()] = std::move( value );
+            }
+            else if ( auto childField = dynamic_cast<const ChildFieldBaseHandle*>( field ); childField )
+            {
+                for ( const auto& child : childField->childObjects() )
+                {
+                    if ( child ) objectsToVisit.push_back( child.get() );
+                }
+            }
+        }
+
+        if ( jsonFields.empty() ) continue;
+
+        if ( object->uuid().empty() )
+        {
+            std::string errorMessage = "Cannot write changes to a " + std::string( object->classKeyword() ) +
+                                       " object without a UUID";
+            CAFFA_ERROR( errorMessage );
+            throw std::runtime_error( errorMessage );
+        }
+
+        json::object jsonObject;
+        jsonObject["keyword"] = object->classKeyword();
+        for ( auto& [keyword, value] : jsonFields )
+        {
+            jsonObject[keyword] = std::move( value );
+        }
+        jsonObjects[object->uuid()] = std::move( jsonObject );
+    }
+    return jsonObjects;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the children added since the delta started in full and the other children by uuid only.
+/// The other children are visited for changes of their own.
+//--------------------------------------------------------------------------------------------------
+json::array JsonDeltaSerializer::writeChildArrayChanges( const ChildArrayFieldHandle*      field,
+                                                         const AddedPredicate&             added,
+                                                         std::vector<const ObjectHandle*>& objectsToVisit ) const
+{
+    json::array jsonChildren;
+    for ( const auto& child : field->childObjects() )
+    {
+        if ( !child ) continue;
+
+        json::object jsonChild;
+        if ( added( child.get() ) || child->uuid().empty() )
+        {
+            m_jsonSerializer.writeObjectToJson( child.get(), jsonChild );
+        }
+        else
+        {
+            jsonChild["keyword"] = child->classKeyword();
+            jsonChild["uuid"]    = child->uuid();
+            objectsToVisit.push_back( child.get() );
+        }
+        jsonChildren.emplace_back( std::move( jsonChild ) );
+    }
+    return jsonChildren;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonDeltaSerializer::readDeltaFromJson( ObjectHandle* root, const json::object& delta ) const
+{
+    CAFFA_ASSERT( root );
+
+    auto objectsIt = delta.find( "objects" );
+    if ( objectsIt == delta.end() || !objectsIt->value().is_object() )
+    {
+        throw std::runtime_error( "Delta does not contain any objects" );
+    }
+    const auto& jsonObjects = objectsIt->value().as_object();
+    if ( jsonObjects.empty() ) return;
+
+    std::map<std::string, ObjectHandle*>              objectsByUuid;
+    std::map<const ObjectHandle*, const FieldHandle*> parentFields;
+    collectObjects( root, nullptr, objectsByUuid, parentFields );
+
+    // Check every object and field before changing anything
+    std::vector<std::pair<FieldHandle*, const json::value*>>    changes;
+    std::vector<const ObjectHandle*>                            changedObjects;
+    std::set<const FieldHandle*>                                replacedFields;
+    std::map<const FieldHandle*, std::set<const ObjectHandle*>> keptChildren;
+    for ( const auto& [uuid, jsonValue] : jsonObjects )
+    {
+        auto it = objectsByUuid.find( std::string( uuid ) );
+        if ( it == objectsByUuid.end() )
+        {
+            throw std::runtime_error( "Delta refers to an unknown object " + std::string( uuid ) );
+        }
+        if ( !jsonValue.is_object() )
+        {
+            throw std::runtime_error( "Delta for object " + std::string( uuid ) + " is not a JSON object" );
+        }
+
+        ObjectHandle* object     = it->second;
+        const auto&   jsonObject = jsonValue.as_object();
+        if ( auto keywordIt = jsonObject.find( "keyword" );
+             keywordIt != jsonObject.end() &&
+             ( !keywordIt->value().is_string() ||
+               !ObjectHandle::matchesClassKeyword( json::from_json<std::string>( keywordIt->value() ),
+                                                   object->classInheritanceStack() ) ) )
+        {
+            throw std::runtime_error( "Delta for object " + std::string( uuid ) + " has the wrong class keyword" );
+        }
+
+        for ( const auto& [keyword, value] : jsonObject )
+        {
+            if ( keyword == "keyword" ) continue;
+
+            auto field = object->findField( keyword );
+            if ( !field || !field->capability<FieldIoCapability>() || !field->isWritable() )
+            {
+                throw std::runtime_error( "Invalid field " + std::string( keyword ) + " in " +
+                                          std::string( object->classKeyword() ) );
+            }
+            if ( this->fieldSelector() && !this->fieldSelector()( field ) ) continue;
+
+            const bool isChildField = dynamic_cast<ChildFieldBaseHandle*>( field ) != nullptr;
+            if ( value.is_null() && !isChildField )
+            {
+                throw std::runtime_error( "Null value for field " + std::string( keyword ) + " in " +
+                                          std::string( object->classKeyword() ) );
+            }
+            if ( value.is_array() && dynamic_cast<ChildArrayFieldHandle*>( field ) )
+            {
+                keptChildren[field] = findKeptChildren( field, value.as_array(), objectsByUuid, parentFields );
+            }
+            else if ( isChildField )
+            {
+                replacedFields.insert( field );
+            }
+
+            changes.emplace_back( field, &value );
+        }
+        changedObjects.push_back( object );
+    }
+
+    // Replacing the children of a child field destroys them, so none of them can have changes of their own
+    for ( auto object : changedObjects )
+    {
+        if ( auto field = findReplacingField( object, replacedFields, keptChildren, parentFields ); field )
+        {
+            throw std::runtime_error( "Delta changes object " + object->uuid() + " which is replaced in the field " +
+                                      field->keyword() + " of " + field->ownerObject()->uuid() );
+        }
+    }
+
+    for ( const auto& [field, value] : changes )
+    {
+        if ( value->is_null() )
+        {
+            if ( auto childField = dynamic_cast<ChildFieldHandle*>( field ); childField )
+            {
+                childField->clear();
+            }
+            else if ( auto childArrayField = dynamic_cast<ChildArrayFieldHandle*>( field ); childArrayField )
+            {
+                childArrayField->clear();
+            }
+            continue;
+        }
+        field->capability<FieldIoCapability>()->readFromJson( *value, m_jsonSerializer );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonDeltaSerializer::readDeltaFromString( ObjectHandle* root, const std::string& string ) const
+{
+    auto delta = json::parse( string );
+    if ( !delta.is_object() )
+    {
+        throw std::runtime_error( "Delta is not a JSON object" );
+    }
+    readDeltaFromJson( root, delta.as_object() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t JsonDeltaSerializer::deltaVersion( const json::object& delta )
+{
+    if ( auto it = delta.find( "version" ); it != delta.end() )
+    {
+        return json::from_json<std::uint64_t>( it->value() );
+    }
+    return 0u;
+}
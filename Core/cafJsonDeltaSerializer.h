@@ -0,0 +1,152 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+#include "cafJsonSerializer.h"
+#include "cafObjectHandle.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace caffa
+{
+class ChildArrayFieldHandle;
+class FieldHandle;
+class ObjectFactory;
+
+/**
+ * Serializer writing and applying deltas: only the fields changed since a given modification version or time.
+ *
+ * A delta looks like {"version": 1234, "objects": {"<uuid>": {"keyword": "Class", "Field": value, ...}}}.
+ * The version is FieldHandle::currentVersion() when the delta was written, so it can be passed in when writing
+ * the next delta. Objects are found by UUID when the delta is applied, so the receiving object tree must have
+ * been created from a full serialization including UUIDs.
+ *
+ * Changed child fields are written in full, including their whole sub tree, and objects inside them are not
+ * listed separately. Changed child array fields are written element by element instead: children added to the field
+ * since the version are written in full, and the other children as {"keyword": "Class", "uuid": "<uuid>"} in
+ * their new position, with their own changes listed separately. Deltas since a time write every child in full,
+ * since objects only record the version they were added at.
+ *
+ * Volatile fields get their value from elsewhere, so their changes are not recorded by the field and by default
+ * they are only included when they have been set. Otherwise a delta of a tree with a volatile field would never be
+ * empty. Use setWriteVolatileFields() to include every volatile field in every delta.
+ */
+class JsonDeltaSerializer
+{
+public:
+    using FieldSelector = JsonSerializer::FieldSelector;
+
+    /**
+     * Constructor
+     * @param objectFactory The factory used when creating new child objects. Not relevant when writing.
+     */
+    explicit JsonDeltaSerializer( ObjectFactory* objectFactory = nullptr );
+
+    /**
+     * Set Field Selector
+     * @param fieldSelector
+     * @return reference to this
+     */
+    JsonDeltaSerializer& setFieldSelector( FieldSelector fieldSelector );
+
+    /**
+     * Set whether volatile fields are written in every delta, whether they have been set or not
+     * @param writeVolatileFields true to write volatile fields in every delta, false to only write them when set
+     * (the default)
+     * @return reference to this
+     */
+    JsonDeltaSerializer& setWriteVolatileFields( bool writeVolatileFields );
+
+    [[nodiscard]] ObjectFactory* objectFactory() const;
+    [[nodiscard]] FieldSelector  fieldSelector() const;
+    [[nodiscard]] bool           writeVolatileFields() const;
+
+    /**
+     * Write the fields of the object tree changed after the given modification version
+     * @param root The root of the object tree
+     * @param sinceVersion A version previously returned by FieldHandle::currentVersion() or stored in a delta
+     * @return The delta. Contains an empty "objects" entry if nothing has changed.
+     */
+    [[nodiscard]] json::object writeDeltaToJson( const ObjectHandle* root, std::uint64_t sinceVersion ) const;
+
+    /**
+     * Write the fields of the object tree changed after the given time
+     * @param root The root of the object tree
+     * @param since Fields changed at a later time than this are written
+     * @return The delta. Contains an empty "objects" entry if nothing has changed.
+     */
+    [[nodiscard]] json::object writeDeltaToJson( const ObjectHandle*                   root,
+                                                 std::chrono::system_clock::time_point since ) const;
+
+    /**
+     * Write the fields of the object tree changed after the given modification version to a string
+     * @param root The root of the object tree
+     * @param sinceVersion A version previously returned by FieldHandle::currentVersion() or stored in a delta
+     * @return The delta as a JSON string
+     */
+    [[nodiscard]] std::string writeDeltaToString( const ObjectHandle* root, std::uint64_t sinceVersion ) const;
+
+    /**
+     * Apply a delta to the object tree. Every object and field in the delta is looked up before any field is
+     * changed, so a delta referring to unknown objects or fields leaves the tree untouched.
+     * Deltas with null values for fields other than child fields, with changes to objects the same delta replaces or
+     * removes from a child field, or keeping children a child array field does not have, are rejected before
+     * anything is changed as well.
+     * A value which can not be read throws part way through, after the fields before it have been changed.
+     * Throws std::runtime_error on invalid deltas.
+     * @param root The root of the object tree
+     * @param delta The delta
+     */
+    void readDeltaFromJson( ObjectHandle* root, const json::object& delta ) const;
+
+    /**
+     * Apply a delta from a JSON string to the object tree. Throws std::runtime_error on invalid deltas.
+     * @param root The root of the object tree
+     * @param string The delta as a JSON string
+     */
+    void readDeltaFromString( ObjectHandle* root, const std::string& string ) const;
+
+    /**
+     * Read the version stored in a delta, which can be used as the starting point of the next delta
+     * @param delta The delta
+     * @return the version or zero if the delta has no version
+     */
+    [[nodiscard]] static std::uint64_t deltaVersion( const json::object& delta );
+
+private:
+    using ChangePredicate = std::function<bool( const FieldHandle* )>;
+    using AddedPredicate  = std::function<bool( const ObjectHandle* )>;
+
+    [[nodiscard]] json::object writeChangedFields( const ObjectHandle*    root,
+                                                   const ChangePredicate& changed,
+                                                   const AddedPredicate&  added ) const;
+    [[nodiscard]] json::array writeChildArrayChanges( const ChildArrayFieldHandle*      field,
+                                                      const AddedPredicate&             added,
+                                                      std::vector<const ObjectHandle*>& objectsToVisit ) const;
+
+    JsonSerializer m_jsonSerializer;
+    bool           m_writeVolatileFields;
+};
+
+} // namespace caffa
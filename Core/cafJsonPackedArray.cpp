@@ -0,0 +1,183 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonPackedArray.h"
+
+#include "cafStringEncoding.h"
+
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace caffa::JsonPackedArray
+{
+namespace
+{
+    constexpr std::array<std::pair<std::string_view, size_t>, 10> ELEMENT_SIZES = { {
+        { "float32", 4u },
+        { "float64", 8u },
+        { "int8", 1u },
+        { "int16", 2u },
+        { "int32", 4u },
+        { "int64", 8u },
+        { "uint8", 1u },
+        { "uint16", 2u },
+        { "uint32", 4u },
+        { "uint64", 8u },
+    } };
+
+    size_t elementSize( std::string_view dtype )
+    {
+        for ( const auto& [label, size] : ELEMENT_SIZES )
+        {
+            if ( label == dtype ) return size;
+        }
+        throw std::runtime_error( "Invalid packed array: Unknown dtype " + std::string( dtype ) );
+    }
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool isPacked( const json::value& value )
+{
+    const auto* object = value.if_object();
+    return object && object->size() == 3u && object->contains( "dtype" ) && object->contains( "length" ) &&
+           object->contains( "data" );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::object jsonSchema()
+{
+    json::array dtypes;
+    for ( const auto& [label, size] : ELEMENT_SIZES )
+    {
+        dtypes.emplace_back( label );
+    }
+
+    json::object properties;
+    properties["dtype"]  = { { "type", "string" }, { "enum", std::move( dtypes ) } };
+    properties["length"] = { { "type", "integer" }, { "minimum", 0 } };
+    properties["data"]   = { { "type", "string" }, { "contentEncoding", "base64" } };
+
+    json::object schema;
+    schema["type"]                 = "object";
+    schema["properties"]           = std::move( properties );
+    schema["required"]             = { "dtype", "length", "data" };
+    schema["additionalProperties"] = false;
+    return schema;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::object packData( std::string_view dtype, size_t length, std::string_view littleEndianData )
+{
+    json::object packed;
+    packed["dtype"]  = std::string( dtype );
+    packed["length"] = length;
+
+    // Encode straight into the JSON string to avoid an intermediate copy of large arrays
+    auto& data = packed["data"].emplace_string();
+    data.resize( StringTools::encodedBase64Size( littleEndianData.size() ) );
+    StringTools::encodeBase64( littleEndianData, std::span<char>( data.data(), data.size() ) );
+    return packed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string_view readEntries( const json::object& packed, std::string& dtype, size_t& length )
+{
+    const auto* dtypeValue  = packed.if_contains( "dtype" );
+    const auto* lengthValue = packed.if_contains( "length" );
+    const auto* dataValue   = packed.if_contains( "data" );
+    if ( !dtypeValue || !dtypeValue->is_string() || !lengthValue || !dataValue || !dataValue->is_string() )
+    {
+        throw std::runtime_error( "Invalid packed array: " + json::dump( packed ) );
+    }
+
+    dtype  = json::from_json<std::string>( *dtypeValue );
+    length = json::from_json<size_t>( *lengthValue );
+
+    const auto&      encodedString = dataValue->get_string();
+    std::string_view encoded( encodedString.data(), encodedString.size() );
+
+    // Compare by division, since a hostile length could overflow the multiplication
+    const size_t size        = elementSize( dtype );
+    const size_t decodedSize = StringTools::decodedBase64Size( encoded );
+    if ( length > decodedSize / size || length * size != decodedSize )
+    {
+        throw std::runtime_error( "Invalid packed array: Expected " + std::to_string( length ) + " " + dtype +
+                                  " elements but got " + std::to_string( decodedSize ) + " bytes" );
+    }
+    return encoded;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::array unpackToArray( const json::object& packed )
+{
+    auto toArray = []( const auto& values )
+    {
+        json::array array;
+        array.reserve( values.size() );
+        for ( const auto value : values )
+        {
+            array.emplace_back( value );
+        }
+        return array;
+    };
+
+    const auto* dtypeValue = packed.if_contains( "dtype" );
+    if ( !dtypeValue || !dtypeValue->is_string() )
+    {
+        throw std::runtime_error( "Invalid packed array: " + json::dump( packed ) );
+    }
+
+    const auto& dtype = dtypeValue->get_string();
+    if ( dtype == "float32" ) return toArray( unpack<float>( packed ) );
+    if ( dtype == "float64" ) return toArray( unpack<double>( packed ) );
+    if ( dtype == "int8" ) return toArray( unpack<std::int8_t>( packed ) );
+    if ( dtype == "int16" ) return toArray( unpack<std::int16_t>( packed ) );
+    if ( dtype == "int32" ) return toArray( unpack<std::int32_t>( packed ) );
+    if ( dtype == "int64" ) return toArray( unpack<std::int64_t>( packed ) );
+    if ( dtype == "uint8" ) return toArray( unpack<std::uint8_t>( packed ) );
+    if ( dtype == "uint16" ) return toArray( unpack<std::uint16_t>( packed ) );
+    if ( dtype == "uint32" ) return toArray( unpack<std::uint32_t>( packed ) );
+    return toArray( unpack<std::uint64_t>( packed ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void decodeData( std::string_view encoded, std::span<char> output )
+{
+    const size_t decodedSize = StringTools::decodeBase64( encoded, output );
+    if ( decodedSize != output.size() )
+    {
+        throw std::runtime_error( "Invalid packed array: Expected " + std::to_string( output.size() ) +
+                                  " bytes but got " + std::to_string( decodedSize ) );
+    }
+}
+
+} // namespace caffa::JsonPackedArray
@@ -0,0 +1,228 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace caffa::JsonPackedArray
+{
+/**
+ * Numeric vectors can be written as a little endian binary blob encoded with base64 instead of an array of numbers:
+ * { "dtype": "float64", "length": 3, "data": "<base64>" }
+ * This is considerably smaller than the text form for large vectors and is encoded and decoded at memcpy speed.
+ */
+template <typename T>
+concept Packable = ( std::is_integral_v<T> && !std::is_same_v<T, bool> ) ||
+                   ( std::is_floating_point_v<T> && ( sizeof( T ) == 4u || sizeof( T ) == 8u ) );
+
+template <typename T>
+struct IsPackableVector : std::false_type
+{
+};
+
+template <Packable T>
+struct IsPackableVector<std::vector<T>> : std::true_type
+{
+};
+
+template <typename T>
+inline constexpr bool IsPackableVectorV = IsPackableVector<T>::value;
+
+/**
+ * The dtype label used for an element type, following the numpy naming
+ */
+template <Packable T>
+constexpr std::string_view dtype()
+{
+    if constexpr ( std::is_floating_point_v<T> )
+    {
+        return sizeof( T ) == 4u ? "float32" : "float64";
+    }
+    else if constexpr ( std::is_signed_v<T> )
+    {
+        if constexpr ( sizeof( T ) == 1u ) return "int8";
+        else if constexpr ( sizeof( T ) == 2u ) return "int16";
+        else if constexpr ( sizeof( T ) == 4u ) return "int32";
+        else return "int64";
+    }
+    else
+    {
+        if constexpr ( sizeof( T ) == 1u ) return "uint8";
+        else if constexpr ( sizeof( T ) == 2u ) return "uint16";
+        else if constexpr ( sizeof( T ) == 4u ) return "uint32";
+        else return "uint64";
+    }
+}
+
+/**
+ * Check if a JSON value is a packed array
+ * @param value The JSON value
+ * @return true if the value is an object with dtype, length and data entries
+ */
+bool isPacked( const json::value& value );
+
+/**
+ * The JSON schema of a packed array. Any dtype is accepted, since packed arrays are converted when read.
+ * @return The schema object
+ */
+json::object jsonSchema();
+
+/**
+ * Build a packed array from raw little endian element data
+ * @param dtype The dtype label of the elements
+ * @param length The number of elements
+ * @param littleEndianData The raw element data
+ * @return The packed array object
+ */
+json::object packData( std::string_view dtype, size_t length, std::string_view littleEndianData );
+
+/**
+ * Read the entries of a packed array. Throws std::runtime_error if the packed array is invalid or if the length does
+ * not match the size of the data.
+ * @param packed The packed array object
+ * @param dtype Set to the dtype label of the elements
+ * @param length Set to the number of elements
+ * @return The base64 encoded little endian element data
+ */
+std::string_view readEntries( const json::object& packed, std::string& dtype, size_t& length );
+
+/**
+ * Decode the element data of a packed array straight into a buffer. Throws std::runtime_error on invalid data.
+ * @param encoded The base64 encoded data returned by readEntries
+ * @param output The buffer to decode into. Must hold the length times the element size in bytes.
+ */
+void decodeData( std::string_view encoded, std::span<char> output );
+
+namespace detail
+{
+    template <Packable T>
+    T readLittleEndian( const char* data )
+    {
+        T value;
+        if constexpr ( std::endian::native == std::endian::little )
+        {
+            std::memcpy( &value, data, sizeof( T ) );
+        }
+        else
+        {
+            char reversed[sizeof( T )];
+            for ( size_t i = 0u; i < sizeof( T ); ++i )
+            {
+                reversed[i] = data[sizeof( T ) - 1u - i];
+            }
+            std::memcpy( &value, reversed, sizeof( T ) );
+        }
+        return value;
+    }
+
+    template <Packable Source, Packable Target>
+    std::vector<Target> convert( std::string_view encoded, size_t length )
+    {
+        std::vector<Target> values( length );
+        if ( length == 0u ) return values;
+
+        if constexpr ( std::is_same_v<Source, Target> && std::endian::native == std::endian::little )
+        {
+            // Decode straight into the vector storage
+            decodeData( encoded,
+                        std::span<char>( reinterpret_cast<char*>( values.data() ), length * sizeof( Target ) ) );
+        }
+        else
+        {
+            std::string data( length * sizeof( Source ), '\0' );
+            decodeData( encoded, std::span<char>( data.data(), data.size() ) );
+            for ( size_t i = 0u; i < length; ++i )
+            {
+                values[i] = static_cast<Target>( readLittleEndian<Source>( data.data() + i * sizeof( Source ) ) );
+            }
+        }
+        return values;
+    }
+} // namespace detail
+
+/**
+ * Pack a numeric vector
+ * @param values The values to pack
+ * @return The packed array object
+ */
+template <Packable T>
+json::object pack( const std::vector<T>& values )
+{
+    std::string data( values.size() * sizeof( T ), '\0' );
+    if constexpr ( std::endian::native == std::endian::little )
+    {
+        if ( !values.empty() ) std::memcpy( data.data(), values.data(), data.size() );
+    }
+    else
+    {
+        for ( size_t i = 0u; i < values.size(); ++i )
+        {
+            const char* bytes = reinterpret_cast<const char*>( &values[i] );
+            for ( size_t j = 0u; j < sizeof( T ); ++j )
+            {
+                data[i * sizeof( T ) + j] = bytes[sizeof( T ) - 1u - j];
+            }
+        }
+    }
+    return packData( dtype<T>(), values.size(), data );
+}
+
+/**
+ * Unpack a packed array into a numeric vector. Elements of a different dtype are converted to the requested type.
+ * Throws std::runtime_error if the packed array is invalid.
+ * @param packed The packed array object
+ * @return The values
+ */
+template <Packable T>
+std::vector<T> unpack( const json::object& packed )
+{
+    std::string      dtypeLabel;
+    size_t           length = 0u;
+    std::string_view data   = readEntries( packed, dtypeLabel, length );
+
+    if ( dtypeLabel == "float32" ) return detail::convert<float, T>( data, length );
+    if ( dtypeLabel == "float64" ) return detail::convert<double, T>( data, length );
+    if ( dtypeLabel == "int8" ) return detail::convert<std::int8_t, T>( data, length );
+    if ( dtypeLabel == "int16" ) return detail::convert<std::int16_t, T>( data, length );
+    if ( dtypeLabel == "int32" ) return detail::convert<std::int32_t, T>( data, length );
+    if ( dtypeLabel == "int64" ) return detail::convert<std::int64_t, T>( data, length );
+    if ( dtypeLabel == "uint8" ) return detail::convert<std::uint8_t, T>( data, length );
+    if ( dtypeLabel == "uint16" ) return detail::convert<std::uint16_t, T>( data, length );
+    if ( dtypeLabel == "uint32" ) return detail::convert<std::uint32_t, T>( data, length );
+    return detail::convert<std::uint64_t, T>( data, length );
+}
+
+/**
+ * Unpack a packed array into a plain JSON array of numbers, keeping the element type of the packed data.
+ * Throws std::runtime_error if the packed array is invalid.
+ * @param packed The packed array object
+ * @return The values as a JSON array
+ */
+json::array unpackToArray( const json::object& packed );
+
+} // namespace caffa::JsonPackedArray
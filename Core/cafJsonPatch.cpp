@@ -0,0 +1,699 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonPatch.h"
+
+#include "cafAssert.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafChildFieldHandle.h"
+#include "cafFieldHandle.h"
+#include "cafFieldIoCapability.h"
+#include "cafJsonPackedArray.h"
+#include "cafLogger.h"
+#include "cafObjectHandle.h"
+
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+using namespace caffa;
+
+namespace
+{
+//==================================================================================================
+/// The place in the object tree a JSON Pointer resolves to
+//==================================================================================================
+struct Location
+{
+    // The object addressed when field is null, otherwise the object owning the field
+    ObjectHandle* object = nullptr;
+    FieldHandle*  field  = nullptr;
+
+    // Set when addressing an object in a child array field. The index equals the size for "-"
+    bool   hasIndex = false;
+    size_t index    = 0u;
+
+    // Tokens addressing the inside of the JSON value of a data field
+    std::vector<std::string> valueTokens;
+
+    [[nodiscard]] ChildArrayFieldHandle* childArrayField() const
+    {
+        return dynamic_cast<ChildArrayFieldHandle*>( field );
+    }
+    [[nodiscard]] ChildFieldHandle* childField() const { return dynamic_cast<ChildFieldHandle*>( field ); }
+};
+
+//--------------------------------------------------------------------------------------------------
+/// Split a JSON Pointer into unescaped tokens
+//--------------------------------------------------------------------------------------------------
+std::vector<std::string> splitPointer( const std::string& pointer )
+{
+    if ( pointer.empty() ) return {};
+
+    if ( pointer.front() != '/' )
+    {
+        throw std::runtime_error( "Invalid JSON Pointer '" + pointer + "'" );
+    }
+
+    std::vector<std::string> tokens;
+    for ( size_t start = 1u; start <= pointer.size(); )
+    {
+        size_t end = pointer.find( '/', start );
+        if ( end == std::string::npos ) end = pointer.size();
+
+        std::string token;
+        for ( size_t i = start; i < end; ++i )
+        {
+            if ( pointer[i] != '~' )
+            {
+                token.push_back( pointer[i] );
+            }
+            else if ( i + 1 < end && ( pointer[i + 1] == '0' || pointer[i + 1] == '1' ) )
+            {
+                token.push_back( pointer[++i] == '0' ? '~' : '/' );
+            }
+            else
+            {
+                throw std::runtime_error( "Invalid escape sequence in JSON Pointer '" + pointer + "'" );
+            }
+        }
+        tokens.push_back( std::move( token ) );
+        start = end + 1;
+    }
+    return tokens;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Parse an array index token. "-" is only accepted when allowEnd is true and gives the size.
+//--------------------------------------------------------------------------------------------------
+size_t arrayIndex( const std::string& token, size_t size, bool allowEnd )
+{
+    if ( allowEnd && token == "-" ) return size;
+
+    size_t index = 0u;
+    bool   valid = !token.empty() && ( token.size() == 1u || token.front() != '0' );
+    if ( valid )
+    {
+        auto [ptr, ec] = std::from_chars( token.data(), token.data() + token.size(), index );
+        valid          = ec == std::errc() && ptr == token.data() + token.size();
+    }
+
+    if ( !valid )
+    {
+        throw std::runtime_error( "Invalid array index '" + token + "'" );
+    }
+    if ( index > size || ( index == size && !allowEnd ) )
+    {
+        throw std::runtime_error( "Array index " + token + " is out of range" );
+    }
+    return index;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Location resolve( ObjectHandle* root, const std::string& pointer, bool forAdd )
+{
+    Location location;
+    location.object = root;
+
+    auto tokens = splitPointer( pointer );
+    for ( size_t i = 0; i < tokens.size(); ++i )
+    {
+        auto field = location.object->findField( tokens[i] );
+        if ( !field )
+        {
+            throw std::runtime_error( "No field '" + tokens[i] + "' in " +
+                                      std::string( location.object->classKeyword() ) );
+        }
+        location.field = field;
+
+        if ( i + 1 == tokens.size() ) break;
+
+        if ( auto childArrayField = location.childArrayField(); childArrayField )
+        {
+            const bool   lastToken = i + 2 == tokens.size();
+            const size_t index     = arrayIndex( tokens[++i], childArrayField->size(), forAdd && lastToken );
+            if ( lastToken )
+            {
+                location.hasIndex = true;
+                location.index    = index;
+                break;
+            }
+            location.object = childArrayField->at( index ).get();
+            location.field  = nullptr;
+            if ( !location.object )
+            {
+                throw std::runtime_error( "Path '" + pointer + "' not found: No object at index " + tokens[i] +
+                                          " in '" + childArrayField->keyword() + "'" );
+            }
+        }
+        else if ( auto childField = location.childField(); childField )
+        {
+            auto children = childField->childObjects();
+            if ( children.empty() || !children.front() )
+            {
+                throw std::runtime_error( "Field '" + tokens[i] + "' does not contain an object" );
+            }
+            location.object = children.front().get();
+            location.field  = nullptr;
+        }
+        else
+        {
+            location.valueTokens.assign( tokens.begin() + i + 1, tokens.end() );
+            break;
+        }
+    }
+    return location;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Find the value at the tokens inside a JSON value
+//--------------------------------------------------------------------------------------------------
+json::value& jsonAt( json::value& value, std::span<const std::string> tokens )
+{
+    json::value* current = &value;
+    for ( const auto& token : tokens )
+    {
+        if ( auto jsonObject = current->if_object(); jsonObject )
+        {
+            auto it = jsonObject->find( token );
+            if ( it == jsonObject->end() )
+            {
+                throw std::runtime_error( "No member '" + token + "' in JSON value" );
+            }
+            current = &it->value();
+        }
+        else if ( auto jsonArray = current->if_array(); jsonArray )
+        {
+            current = &( *jsonArray )[arrayIndex( token, jsonArray->size(), false )];
+        }
+        else
+        {
+            throw std::runtime_error( "Can not look up '" + token + "' in a JSON value which is not a container" );
+        }
+    }
+    return *current;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void jsonAdd( json::value& value, std::span<const std::string> tokens, const json::value& newValue )
+{
+    if ( tokens.empty() )
+    {
+        value = newValue;
+        return;
+    }
+
+    auto& parent = jsonAt( value, tokens.first( tokens.size() - 1u ) );
+    if ( auto jsonObject = parent.if_object(); jsonObject )
+    {
+        ( *jsonObject )[tokens.back()] = newValue;
+    }
+    else if ( auto jsonArray = parent.if_array(); jsonArray )
+    {
+        jsonArray->insert( jsonArray->begin() + arrayIndex( tokens.back(), jsonArray->size(), true ), newValue );
+    }
+    else
+    {
+        throw std::runtime_error( "Can not add '" + tokens.back() + "' to a JSON value which is not a container" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void jsonRemove( json::value& value, std::span<const std::string> tokens )
+{
+    auto& parent = jsonAt( value, tokens.first( tokens.size() - 1u ) );
+    if ( auto jsonObject = parent.if_object(); jsonObject )
+    {
+        if ( jsonObject->erase( tokens.back() ) == 0u )
+        {
+            throw std::runtime_error( "No member '" + tokens.back() + "' in JSON value" );
+        }
+    }
+    else if ( auto jsonArray = parent.if_array(); jsonArray )
+    {
+        jsonArray->erase( jsonArray->begin() + arrayIndex( tokens.back(), jsonArray->size(), false ) );
+    }
+    else
+    {
+        throw std::runtime_error( "Can not remove '" + tokens.back() + "' from a JSON value which is not a container" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Compare JSON values as RFC 6902 requires, with numbers compared by value regardless of representation
+//--------------------------------------------------------------------------------------------------
+bool jsonEqual( const json::value& lhs, const json::value& rhs )
+{
+    if ( lhs.is_number() && rhs.is_number() )
+    {
+        if ( lhs.is_double() || rhs.is_double() ) return lhs.to_number<double>() == rhs.to_number<double>();
+        if ( lhs.is_int64() && rhs.is_int64() ) return lhs.get_int64() == rhs.get_int64();
+        if ( lhs.is_uint64() && rhs.is_uint64() ) return lhs.get_uint64() == rhs.get_uint64();
+
+        const auto& signedValue   = lhs.is_int64() ? lhs : rhs;
+        const auto& unsignedValue = lhs.is_int64() ? rhs : lhs;
+        return signedValue.get_int64() >= 0 &&
+               static_cast<std::uint64_t>( signedValue.get_int64() ) == unsignedValue.get_uint64();
+    }
+    if ( lhs.kind() != rhs.kind() ) return false;
+
+    if ( lhs.is_array() )
+    {
+        const auto& lhsArray = lhs.get_array();
+        const auto& rhsArray = rhs.get_array();
+        if ( lhsArray.size() != rhsArray.size() ) return false;
+        for ( size_t i = 0; i < lhsArray.size(); ++i )
+        {
+            if ( !jsonEqual( lhsArray[i], rhsArray[i] ) ) return false;
+        }
+        return true;
+    }
+    if ( lhs.is_object() )
+    {
+        const auto& lhsObject = lhs.get_object();
+        const auto& rhsObject = rhs.get_object();
+        if ( lhsObject.size() != rhsObject.size() ) return false;
+        for ( const auto& [key, value] : lhsObject )
+        {
+            auto it = rhsObject.find( key );
+            if ( it == rhsObject.end() || !jsonEqual( value, it->value() ) ) return false;
+        }
+        return true;
+    }
+    return lhs == rhs;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value fieldValue( const FieldHandle* field, const JsonSerializer& serializer )
+{
+    auto ioCapability = field->capability<FieldIoCapability>();
+    if ( !ioCapability || !field->isReadable() )
+    {
+        throw std::runtime_error( "Field '" + field->keyword() + "' is not readable" );
+    }
+
+    json::value value;
+    ioCapability->writeToJson( value, serializer );
+
+    // Pointers address the elements of numeric arrays, so packed arrays are resolved against the plain array
+    if ( JsonPackedArray::isPacked( value ) )
+    {
+        value = JsonPackedArray::unpackToArray( value.get_object() );
+    }
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void setFieldValue( FieldHandle* field, const json::value& value, const JsonSerializer& serializer )
+{
+    auto ioCapability = field->capability<FieldIoCapability>();
+    if ( !ioCapability || !field->isWritable() )
+    {
+        throw std::runtime_error( "Field '" + field->keyword() + "' is not writable" );
+    }
+    ioCapability->readFromJson( value, serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void checkChildClass( const ChildFieldBaseHandle* field, const ObjectHandle* object )
+{
+    if ( !ObjectHandle::matchesClassKeyword( field->childClassKeyword(), object->classInheritanceStack() ) )
+    {
+        throw std::runtime_error( "A " + std::string( object->classKeyword() ) + " object can not be placed in '" +
+                                  field->keyword() + "'" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle>
+    createChild( const ChildFieldBaseHandle* field, const json::value& value, const JsonSerializer& serializer )
+{
+    if ( !value.is_object() )
+    {
+        throw std::runtime_error( "The new object for '" + field->keyword() + "' is not a JSON object" );
+    }
+
+    auto object = serializer.createObjectFromJson( value.get_object() );
+    if ( !object )
+    {
+        throw std::runtime_error( "Failed to create a new object for '" + field->keyword() + "'" );
+    }
+    checkChildClass( field, object.get() );
+    return object;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The object held at a location, if the location is an object slot in a child field
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> heldObject( const Location& location )
+{
+    if ( location.hasIndex ) return location.childArrayField()->at( location.index );
+
+    if ( auto childField = location.childField(); childField && location.valueTokens.empty() )
+    {
+        auto children = childField->childObjects();
+        return children.empty() ? nullptr : children.front();
+    }
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value getValue( const Location& location, const JsonSerializer& serializer )
+{
+    if ( !location.field || location.hasIndex )
+    {
+        auto object = location.hasIndex ? location.childArrayField()->at( location.index ) : nullptr;
+        if ( location.hasIndex && !object )
+        {
+            throw std::runtime_error( "Path not found: No object at index " + std::to_string( location.index ) +
+                                      " in '" + location.field->keyword() + "'" );
+        }
+
+        json::object jsonObject;
+        serializer.writeObjectToJson( object ? object.get() : location.object, jsonObject );
+        return jsonObject;
+    }
+
+    auto value = fieldValue( location.field, serializer );
+    if ( location.valueTokens.empty() ) return value;
+
+    return jsonAt( value, location.valueTokens );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void addValue( const Location& location, const json::value& value, const JsonSerializer& serializer )
+{
+    if ( !location.field )
+    {
+        if ( !value.is_object() )
+        {
+            throw std::runtime_error( "The value for an object is not a JSON object" );
+        }
+        serializer.readObjectFromJson( location.object, value.get_object() );
+    }
+    else if ( location.hasIndex )
+    {
+        auto childArrayField = location.childArrayField();
+        childArrayField->insertAt( location.index, createChild( childArrayField, value, serializer ) );
+    }
+    else if ( location.valueTokens.empty() )
+    {
+        setFieldValue( location.field, value, serializer );
+    }
+    else
+    {
+        auto fieldJson = fieldValue( location.field, serializer );
+        jsonAdd( fieldJson, location.valueTokens, value );
+        setFieldValue( location.field, fieldJson, serializer );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void removeValue( const Location& location, const JsonSerializer& serializer )
+{
+    if ( !location.field )
+    {
+        throw std::runtime_error( "Objects can only be removed from child fields" );
+    }
+
+    if ( location.hasIndex )
+    {
+        location.childArrayField()->erase( location.index );
+    }
+    else if ( !location.valueTokens.empty() )
+    {
+        auto fieldJson = fieldValue( location.field, serializer );
+        jsonRemove( fieldJson, location.valueTokens );
+        setFieldValue( location.field, fieldJson, serializer );
+    }
+    else if ( auto childField = location.childField(); childField )
+    {
+        childField->clear();
+    }
+    else if ( auto childArrayField = location.childArrayField(); childArrayField )
+    {
+        childArrayField->clear();
+    }
+    else
+    {
+        throw std::runtime_error( "Field '" + location.field->keyword() + "' can not be removed" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void replaceValue( const Location& location, const json::value& value, const JsonSerializer& serializer )
+{
+    if ( location.hasIndex )
+    {
+        auto childArrayField = location.childArrayField();
+        auto object          = createChild( childArrayField, value, serializer );
+        childArrayField->erase( location.index );
+        childArrayField->insertAt( location.index, object );
+    }
+    else if ( location.field && !location.valueTokens.empty() )
+    {
+        auto  fieldJson = fieldValue( location.field, serializer );
+        auto& target    = jsonAt( fieldJson, location.valueTokens );
+        target          = value;
+        setFieldValue( location.field, fieldJson, serializer );
+    }
+    else
+    {
+        addValue( location, value, serializer );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Place an existing object at a location. Returns false if the location is not an object slot.
+//--------------------------------------------------------------------------------------------------
+bool placeObject( const Location& location, std::shared_ptr<ObjectHandle> object )
+{
+    if ( location.hasIndex )
+    {
+        auto childArrayField = location.childArrayField();
+        checkChildClass( childArrayField, object.get() );
+        childArrayField->insertAt( location.index, object );
+        return true;
+    }
+    if ( auto childField = location.childField(); childField && location.valueTokens.empty() )
+    {
+        checkChildClass( childField, object.get() );
+        childField->setChildObject( object );
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void moveValue( ObjectHandle*         root,
+                const std::string&    from,
+                const std::string&    path,
+                const JsonSerializer& serializer )
+{
+    if ( from == path ) return;
+
+    if ( path.starts_with( from + "/" ) )
+    {
+        throw std::runtime_error( "Can not move '" + from + "' into itself" );
+    }
+
+    auto source = resolve( root, from, false );
+    auto object = heldObject( source );
+    if ( !object )
+    {
+        auto value = getValue( source, serializer );
+        removeValue( source, serializer );
+        addValue( resolve( root, path, true ), value, serializer );
+        return;
+    }
+
+    // Objects are moved without serializing them. The target is resolved after removing the object, as the removal
+    // may shift indices in the same array. If the object can not be placed it is put back where it came from.
+    removeValue( source, serializer );
+    try
+    {
+        auto target = resolve( root, path, true );
+        if ( !placeObject( target, object ) )
+        {
+            json::object jsonObject;
+            serializer.writeObjectToJson( object.get(), jsonObject );
+            addValue( target, jsonObject, serializer );
+        }
+    }
+    catch ( const std::exception& )
+    {
+        placeObject( source, object );
+        throw;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string memberString( const json::object& operation, std::string_view key )
+{
+    auto it = operation.find( key );
+    if ( it == operation.end() || !it->value().is_string() )
+    {
+        throw std::runtime_error( "Missing string member '" + std::string( key ) + "'" );
+    }
+    return json::from_json<std::string>( it->value() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const json::value& memberValue( const json::object& operation )
+{
+    auto it = operation.find( "value" );
+    if ( it == operation.end() )
+    {
+        throw std::runtime_error( "Missing member 'value'" );
+    }
+    return it->value();
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonPatch::JsonPatch( ObjectFactory* objectFactory /* = nullptr */ )
+    : m_jsonSerializer( objectFactory )
+    , m_copySerializer( objectFactory )
+{
+    // Copies get new UUIDs, so they can not be mistaken for the original
+    m_copySerializer.setSerializeUuids( false );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonPatch::apply( ObjectHandle* root, const json::array& patch ) const
+{
+    CAFFA_ASSERT( root );
+
+    for ( size_t i = 0; i < patch.size(); ++i )
+    {
+        try
+        {
+            if ( !patch[i].is_object() )
+            {
+                throw std::runtime_error( "Operation is not a JSON object" );
+            }
+
+            const auto& operation = patch[i].get_object();
+            const auto  op        = memberString( operation, "op" );
+            const auto  path      = memberString( operation, "path" );
+
+            CAFFA_TRACE( "Applying JSON patch operation " << op << " on " << path );
+
+            if ( op == "add" )
+            {
+                addValue( resolve( root, path, true ), memberValue( operation ), m_jsonSerializer );
+            }
+            else if ( op == "remove" )
+            {
+                removeValue( resolve( root, path, false ), m_jsonSerializer );
+            }
+            else if ( op == "replace" )
+            {
+                replaceValue( resolve( root, path, false ), memberValue( operation ), m_jsonSerializer );
+            }
+            else if ( op == "move" )
+            {
+                moveValue( root, memberString( operation, "from" ), path, m_jsonSerializer );
+            }
+            else if ( op == "copy" )
+            {
+                auto value = getValue( resolve( root, memberString( operation, "from" ), false ), m_copySerializer );
+                addValue( resolve( root, path, true ), value, m_copySerializer );
+            }
+            else if ( op == "test" )
+            {
+                auto value = getValue( resolve( root, path, false ), m_jsonSerializer );
+                if ( !jsonEqual( value, memberValue( operation ) ) )
+                {
+                    throw std::runtime_error( "Test of '" + path + "' failed" );
+                }
+            }
+            else
+            {
+                throw std::runtime_error( "Unknown operation '" + op + "'" );
+            }
+        }
+        catch ( const std::exception& e )
+        {
+            std::string errorMessage = "Failed to apply JSON patch operation " + std::to_string( i ) + ": " + e.what();
+            CAFFA_ERROR( errorMessage );
+            throw std::runtime_error( errorMessage );
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonPatch::applyFromString( ObjectHandle* root, const std::string& patch ) const
+{
+    auto jsonPatch = json::parse( patch );
+    if ( !jsonPatch.is_array() )
+    {
+        throw std::runtime_error( "JSON patch is not an array of operations" );
+    }
+    apply( root, jsonPatch.get_array() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+json::value JsonPatch::valueAt( const ObjectHandle* root, const std::string& pointer ) const
+{
+    CAFFA_ASSERT( root );
+
+    // Resolving only looks up fields and objects and does not change anything
+    return getValue( resolve( const_cast<ObjectHandle*>( root ), pointer, false ), m_jsonSerializer );
+}
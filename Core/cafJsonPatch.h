@@ -0,0 +1,82 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+#include "cafJsonSerializer.h"
+
+#include <string>
+
+namespace caffa
+{
+class ObjectFactory;
+class ObjectHandle;
+
+/**
+ * Applies RFC 6902 JSON Patch documents directly to an object tree.
+ *
+ * Paths are RFC 6901 JSON Pointers through the data layout of the tree. A token names a field of the current
+ * object, an index into a child array field or "-" for the end of a child array field. A child field is followed
+ * straight into its object, so "/Children/3/Single/Name" addresses the Name field of the object held in the Single
+ * field of the fourth object of the Children field. Tokens after a data field address the inside of its JSON value.
+ *
+ * Objects are inserted, removed and moved in place, so the cost of an operation does not depend on the size of the
+ * child array it touches. New objects are created with the object factory and field values are set through the
+ * fields, so value validators are run. Inside data fields the whole field value is replaced.
+ *
+ * Operations are applied in order and the first failing operation throws std::runtime_error. The operations before
+ * it stay applied, so "test" operations should be placed first when a patch must be applied fully or not at all.
+ */
+class JsonPatch
+{
+public:
+    /**
+     * Constructor
+     * @param objectFactory The factory used when creating new objects
+     */
+    explicit JsonPatch( ObjectFactory* objectFactory = nullptr );
+
+    /**
+     * Apply a patch to an object tree. Throws std::runtime_error if an operation fails.
+     * @param root The root of the object tree
+     * @param patch Array of add, remove, replace, move, copy and test operations
+     */
+    void apply( ObjectHandle* root, const json::array& patch ) const;
+
+    /**
+     * Apply a patch from a JSON string to an object tree. Throws std::runtime_error if an operation fails.
+     * @param root The root of the object tree
+     * @param patch JSON string with an array of operations
+     */
+    void applyFromString( ObjectHandle* root, const std::string& patch ) const;
+
+    /**
+     * Get the JSON value at a JSON Pointer. Throws std::runtime_error if the pointer does not resolve.
+     * @param root The root of the object tree
+     * @param pointer The JSON Pointer
+     * @return the value, which is the data of the full sub tree for objects and child fields
+     */
+    [[nodiscard]] json::value valueAt( const ObjectHandle* root, const std::string& pointer ) const;
+
+private:
+    JsonSerializer m_jsonSerializer;
+    JsonSerializer m_copySerializer;
+};
+
+} // namespace caffa
@@ -0,0 +1,151 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonSchemaCache.h"
+
+#include "cafAssert.h"
+
+#include <mutex>
+
+using namespace caffa;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<JsonSchemaCache> JsonSchemaCache::instance()
+{
+    static auto cache = std::make_shared<JsonSchemaCache>();
+    return cache;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::optional<json::object> JsonSchemaCache::find( std::string_view classKeyword,
+                                                   std::uint64_t    factoryIdentity,
+                                                   std::string_view selectorKey ) const
+{
+    const SchemaKey key( factoryIdentity, selectorKey );
+
+    std::shared_lock lock( m_mutex );
+
+    if ( auto classIt = m_schemas.find( classKeyword ); classIt != m_schemas.end() )
+    {
+        if ( auto schemaIt = classIt->second.find( key ); schemaIt != classIt->second.end() )
+        {
+            return schemaIt->second;
+        }
+    }
+    return std::nullopt;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSchemaCache::insert( std::string_view classKeyword,
+                              std::uint64_t    factoryIdentity,
+                              std::string_view selectorKey,
+                              json::object     schema )
+{
+    std::unique_lock lock( m_mutex );
+
+    auto classIt = m_schemas.find( classKeyword );
+    if ( classIt == m_schemas.end() )
+    {
+        classIt = m_schemas.emplace( std::string( classKeyword ), SelectorMap() ).first;
+    }
+    classIt->second.insert_or_assign( SchemaKey( factoryIdentity, selectorKey ), std::move( schema ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const ObjectSchemas> JsonSchemaCache::findObjectSchemas( std::uint64_t    factoryIdentity,
+                                                                         std::string_view selectorKey,
+                                                                         std::uint64_t    generation ) const
+{
+    const SchemaKey key( factoryIdentity, selectorKey );
+
+    std::shared_lock lock( m_mutex );
+
+    auto it = m_objectSchemas.find( key );
+    if ( it != m_objectSchemas.end() && it->second->generation == generation ) return it->second;
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSchemaCache::insertObjectSchemas( std::string_view selectorKey, std::shared_ptr<const ObjectSchemas> schemas )
+{
+    CAFFA_ASSERT( schemas );
+
+    SchemaKey key( schemas->factoryIdentity, selectorKey );
+
+    std::unique_lock lock( m_mutex );
+
+    auto it = m_objectSchemas.find( key );
+    if ( it == m_objectSchemas.end() )
+    {
+        m_objectSchemas.emplace( std::move( key ), std::move( schemas ) );
+    }
+    else if ( schemas->generation >= it->second->generation )
+    {
+        // Do not replace schemas written for a newer generation by a slower writer
+        it->second = std::move( schemas );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSchemaCache::invalidate( std::string_view classKeyword )
+{
+    std::unique_lock lock( m_mutex );
+
+    if ( auto classIt = m_schemas.find( classKeyword ); classIt != m_schemas.end() )
+    {
+        m_schemas.erase( classIt );
+    }
+    m_objectSchemas.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSchemaCache::clear()
+{
+    std::unique_lock lock( m_mutex );
+    m_schemas.clear();
+    m_objectSchemas.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t JsonSchemaCache::size() const
+{
+    std::shared_lock lock( m_mutex );
+
+    size_t count = 0u;
+    for ( const auto& [classKeyword, selectorMap] : m_schemas )
+    {
+        count += selectorMap.size();
+    }
+    return count;
+}
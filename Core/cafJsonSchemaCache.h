@@ -0,0 +1,135 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace caffa
+{
+/**
+ * The schemas of all classes an object factory can create, as written by
+ * JsonSerializer::writeObjectSchemas(). Holds the object_schemas component of an OpenAPI document both as JSON and
+ * as serialized text, so it can be sent without any further work.
+ */
+struct ObjectSchemas
+{
+    std::uint64_t factoryIdentity = 0u; ///< The identity of the object factory the schemas were written for
+    std::uint64_t generation      = 0u; ///< The generation of the object factory the schemas were written for
+    json::object  schemas;              ///< The schema of each class keyed by class keyword
+    std::string   text;                 ///< The schemas serialized as compact JSON
+};
+
+/**
+ * Thread safe cache of the JSON schemas of object classes.
+ *
+ * Schemas are stored per class keyword, object factory and field selector key, so a schema is generated once for each
+ * class, factory and field selector configuration. The factory is part of the key since the same class keyword may be
+ * registered with a different parent class in another factory. Lookups take a shared lock and may run concurrently.
+ * The cache does not know when a class changes, so entries have to be invalidated explicitly if the fields,
+ * documentation or validators of a class are changed after its schema has been written.
+ */
+class JsonSchemaCache
+{
+public:
+    /**
+     * The cache used by JsonSerializer unless another one is set
+     */
+    static std::shared_ptr<JsonSchemaCache> instance();
+
+    JsonSchemaCache() = default;
+
+    JsonSchemaCache( const JsonSchemaCache& )            = delete;
+    JsonSchemaCache& operator=( const JsonSchemaCache& ) = delete;
+
+    /**
+     * Look up a schema
+     * @param classKeyword The class keyword
+     * @param factoryIdentity The identity of the object factory used when writing the schema
+     * @param selectorKey The key of the field selector used when writing the schema. Empty for no selector.
+     * @return a copy of the schema or nullopt if there is no entry
+     */
+    [[nodiscard]] std::optional<json::object>
+        find( std::string_view classKeyword, std::uint64_t factoryIdentity, std::string_view selectorKey ) const;
+
+    /**
+     * Store a schema, replacing any existing entry
+     * @param classKeyword The class keyword
+     * @param factoryIdentity The identity of the object factory used when writing the schema
+     * @param selectorKey The key of the field selector used when writing the schema. Empty for no selector.
+     * @param schema The schema
+     */
+    void insert( std::string_view classKeyword,
+                 std::uint64_t    factoryIdentity,
+                 std::string_view selectorKey,
+                 json::object     schema );
+
+    /**
+     * Look up the schemas of all classes
+     * @param factoryIdentity The identity of the object factory
+     * @param selectorKey The key of the field selector used when writing the schemas. Empty for no selector.
+     * @param generation The current generation of the object factory. Schemas for another generation are ignored.
+     * @return the schemas or nullptr if there is no entry for the generation
+     */
+    [[nodiscard]] std::shared_ptr<const ObjectSchemas> findObjectSchemas( std::uint64_t    factoryIdentity,
+                                                                          std::string_view selectorKey,
+                                                                          std::uint64_t    generation ) const;
+
+    /**
+     * Store the schemas of all classes, replacing any existing entry for their object factory and the field selector
+     * @param selectorKey The key of the field selector used when writing the schemas. Empty for no selector.
+     * @param schemas The schemas
+     */
+    void insertObjectSchemas( std::string_view selectorKey, std::shared_ptr<const ObjectSchemas> schemas );
+
+    /**
+     * Remove the schemas of a class for all field selectors, along with the schemas of all classes
+     * @param classKeyword The class keyword
+     */
+    void invalidate( std::string_view classKeyword );
+
+    /**
+     * Remove all schemas
+     */
+    void clear();
+
+    /**
+     * The number of cached class schemas across all classes and field selectors
+     */
+    [[nodiscard]] size_t size() const;
+
+private:
+    /// The identity of the object factory and the field selector key
+    using SchemaKey   = std::pair<std::uint64_t, std::string>;
+    using SelectorMap = std::map<SchemaKey, json::object>;
+
+    mutable std::shared_mutex                                 m_mutex;
+    std::map<std::string, SelectorMap, std::less<>>           m_schemas;
+    std::map<SchemaKey, std::shared_ptr<const ObjectSchemas>> m_objectSchemas;
+};
+
+} // namespace caffa
@@ -0,0 +1,81 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafFieldProjection.h"
+
+namespace caffa
+{
+/**
+ * Traversal state of a single write through a JsonSerializer.
+ *
+ * The serializer only holds configuration and is never modified while writing, so one serializer can be shared by
+ * any number of threads. Whatever changes while walking down the object tree is passed along in a context instead.
+ * The serializer hands each field the context for the objects held by that field, and fields holding child objects
+ * pass it on when writing them.
+ */
+class JsonSerializationContext
+{
+public:
+    /**
+     * The context of the object a write starts from
+     */
+    JsonSerializationContext()
+        : m_level( 0 )
+        , m_projection( nullptr )
+    {
+    }
+
+    /**
+     * The context for the objects held by the fields of an object written in this context
+     * @param projection The fields to write for the child objects or nullptr for all fields
+     */
+    [[nodiscard]] JsonSerializationContext childContext( const FieldProjection::Node* projection = nullptr ) const
+    {
+        return JsonSerializationContext( m_level + 1, projection );
+    }
+
+    /**
+     * The number of objects above the current one. 0 for the object the write started from.
+     */
+    [[nodiscard]] int level() const { return m_level; }
+
+    /**
+     * Check if this is the context of the object the write started from
+     */
+    [[nodiscard]] bool isTopLevel() const { return m_level == 0; }
+
+    /**
+     * The fields to write for objects below the top level. nullptr for all fields.
+     * The object a write starts from uses the projection of the serializer.
+     */
+    [[nodiscard]] const FieldProjection::Node* projection() const { return m_projection; }
+
+private:
+    JsonSerializationContext( int level, const FieldProjection::Node* projection )
+        : m_level( level )
+        , m_projection( projection )
+    {
+    }
+
+    int                          m_level;
+    const FieldProjection::Node* m_projection;
+};
+
+} // namespace caffa
@@ -21,20 +21,88 @@
 #include "cafAssert.h"
 #include "cafDefaultObjectFactory.h"
 #include "cafFieldIoCapability.h"
+#include "cafJsonSchemaCache.h"
+#include "cafJsonStreamReader.h"
+#include "cafJsonStreamWriter.h"
 #include "cafLogger.h"
+#include "cafMappedFile.h"
 #include "cafObjectHandle.h"
 #include "cafObjectPerformer.h"
+#include "cafParallelFor.h"
+#include "cafSerializationPlan.h"
 
 #include "cafFieldHandle.h"
 
 #include <boost/json.hpp>
 
+#include <algorithm>
+#include <fstream>
 #include <iomanip>
+#include <map>
+#include <optional>
 #include <set>
 #include <utility>
+#include <vector>
 
 using namespace caffa;
 
+namespace
+{
+/// The projection for the fields of an object. The object a write starts from uses the root of the projection.
+const FieldProjection::Node* objectProjection( const JsonSerializer&           serializer,
+                                              const JsonSerializationContext& context )
+{
+    if ( context.isTopLevel() )
+    {
+        return serializer.projection() ? &serializer.projection()->root() : nullptr;
+    }
+    return context.projection();
+}
+
+/// Find the projection for the objects held by a field. Returns false if the field is outside the projection.
+bool projectField( const FieldProjection::Node*  projection,
+                   std::string_view              keyword,
+                   const FieldProjection::Node*& fieldProjection )
+{
+    fieldProjection = nullptr;
+    if ( !projection ) return true;
+
+    const auto* node = projection->field( keyword );
+    if ( !node ) return false;
+
+    if ( !node->selectsAll() ) fieldProjection = node;
+    return true;
+}
+
+/// Hands out already created objects instead of new ones, so schemas can be written from several threads without
+/// calling an object factory which is not thread safe. The objects are shared and must only be read.
+class PrototypeFactory final : public ObjectFactory
+{
+public:
+    PrototypeFactory( std::map<std::string, std::shared_ptr<ObjectHandle>, std::less<>> prototypes,
+                      std::uint64_t                                                     identity )
+        : m_prototypes( std::move( prototypes ) )
+        , m_identity( identity )
+    {
+    }
+
+    [[nodiscard]] std::string name() const override { return "Prototype ObjectFactory"; }
+
+    // The schemas written with the prototypes are those of the factory they were created by
+    [[nodiscard]] std::uint64_t identity() const override { return m_identity; }
+
+private:
+    std::shared_ptr<ObjectHandle> doCreate( const std::string_view& classKeyword ) override
+    {
+        auto it = m_prototypes.find( classKeyword );
+        return it != m_prototypes.end() ? it->second : nullptr;
+    }
+
+    std::map<std::string, std::shared_ptr<ObjectHandle>, std::less<>> m_prototypes;
+    std::uint64_t                                                     m_identity;
+};
+} // namespace
+
 std::string JsonSerializer::serializationTypeLabel( SerializationType type )
 {
     switch ( type )
@@ -58,15 +126,37 @@ std::string JsonSerializer::serializationTypeLabel( SerializationType type )
 JsonSerializer::JsonSerializer( ObjectFactory* objectFactory /* = nullptr */ )
     : m_client( false )
     , m_objectFactory( objectFactory == nullptr ? DefaultObjectFactory::instance().get() : objectFactory )
+    , m_schemaCache( JsonSchemaCache::instance().get() )
     , m_serializationType( SerializationType::DATA_FULL )
     , m_serializeUuids( true )
-    , m_level( -1 )
+    , m_packNumericArrays( false )
+    , m_parallelWriteGrainSize( 0u )
+    , m_parallelReadThreshold( 0u )
+    , m_lazyChildren( false )
+    , m_reconcileChildren( false )
 {
+    if ( m_objectFactory == DefaultObjectFactory::instance().get() )
+    {
+        m_sharedObjectFactory = DefaultObjectFactory::instance();
+    }
 }
 
-JsonSerializer& JsonSerializer::setFieldSelector( FieldSelector fieldSelector )
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonSerializer::JsonSerializer( std::shared_ptr<ObjectFactory> objectFactory )
+    : JsonSerializer( objectFactory.get() )
 {
-    m_fieldSelector = std::move( fieldSelector );
+    if ( objectFactory )
+    {
+        m_sharedObjectFactory = std::move( objectFactory );
+    }
+}
+
+JsonSerializer& JsonSerializer::setFieldSelector( FieldSelector fieldSelector, std::string selectorKey /* = "" */ )
+{
+    m_fieldSelector    = std::move( fieldSelector );
+    m_fieldSelectorKey = std::move( selectorKey );
     return *this;
 }
 
@@ -82,6 +172,18 @@ JsonSerializer& JsonSerializer::setSerializeUuids( bool serializeUuids )
     return *this;
 }
 
+JsonSerializer& JsonSerializer::setSchemaCache( JsonSchemaCache* schemaCache )
+{
+    m_schemaCache = schemaCache;
+    return *this;
+}
+
+JsonSerializer& JsonSerializer::setPackNumericArrays( bool packNumericArrays )
+{
+    m_packNumericArrays = packNumericArrays;
+    return *this;
+}
+
 ObjectFactory* JsonSerializer::objectFactory() const
 {
     return m_objectFactory;
@@ -92,6 +194,33 @@ JsonSerializer::FieldSelector JsonSerializer::fieldSelector() const
     return m_fieldSelector;
 }
 
+const std::string& JsonSerializer::fieldSelectorKey() const
+{
+    return m_fieldSelectorKey;
+}
+
+std::string JsonSerializer::schemaCacheKey() const
+{
+    // Packing changes the schemas of numeric vector fields
+    return m_packNumericArrays ? m_fieldSelectorKey + "#packed" : m_fieldSelectorKey;
+}
+
+JsonSerializer& JsonSerializer::setProjection( std::shared_ptr<const FieldProjection> projection )
+{
+    m_projection = std::move( projection );
+    return *this;
+}
+
+const std::shared_ptr<const FieldProjection>& JsonSerializer::projection() const
+{
+    return m_projection;
+}
+
+JsonSchemaCache* JsonSerializer::schemaCache() const
+{
+    return m_schemaCache;
+}
+
 JsonSerializer::SerializationType JsonSerializer::serializationType() const
 {
     return m_serializationType;
@@ -102,6 +231,67 @@ bool JsonSerializer::serializeUuids() const
     return m_serializeUuids;
 }
 
+bool JsonSerializer::packNumericArrays() const
+{
+    return m_packNumericArrays;
+}
+
+JsonSerializer& JsonSerializer::setParallelWriteGrainSize( size_t grainSize )
+{
+    m_parallelWriteGrainSize = grainSize;
+    return *this;
+}
+
+size_t JsonSerializer::parallelWriteGrainSize() const
+{
+    return m_parallelWriteGrainSize;
+}
+
+JsonSerializer& JsonSerializer::setParallelReadThreshold( size_t threshold )
+{
+    m_parallelReadThreshold = threshold;
+    return *this;
+}
+
+size_t JsonSerializer::parallelReadThreshold() const
+{
+    return m_parallelReadThreshold;
+}
+
+JsonSerializer& JsonSerializer::setLazyChildren( bool lazyChildren )
+{
+    m_lazyChildren = lazyChildren;
+    return *this;
+}
+
+bool JsonSerializer::lazyChildren() const
+{
+    // Lazy children keep a copy of the serializer, which must not refer to a factory that may be destroyed
+    return m_lazyChildren && m_sharedObjectFactory != nullptr;
+}
+
+JsonSerializer& JsonSerializer::setReconcileChildren( bool reconcileChildren )
+{
+    m_reconcileChildren = reconcileChildren;
+    return *this;
+}
+
+bool JsonSerializer::reconcileChildren() const
+{
+    return m_reconcileChildren;
+}
+
+JsonSerializer& JsonSerializer::setMemoryResource( json::storage_ptr memoryResource )
+{
+    m_memoryResource = std::move( memoryResource );
+    return *this;
+}
+
+const json::storage_ptr& JsonSerializer::memoryResource() const
+{
+    return m_memoryResource;
+}
+
 JsonSerializer& JsonSerializer::setClient( bool client )
 {
     m_client = client;
@@ -131,8 +321,6 @@ void JsonSerializer::readObjectFromJson( ObjectHandle* object, const json::objec
         return;
     }
 
-    ++m_level;
-
     if ( this->serializeUuids() )
     {
         if ( auto it = jsonObject.find( "uuid" ); it != jsonObject.end() )
@@ -147,6 +335,9 @@ void JsonSerializer::readObjectFromJson( ObjectHandle* object, const json::objec
         CAFFA_ASSERT( jsonObject.contains( "uuid" ) );
     }
 
+    std::optional<SerializationPlan> ownPlan;
+    const auto&                      plan = SerializationPlan::forObject( object, ownPlan );
+
     for ( const auto& [keyword, value] : jsonObject )
     {
         CAFFA_TRACE( "Reading field: " << keyword << " with value " << json::dump( value ) );
@@ -164,19 +355,14 @@ void JsonSerializer::readObjectFromJson( ObjectHandle* object, const json::objec
         }
         else if ( this->serializationType() == SerializationType::DATA_FULL && !value.is_null() && keyword != "methods" )
         {
-            if ( auto fieldHandle = object->findField( keyword );
-                 fieldHandle && fieldHandle->capability<FieldIoCapability>() && fieldHandle->isWritable() )
+            const auto*        entry         = plan.findEntry( keyword );
+            FieldHandle*       fieldHandle   = entry ? SerializationPlan::field( object, *entry ) : nullptr;
+            FieldIoCapability* ioFieldHandle = entry ? SerializationPlan::ioCapability( fieldHandle, *entry ) : nullptr;
+            if ( ioFieldHandle && fieldHandle->isWritable() )
             {
                 if ( this->fieldSelector() && !this->fieldSelector()( fieldHandle ) ) continue;
 
-                if ( auto ioFieldHandle = fieldHandle->capability<FieldIoCapability>(); ioFieldHandle )
-                {
-                    ioFieldHandle->readFromJson( value, *this );
-                }
-                else
-                {
-                    throw std::runtime_error( "Field handle " + std::string( keyword ) + " not readable" );
-                }
+                ioFieldHandle->readFromJson( value, *this );
             }
             else
             {
@@ -185,8 +371,6 @@ void JsonSerializer::readObjectFromJson( ObjectHandle* object, const json::objec
             }
         }
     }
-
-    --m_level;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -194,16 +378,38 @@ void JsonSerializer::readObjectFromJson( ObjectHandle* object, const json::objec
 //--------------------------------------------------------------------------------------------------
 void JsonSerializer::writeObjectToJson( const ObjectHandle* object, json::object& jsonObject ) const
 {
-    ++m_level;
+    writeObjectToJson( object, jsonObject, JsonSerializationContext() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::writeObjectToJson( const ObjectHandle*             object,
+                                        json::object&                   jsonObject,
+                                        const JsonSerializationContext& context ) const
+{
     if ( !object ) return;
 
     CAFFA_TRACE( "Writing fields for "
                  << object->classKeyword() << " -> " << ( isClient() ? "client" : "server" )
                  << " from json with serialize setting: type = " << serializationTypeLabel( this->serializationType() )
-                 << ", serializeUuids = " << this->serializeUuids() << ", level: " << m_level );
+                 << ", serializeUuids = " << this->serializeUuids() << ", level: " << context.level() );
 
     if ( this->serializationType() == SerializationType::SCHEMA )
     {
+        // A selector without a key can not be told apart from any other selector, so its schemas are not cached
+        JsonSchemaCache*  schemaCache = this->fieldSelector() && m_fieldSelectorKey.empty() ? nullptr : m_schemaCache;
+        const std::string cacheKey    = schemaCacheKey();
+        if ( schemaCache )
+        {
+            auto cachedSchema = schemaCache->find( object->classKeyword(), m_objectFactory->identity(), cacheKey );
+            if ( cachedSchema )
+            {
+                jsonObject = std::move( *cachedSchema );
+                return;
+            }
+        }
+
         std::set<std::string> parentalFields;
 
         auto inheritanceStack = object->classInheritanceStack();
@@ -211,7 +417,7 @@ void JsonSerializer::writeObjectToJson( const ObjectHandle* object, json::object
         std::shared_ptr<caffa::ObjectHandle> parentClassInstance;
         for ( auto it = inheritanceStack.begin() + 1; it != inheritanceStack.end(); ++it )
         {
-            parentClassInstance = DefaultObjectFactory::instance()->create( *it );
+            parentClassInstance = m_objectFactory->create( *it );
             if ( parentClassInstance ) break;
         }
 
@@ -275,6 +481,11 @@ void JsonSerializer::writeObjectToJson( const ObjectHandle* object, json::object
         }
         jsonObject["$schema"] = "https://json-schema.org/draft/2020-12/schema";
         jsonObject["$id"]     = "/openapi.json/components/object_schemas/" + std::string( object->classKeyword() );
+
+        if ( schemaCache )
+        {
+            schemaCache->insert( object->classKeyword(), m_objectFactory->identity(), cacheKey, jsonObject );
+        }
     }
     else
     {
@@ -284,110 +495,176 @@ void JsonSerializer::writeObjectToJson( const ObjectHandle* object, json::object
             jsonObject["uuid"] = object->uuid();
         }
 
-        if ( m_level == 0 || this->serializationType() != SerializationType::DATA_SKELETON )
+        if ( context.isTopLevel() || this->serializationType() != SerializationType::DATA_SKELETON )
         {
-            for ( auto field : object->fields() )
+            const auto* projection = objectProjection( *this, context );
+
+            std::optional<SerializationPlan> ownPlan;
+            for ( const auto& entry : SerializationPlan::forObject( object, ownPlan ).entries() )
             {
-                if ( this->fieldSelector() && !this->fieldSelector()( field ) ) continue;
+                auto field = SerializationPlan::field( object, entry );
+                if ( m_fieldSelector && !m_fieldSelector( field ) ) continue;
 
-                if ( field->isDeprecated() ) continue;
+                if ( entry.deprecated ) continue;
 
-                auto keyword = field->keyword();
+                const FieldProjection::Node* fieldProjection = nullptr;
+                if ( !projectField( projection, entry.keyword, fieldProjection ) ) continue;
 
-                const FieldIoCapability* ioCapability = field->capability<FieldIoCapability>();
+                const FieldIoCapability* ioCapability = SerializationPlan::ioCapability( field, entry );
                 if ( ioCapability && field->isReadable() )
                 {
-                    json::value value;
-                    ioCapability->writeToJson( value, *this );
-                    if ( !value.is_null() ) jsonObject[keyword] = value;
+                    json::value value( jsonObject.storage() );
+                    ioCapability->writeToJson( value, *this, context.childContext( fieldProjection ) );
+                    if ( !value.is_null() ) jsonObject[entry.keyword] = std::move( value );
                 }
             }
         }
     }
-    --m_level;
 }
 
-void JsonSerializer::prettyPrint( std::ostream& os, json::value const& jv, std::string* indent ) const
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::vector<json::object> JsonSerializer::writeObjectsToJson( std::span<const std::shared_ptr<ObjectHandle>> objects,
+                                                              const JsonSerializationContext& context,
+                                                              json::storage_ptr storage /* = {} */ ) const
 {
-    constexpr size_t indentSize = 2;
-    std::string      indent_;
-    if ( !indent ) indent = &indent_;
-    switch ( jv.kind() )
+    std::vector<json::object> jsonObjects;
+    jsonObjects.reserve( objects.size() );
+    for ( size_t i = 0; i < objects.size(); ++i )
     {
-        case boost::json::kind::object:
-        {
-            os << "{\n";
-            indent->append( indentSize, ' ' );
-            auto const& obj = jv.get_object();
-            if ( !obj.empty() )
-            {
-                auto it = obj.begin();
-                for ( ;; )
-                {
-                    os << *indent << boost::json::serialize( it->key() ) << " : ";
-                    prettyPrint( os, it->value(), indent );
-                    if ( ++it == obj.end() ) break;
-                    os << ",\n";
-                }
-            }
-            os << "\n";
-            indent->resize( indent->size() - indentSize );
-            os << *indent << "}";
-            break;
-        }
-        case boost::json::kind::array:
+        jsonObjects.emplace_back( storage );
+    }
+
+    // Memory resources other than the default heap are not safe to allocate from on several threads
+    const bool usesDefaultResource = storage.get() == json::storage_ptr().get();
+
+    if ( m_parallelWriteGrainSize == 0u || objects.size() <= m_parallelWriteGrainSize || !usesDefaultResource )
+    {
+        for ( size_t i = 0; i < objects.size(); ++i )
         {
-            os << "[\n";
-            indent->append( indentSize, ' ' );
-            auto const& arr = jv.get_array();
-            if ( !arr.empty() )
-            {
-                auto it = arr.begin();
-                for ( ;; )
-                {
-                    os << *indent;
-                    prettyPrint( os, *it, indent );
-                    if ( ++it == arr.end() ) break;
-                    os << ",\n";
-                }
-            }
-            os << "\n";
-            indent->resize( indent->size() - indentSize );
-            os << *indent << "]";
-            break;
+            writeObjectToJson( objects[i].get(), jsonObjects[i], context );
         }
+        return jsonObjects;
+    }
 
-        case boost::json::kind::string:
+    parallelFor( objects.size(),
+                 m_parallelWriteGrainSize,
+                 [this, &objects, &jsonObjects, &context]( size_t begin, size_t end )
+                 {
+                     for ( size_t i = begin; i < end; ++i )
+                     {
+                         writeObjectToJson( objects[i].get(), jsonObjects[i], context );
+                     }
+                 } );
+    return jsonObjects;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::writeObjectToStream( const ObjectHandle* object, JsonStreamWriter& writer ) const
+{
+    writeObjectToStream( object, writer, JsonSerializationContext() );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::writeObjectToStream( const ObjectHandle*             object,
+                                          JsonStreamWriter&               writer,
+                                          const JsonSerializationContext& context ) const
+{
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        json::object jsonObject( m_memoryResource );
+        writeObjectToJson( object, jsonObject, context );
+        writer.value( jsonObject );
+        return;
+    }
+
+    writer.beginObject();
+    if ( !object )
+    {
+        writer.endObject();
+        return;
+    }
+
+    CAFFA_TRACE( "Streaming fields for " << object->classKeyword() << " with serialize setting: type = "
+                                         << serializationTypeLabel( this->serializationType() )
+                                         << ", serializeUuids = " << this->serializeUuids()
+                                         << ", level: " << context.level() );
+
+    writer.key( "keyword" );
+    writer.string( object->classKeyword() );
+    if ( this->serializeUuids() && !object->uuid().empty() )
+    {
+        writer.key( "uuid" );
+        writer.string( object->uuid() );
+    }
+
+    if ( context.isTopLevel() || this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        const auto* projection = objectProjection( *this, context );
+
+        std::optional<SerializationPlan> ownPlan;
+        for ( const auto& entry : SerializationPlan::forObject( object, ownPlan ).entries() )
         {
-            os << boost::json::serialize( jv.get_string() );
-            break;
-        }
+            auto field = SerializationPlan::field( object, entry );
+            if ( m_fieldSelector && !m_fieldSelector( field ) ) continue;
 
-        case boost::json::kind::uint64:
-            os << jv.get_uint64();
-            break;
+            if ( entry.deprecated ) continue;
 
-        case boost::json::kind::int64:
-            os << jv.get_int64();
-            break;
+            const FieldProjection::Node* fieldProjection = nullptr;
+            if ( !projectField( projection, entry.keyword, fieldProjection ) ) continue;
 
-        case boost::json::kind::double_:
-            os << jv.get_double();
-            break;
+            const FieldIoCapability* ioCapability = SerializationPlan::ioCapability( field, entry );
+            if ( ioCapability && field->isReadable() )
+            {
+                ioCapability->writeToStream( writer, *this, context.childContext( fieldProjection ) );
+            }
+        }
+    }
+    writer.endObject();
+}
 
-        case boost::json::kind::bool_:
-            if ( jv.get_bool() )
-                os << "true";
-            else
-                os << "false";
-            break;
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::prettyPrint( std::ostream& os, json::value const& jv ) const
+{
+    JsonStreamWriter writer( os, true );
+    writer.value( jv );
+    writer.flush();
+}
 
-        case boost::json::kind::null:
-            os << "null";
-            break;
+//--------------------------------------------------------------------------------------------------
+/// Strings in the output are escaped, so every line break in it is one written by the pretty printer
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::prettyPrint( std::ostream& os, json::value const& jv, std::string* indent ) const
+{
+    if ( !indent || indent->empty() )
+    {
+        prettyPrint( os, jv );
+        return;
+    }
+
+    std::string text;
+    {
+        JsonStreamWriter writer( text, true );
+        writer.value( jv );
     }
+    if ( !text.empty() && text.back() == '\n' ) text.pop_back();
 
-    if ( indent->empty() ) os << "\n";
+    size_t lineStart = 0u;
+    for ( size_t lineEnd = text.find( '\n' ); lineEnd != std::string::npos; lineEnd = text.find( '\n', lineStart ) )
+    {
+        os.write( text.data() + lineStart, static_cast<std::streamsize>( lineEnd + 1u - lineStart ) );
+        os << *indent;
+        lineStart = lineEnd + 1u;
+    }
+    os.write( text.data() + lineStart, static_cast<std::streamsize>( text.size() - lineStart ) );
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -409,8 +686,18 @@ std::string JsonSerializer::readUUIDFromObjectString( const std::string& string
 //--------------------------------------------------------------------------------------------------
 void JsonSerializer::readObjectFromString( ObjectHandle* object, const std::string& string ) const
 {
-    const json::value jsonValue = json::parse( string );
-    readObjectFromJson( object, jsonValue.as_object() );
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        CAFFA_ERROR( "Reading JSON into objects only makes sense for data" );
+        return;
+    }
+
+    CAFFA_ASSERT( object );
+
+    JsonStreamReader reader( *this, object );
+    reader.write( string );
+    reader.finish();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -418,22 +705,117 @@ void JsonSerializer::readObjectFromString( ObjectHandle* object, const std::stri
 //--------------------------------------------------------------------------------------------------
 std::string JsonSerializer::writeObjectToString( const ObjectHandle* object, bool pretty /*=false*/ ) const
 {
-    json::object jsonObject;
+    if ( this->serializationType() == SerializationType::DATA_FULL ||
+         this->serializationType() == SerializationType::DATA_SKELETON )
+    {
+        std::string string;
+        {
+            JsonStreamWriter writer( string, pretty );
+            writeObjectToStream( object, writer );
+        }
+        return string;
+    }
+
+    json::object jsonObject( m_memoryResource );
     writeObjectToJson( object, jsonObject );
     if ( pretty )
     {
-        std::stringstream ss;
-        prettyPrint( ss, jsonObject );
-        return ss.str();
+        std::string string;
+        {
+            JsonStreamWriter writer( string, true );
+            writer.value( jsonObject );
+        }
+        return string;
     }
     return json::dump( jsonObject );
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const ObjectSchemas> JsonSerializer::writeObjectSchemas() const
+{
+    const auto generation      = m_objectFactory->generation();
+    const auto factoryIdentity = m_objectFactory->identity();
+
+    // A selector without a key can not be told apart from any other selector, so its schemas are not cached.
+    // Neither are the schemas of a factory which does not keep track of its classes.
+    JsonSchemaCache* schemaCache =
+        ( this->fieldSelector() && m_fieldSelectorKey.empty() ) || generation == 0u ? nullptr : m_schemaCache;
+    const std::string cacheKey = schemaCacheKey();
+    if ( schemaCache )
+    {
+        auto cachedSchemas = schemaCache->findObjectSchemas( factoryIdentity, cacheKey, generation );
+        if ( cachedSchemas )
+        {
+            return cachedSchemas;
+        }
+    }
+
+    // Object constructors and the factory are not known to be thread safe, so the objects are created up front
+    std::vector<std::string>                                          classKeywords;
+    std::vector<std::shared_ptr<ObjectHandle>>                        objects;
+    std::map<std::string, std::shared_ptr<ObjectHandle>, std::less<>> prototypes;
+    for ( const auto& classKeyword : m_objectFactory->classKeywords() )
+    {
+        if ( auto object = m_objectFactory->create( classKeyword ); object )
+        {
+            classKeywords.push_back( classKeyword );
+            objects.push_back( object );
+            prototypes.emplace( classKeyword, std::move( object ) );
+        }
+    }
+
+    // The schema of a class needs an instance of its parent class, which is served from the objects created above
+    PrototypeFactory prototypeFactory( std::move( prototypes ), factoryIdentity );
+    JsonSerializer   schemaSerializer( *this );
+    schemaSerializer.setSerializationType( SerializationType::SCHEMA );
+    schemaSerializer.m_objectFactory = &prototypeFactory;
+    schemaSerializer.m_sharedObjectFactory.reset();
+
+    std::vector<json::object> classSchemas( classKeywords.size() );
+
+    // Use a few chunks per thread, since the classes may differ a lot in size
+    const size_t grainSize = std::max( classKeywords.size() / ( parallelThreadCount() * 8u ), size_t( 1u ) );
+    parallelFor( classKeywords.size(),
+                 grainSize,
+                 [&objects, &classSchemas, &schemaSerializer]( size_t begin, size_t end )
+                 {
+                     for ( size_t i = begin; i < end; ++i )
+                     {
+                         schemaSerializer.writeObjectToJson( objects[i].get(), classSchemas[i] );
+                     }
+                 } );
+
+    auto objectSchemas        = std::make_shared<ObjectSchemas>();
+    objectSchemas->factoryIdentity = factoryIdentity;
+    objectSchemas->generation      = generation;
+    for ( size_t i = 0; i < classKeywords.size(); ++i )
+    {
+        if ( !classSchemas[i].empty() )
+        {
+            objectSchemas->schemas.emplace( classKeywords[i], std::move( classSchemas[i] ) );
+        }
+    }
+    objectSchemas->text = boost::json::serialize( objectSchemas->schemas );
+
+    if ( schemaCache )
+    {
+        schemaCache->insertObjectSchemas( cacheKey, objectSchemas );
+    }
+    return objectSchemas;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
 std::shared_ptr<ObjectHandle> JsonSerializer::copyBySerialization( const ObjectHandle* object ) const
 {
+    if ( this->serializationType() == SerializationType::DATA_FULL )
+    {
+        return copyObject( object );
+    }
+
     const std::string string = writeObjectToString( object );
 
     std::shared_ptr<ObjectHandle> objectCopy = createObjectFromString( string );
@@ -448,8 +830,6 @@ std::shared_ptr<ObjectHandle> JsonSerializer::copyBySerialization( const ObjectH
 std::shared_ptr<ObjectHandle> JsonSerializer::copyAndCastBySerialization( const ObjectHandle* object,
                                                                           const std::string_view& destinationClassKeyword ) const
 {
-    std::string string = writeObjectToString( object );
-
     std::shared_ptr<ObjectHandle> objectCopy = m_objectFactory->create( destinationClassKeyword );
 
     bool sourceInheritsDestination =
@@ -459,12 +839,83 @@ std::shared_ptr<ObjectHandle> JsonSerializer::copyAndCastBySerialization( const
 
     if ( !sourceInheritsDestination && !destinationInheritsSource ) return nullptr;
 
-    const json::value jsonValue = json::parse( string );
+    if ( this->serializationType() == SerializationType::DATA_FULL )
+    {
+        copyObjectFields( object, objectCopy.get() );
+        return objectCopy;
+    }
+
+    std::string string = writeObjectToString( object );
+
+    const json::value jsonValue = json::parse( string, m_memoryResource );
     readObjectFromJson( objectCopy.get(), jsonValue.as_object() );
 
     return objectCopy;
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> JsonSerializer::copyObject( const ObjectHandle* object ) const
+{
+    if ( !object ) return nullptr;
+
+    std::shared_ptr<ObjectHandle> objectCopy = m_objectFactory->create( object->classKeyword() );
+    if ( !objectCopy ) return nullptr;
+
+    copyObjectFields( object, objectCopy.get() );
+    return objectCopy;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::copyObjectFields( const ObjectHandle* source, ObjectHandle* destination ) const
+{
+    CAFFA_ASSERT( source && destination );
+
+    if ( this->serializeUuids() && !source->uuid().empty() )
+    {
+        destination->setUuid( source->uuid() );
+    }
+
+    std::optional<SerializationPlan> ownSourcePlan;
+    std::optional<SerializationPlan> ownDestinationPlan;
+    const auto&                      destinationPlan = SerializationPlan::forObject( destination, ownDestinationPlan );
+
+    for ( const auto& entry : SerializationPlan::forObject( source, ownSourcePlan ).entries() )
+    {
+        auto field = SerializationPlan::field( source, entry );
+        if ( this->fieldSelector() && !this->fieldSelector()( field ) ) continue;
+
+        if ( entry.deprecated ) continue;
+
+        const FieldIoCapability* sourceCapability = SerializationPlan::ioCapability( field, entry );
+        if ( !sourceCapability || !field->isReadable() ) continue;
+
+        // Null values are skipped when reading JSON, so the destination does not need to have the field
+        if ( sourceCapability->writesNull( *this ) ) continue;
+
+        const auto*        destinationEntry = destinationPlan.findEntry( entry.keyword );
+        FieldHandle*       destinationField = nullptr;
+        FieldIoCapability* ioCapability     = nullptr;
+        if ( destinationEntry )
+        {
+            destinationField = SerializationPlan::field( destination, *destinationEntry );
+            ioCapability     = SerializationPlan::ioCapability( destinationField, *destinationEntry );
+        }
+        if ( !ioCapability || !destinationField->isWritable() )
+        {
+            throw std::runtime_error( "Invalid field " + entry.keyword + " in " +
+                                      std::string( destination->classKeyword() ) );
+        }
+
+        if ( this->fieldSelector() && !this->fieldSelector()( destinationField ) ) continue;
+
+        ioCapability->copyFrom( field, *this );
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -474,10 +925,19 @@ std::shared_ptr<ObjectHandle> JsonSerializer::createObjectFromString( const std:
 
     if ( string.empty() ) return nullptr;
 
-    const json::value jsonValue = json::parse( string );
-    if ( jsonValue.is_null() ) return nullptr;
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        const json::value jsonValue = json::parse( string, m_memoryResource );
+        if ( jsonValue.is_null() ) return nullptr;
 
-    return createObjectFromJson( jsonValue.as_object() );
+        return createObjectFromJson( jsonValue.as_object() );
+    }
+
+    JsonStreamReader reader( *this );
+    reader.write( string );
+    reader.finish();
+    return reader.createdObject();
 }
 
 std::shared_ptr<ObjectHandle> JsonSerializer::createObjectFromJson( const json::object& jsonObject ) const
@@ -507,11 +967,74 @@ std::shared_ptr<ObjectHandle> JsonSerializer::createObjectFromJson( const json::
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
-void JsonSerializer::readStream( ObjectHandle* object, std::istream& file ) const
+void JsonSerializer::readStream( ObjectHandle*    object,
+                                 std::istream&    file,
+                                 ProgressCallback progressCallback /* = nullptr */ ) const
+{
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        CAFFA_ERROR( "Reading JSON into objects only makes sense for data" );
+        return;
+    }
+
+    CAFFA_ASSERT( object );
+
+    JsonStreamReader  reader( *this, object );
+    std::vector<char> chunk( READ_CHUNK_SIZE );
+    while ( file )
+    {
+        file.read( chunk.data(), static_cast<std::streamsize>( chunk.size() ) );
+        if ( auto bytesRead = static_cast<size_t>( file.gcount() ); bytesRead > 0u )
+        {
+            reader.write( std::string_view( chunk.data(), bytesRead ) );
+            if ( progressCallback ) progressCallback( reader.bytesConsumed() );
+        }
+    }
+    reader.finish();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::readFile( ObjectHandle*                object,
+                               const std::filesystem::path& path,
+                               ProgressCallback             progressCallback /* = nullptr */ ) const
 {
-    const std::string str( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+    if ( !MappedFile::isSupported() )
+    {
+        std::ifstream stream( path, std::ios::binary );
+        if ( !stream )
+        {
+            throw std::runtime_error( "Failed to open '" + path.string() + "'" );
+        }
+        readStream( object, stream, std::move( progressCallback ) );
+        return;
+    }
+
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        CAFFA_ERROR( "Reading JSON into objects only makes sense for data" );
+        return;
+    }
+
+    CAFFA_ASSERT( object );
+
+    MappedFile       file( path );
+    JsonStreamReader reader( *this, object );
 
-    readObjectFromString( object, str );
+    const auto text = file.view();
+    for ( size_t offset = 0u; offset < text.size(); offset += READ_CHUNK_SIZE )
+    {
+        const auto chunk = text.substr( offset, READ_CHUNK_SIZE );
+        reader.write( chunk );
+        if ( progressCallback ) progressCallback( reader.bytesConsumed() );
+
+        // The reader keeps its own copy of any partial token, so the parsed pages are not needed any more
+        file.release( offset + chunk.size() );
+    }
+    reader.finish();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -519,7 +1042,16 @@ void JsonSerializer::readStream( ObjectHandle* object, std::istream& file ) cons
 //--------------------------------------------------------------------------------------------------
 void JsonSerializer::writeStream( const ObjectHandle* object, std::ostream& file, bool pretty /* = false*/ ) const
 {
-    json::object document;
+    if ( this->serializationType() == SerializationType::DATA_FULL ||
+         this->serializationType() == SerializationType::DATA_SKELETON )
+    {
+        JsonStreamWriter writer( file, pretty );
+        writeObjectToStream( object, writer );
+        writer.flush();
+        return;
+    }
+
+    json::object document( m_memoryResource );
     writeObjectToJson( object, document );
 
     if ( pretty )
@@ -531,3 +1063,82 @@ void JsonSerializer::writeStream( const ObjectHandle* object, std::ostream& file
         file << json::dump( document );
     }
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::readCompressedStream( ObjectHandle*    object,
+                                           std::istream&    stream,
+                                           ProgressCallback progressCallback /* = nullptr */ ) const
+{
+    if ( this->serializationType() != SerializationType::DATA_FULL &&
+         this->serializationType() != SerializationType::DATA_SKELETON )
+    {
+        CAFFA_ERROR( "Reading JSON into objects only makes sense for data" );
+        return;
+    }
+
+    CAFFA_ASSERT( object );
+
+    std::vector<char> chunk( READ_CHUNK_SIZE );
+    stream.read( chunk.data(), static_cast<std::streamsize>( chunk.size() ) );
+    auto bytesRead = static_cast<size_t>( stream.gcount() );
+
+    const auto compression = detectCompression( std::string_view( chunk.data(), bytesRead ) );
+
+    JsonStreamReader              reader( *this, object );
+    std::unique_ptr<Decompressor> decompressor;
+    if ( compression != Compression::NONE )
+    {
+        decompressor = std::make_unique<Decompressor>( compression );
+    }
+
+    auto parse = [&reader]( std::string_view text ) { reader.write( text ); };
+    while ( bytesRead > 0u )
+    {
+        if ( decompressor )
+        {
+            decompressor->write( std::string_view( chunk.data(), bytesRead ), parse );
+        }
+        else
+        {
+            parse( std::string_view( chunk.data(), bytesRead ) );
+        }
+        if ( progressCallback ) progressCallback( reader.bytesConsumed() );
+
+        bytesRead = 0u;
+        if ( stream )
+        {
+            stream.read( chunk.data(), static_cast<std::streamsize>( chunk.size() ) );
+            bytesRead = static_cast<size_t>( stream.gcount() );
+        }
+    }
+    if ( decompressor ) decompressor->finish();
+    reader.finish();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonSerializer::writeCompressedStream( const ObjectHandle* object,
+                                            std::ostream&       stream,
+                                            Compression         compression,
+                                            std::optional<int>  level /* = std::nullopt */,
+                                            bool                pretty /* = false */ ) const
+{
+    if ( compression == Compression::NONE )
+    {
+        writeStream( object, stream, pretty );
+        return;
+    }
+
+    CompressingStreamBuffer buffer( stream, compression, level );
+    {
+        // Let compression errors through instead of only setting the bad bit
+        std::ostream compressedStream( &buffer );
+        compressedStream.exceptions( std::ios::badbit );
+        writeStream( object, compressedStream, pretty );
+        compressedStream.flush();
+    }
+    buffer.finish();
+}
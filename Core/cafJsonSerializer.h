@@ -18,19 +18,32 @@
 //
 #pragma once
 
+#include "cafCompression.h"
 #include "cafJsonDefinitions.h"
+#include "cafJsonSerializationContext.h"
 #include "cafObjectHandle.h"
 
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace caffa
 {
 class FieldHandle;
+class JsonSchemaCache;
+struct ObjectSchemas;
+class JsonStreamWriter;
 class ObjectFactory;
 
 /**
  * Implementation of Serializer for JSON serialization.
+ *
+ * The serializer is not modified by reading or writing, so a configured serializer can be shared by several threads
+ * as long as the configuration is left alone. The state of each write is kept in a JsonSerializationContext.
  */
 class JsonSerializer
 {
@@ -43,7 +56,10 @@ public:
         PATH
     };
 
-    using FieldSelector = std::function<bool( const FieldHandle* )>;
+    using FieldSelector    = std::function<bool( const FieldHandle* )>;
+    using ProgressCallback = std::function<void( size_t bytesConsumed )>;
+
+    static constexpr size_t READ_CHUNK_SIZE = 64u * 1024u;
 
     static std::string serializationTypeLabel( SerializationType type );
 
@@ -53,8 +69,15 @@ public:
      * @param objectFactory The factory used when creating new objects. Not relevant when writing.
      */
     explicit JsonSerializer( ObjectFactory* objectFactory = nullptr );
+
+    /**
+     * Constructor sharing ownership of the object factory, so the factory lives as long as any copy of the
+     * serializer. Needed for lazy reading with a factory other than the default one.
+     * @param objectFactory The factory used when creating new objects. Uses the default factory if nullptr.
+     */
+    explicit JsonSerializer( std::shared_ptr<ObjectFactory> objectFactory );
     /**
-     * Clone the object by serializing to and from text string
+     * Clone the object. Data is copied field by field, other serialization types go through a text string.
      *
      * @param object The object to copy
      * @return unique ptr containing a new copy
@@ -70,10 +93,24 @@ public:
      * Set Field Selector
      * Since it returns a reference it can be used like: Serializer(objectFactory).setFieldSelector(functor);
      *
+     * Schemas written with a field selector are only cached if the selector has a key. Selectors which pick the
+     * same fields must have the same key and selectors picking different fields must have different keys.
+     *
      * @param fieldSelector
+     * @param selectorKey A key identifying the selector in the schema cache
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setFieldSelector( FieldSelector fieldSelector, std::string selectorKey = "" );
+
+    /**
+     * Only write the fields selected by a projection when writing data, on top of the field selector.
+     * Fields outside the projection are skipped without visiting the objects below them, so writing a narrow
+     * view of a large tree costs time in proportion to the output.
+     *
+     * @param projection The projection or nullptr to write all fields (the default)
      * @return cafSerializer& reference to this
      */
-    JsonSerializer& setFieldSelector( FieldSelector fieldSelector );
+    JsonSerializer& setProjection( std::shared_ptr<const FieldProjection> projection );
 
     /**
      * Set what to serialize (data, schema, etc)
@@ -93,6 +130,89 @@ public:
      */
     JsonSerializer& setSerializeUuids( bool serializeUuids );
 
+    /**
+     * Set the cache used for schemas. By default the shared JsonSchemaCache::instance() is used.
+     * Since it returns a reference, it can be used like: Serializer(objectFactory).setSchemaCache(nullptr);
+     *
+     * @param schemaCache The cache to use or nullptr to generate every schema from scratch
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setSchemaCache( JsonSchemaCache* schemaCache );
+
+    /**
+     * Set whether to write numeric vector fields as base64 encoded binary blobs instead of arrays of numbers.
+     * The packed form is accepted when reading regardless of this setting. See cafJsonPackedArray.h.
+     * Individual fields can also be packed with FieldIoCapability::setPackNumericArrays.
+     *
+     * @param packNumericArrays
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setPackNumericArrays( bool packNumericArrays );
+
+    /**
+     * Write the children of large child array fields on several threads (see cafParallelFor.h).
+     * Arrays with more than grainSize children are split into chunks of grainSize children, which are written
+     * concurrently and spliced back in their original order, so the output is identical to a serial write.
+     * The objects must not be modified while they are written.
+     *
+     * @param grainSize The number of children written by each task or 0 to write serially (the default)
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setParallelWriteGrainSize( size_t grainSize );
+
+    /**
+     * Create and read the children of large child array fields on several threads (see cafParallelFor.h).
+     * The children are installed in their original order with a single bulk insert once they have all been read.
+     * The object factory and the constructors of the child classes must be safe to call concurrently.
+     * When reading from text or streams the child arrays are parsed into a JSON tree first, so that their
+     * elements can be handed out to the threads.
+     *
+     * @param threshold The smallest number of children read in parallel or 0 to read serially (the default)
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setParallelReadThreshold( size_t threshold );
+
+    /**
+     * Defer creating the children of child fields and child arrays until they are first accessed.
+     * The JSON of each child field is kept until then, along with a copy of this serializer used to read it,
+     * so opening a document only builds the objects at the top level of the tree. Fields using a custom accessor
+     * are always read straight away. The copy reads with the default memory resource.
+     *
+     * The copy outlives the read, so it has to keep the object factory alive. Lazy reading is therefore only done
+     * with the default factory or a factory given to the serializer as a shared pointer. With a plain factory pointer
+     * children are read straight away whatever this setting.
+     *
+     * @param lazyChildren true to read children when first accessed, false to read them straight away (the default)
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setLazyChildren( bool lazyChildren );
+
+    /**
+     * Read child arrays into the children already in them where possible, rather than replacing every child.
+     * Entries are matched to the current children by uuid and class. Matching children are kept and updated in
+     * place, new entries get new children and children without a matching entry are removed. The children end up
+     * in the order of the entries. Children which have been deferred by a lazy read are loaded to be matched.
+     *
+     * @param reconcileChildren true to update matching children in place, false to replace all children (the default)
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setReconcileChildren( bool reconcileChildren );
+
+    /**
+     * Set the memory resource for the JSON values the serializer parses or builds for itself, for instance a
+     * boost::json::monotonic_resource reused for every request and released in a single step.
+     * Values written by writeObjectToJson are allocated from the storage of the JSON object passed in.
+     * Streamed reads do not use the resource: each field value is read from an internal arena released after the
+     * value, so memory stays bounded however large the document is.
+     * Memory resources are generally not thread safe, so child arrays written into JSON values which do not use
+     * the default resource are always written serially. The resource must outlive the serializer and the values
+     * unless the storage pointer shares ownership of it.
+     *
+     * @param memoryResource The memory resource. Empty for the default heap (the default).
+     * @return cafSerializer& reference to this
+     */
+    JsonSerializer& setMemoryResource( json::storage_ptr memoryResource );
+
     /**
      * Get the object factory
      * @return object factory
@@ -105,6 +225,24 @@ public:
      */
     [[nodiscard]] FieldSelector fieldSelector() const;
 
+    /**
+     * Get the key of the field selector used for the schema cache
+     * @return field selector key. Empty if none has been set.
+     */
+    [[nodiscard]] const std::string& fieldSelectorKey() const;
+
+    /**
+     * Get the projection used when writing data
+     * @return projection or nullptr if all fields are written
+     */
+    [[nodiscard]] const std::shared_ptr<const FieldProjection>& projection() const;
+
+    /**
+     * Get the schema cache
+     * @return schema cache or nullptr if schemas are not cached
+     */
+    [[nodiscard]] JsonSchemaCache* schemaCache() const;
+
     /**
      * Check which type of serialization we're doing
      * @return The type of serialization to do
@@ -118,6 +256,42 @@ public:
      */
     [[nodiscard]] bool serializeUuids() const;
 
+    /**
+     * Check if numeric vector fields should be written as packed arrays
+     * @return true if numeric vectors are written packed
+     */
+    [[nodiscard]] bool packNumericArrays() const;
+
+    /**
+     * Get the number of children written by each task when writing child arrays in parallel
+     * @return grain size or 0 if child arrays are written serially
+     */
+    [[nodiscard]] size_t parallelWriteGrainSize() const;
+
+    /**
+     * Get the smallest number of children in a child array field which are read in parallel
+     * @return threshold or 0 if child arrays are read serially
+     */
+    [[nodiscard]] size_t parallelReadThreshold() const;
+
+    /**
+     * Check if children are created when first accessed rather than when read
+     * @return true if lazy reading is set and the serializer shares ownership of its object factory
+     */
+    [[nodiscard]] bool lazyChildren() const;
+
+    /**
+     * Check if child arrays are read into the existing children with matching uuids
+     * @return true if children are reconciled
+     */
+    [[nodiscard]] bool reconcileChildren() const;
+
+    /**
+     * Get the memory resource for the JSON values the serializer parses or builds for itself
+     * @return storage pointer, which is the default heap unless a memory resource has been set
+     */
+    [[nodiscard]] const json::storage_ptr& memoryResource() const;
+
     JsonSerializer&    setClient( bool client );
     [[nodiscard]] bool isClient() const;
 
@@ -130,7 +304,8 @@ public:
     [[nodiscard]] static std::string readUUIDFromObjectString( const std::string& string );
 
     /**
-     * Convenience method to read this particular object (with children) from a json string
+     * Convenience method to read this particular object (with children) from a json string.
+     * The fields are read while the text is parsed, without building a JSON tree of the document.
      * @param object ObjectHandle to read in to.
      * @param string The JSON text string containing the object
      */
@@ -145,7 +320,21 @@ public:
     [[nodiscard]] std::string writeObjectToString( const ObjectHandle* object, bool pretty = false ) const;
 
     /**
-     * Copy the object by serializing to text string and reading in again
+     * Write the schemas of all classes the object factory of this serializer can create, as the object_schemas
+     * component of an OpenAPI document. One object of each class is created up front on the calling thread and
+     * the schemas are then written in parallel (see cafParallelFor.h). The schemas are written with the field
+     * selector of this serializer whatever the serialization type.
+     *
+     * The result is kept in the schema cache until the factory generation changes or the cache is invalidated, so
+     * later calls return the same shared schemas without any work. Factories with generation 0 are not cached.
+     *
+     * @return The schemas keyed by class keyword, along with their serialized text
+     */
+    [[nodiscard]] std::shared_ptr<const ObjectSchemas> writeObjectSchemas() const;
+
+    /**
+     * Copy the object by serializing to text string and reading in again.
+     * For DATA_FULL the text step is skipped and the object is copied directly with copyObject.
      * @param object The object to copy
      * @return unique ptr containing a new copy
      */
@@ -153,6 +342,7 @@ public:
 
     /**
      * Copy the object by serializing to text string but cast to a different class keyword.
+     * For DATA_FULL the text step is skipped and the fields are copied directly with copyObjectFields.
      * Note, it is still returned as a base class pointer.
      *
      * @param object The object to copy
@@ -162,6 +352,23 @@ public:
     [[nodiscard]] std::shared_ptr<ObjectHandle>
         copyAndCastBySerialization( const ObjectHandle* object, const std::string_view& destinationClassKeyword ) const;
 
+    /**
+     * Create a deep copy of the object without going through JSON.
+     * Data fields are copied through their typed accessors and child objects are recreated with the object factory.
+     * The field selector and the UUID setting are applied as if the object had been written and read back.
+     * @param object The object to copy
+     * @return the new copy or nullptr if the object factory cannot create the class
+     */
+    [[nodiscard]] std::shared_ptr<ObjectHandle> copyObject( const ObjectHandle* object ) const;
+
+    /**
+     * Copy the fields of one object into another without going through JSON. See copyObject.
+     * Throws std::runtime_error if the destination lacks a writable field present in the source.
+     * @param source The object to copy from
+     * @param destination The object to copy into
+     */
+    void copyObjectFields( const ObjectHandle* source, ObjectHandle* destination ) const;
+
     /**
      * Create a new object from a JSON text string
      * @param string The JSON text string
@@ -177,34 +384,153 @@ public:
     [[nodiscard]] std::shared_ptr<ObjectHandle> createObjectFromJson( const json::object& jsonValue ) const;
 
     /**
-     * Read object from an input stream
+     * Read object from an input stream.
+     * The stream is read and parsed in chunks of READ_CHUNK_SIZE bytes, so it is never held in memory as a whole.
      * @param object Pointer to object to read into
      * @param stream The input stream
+     * @param progressCallback Optional callback receiving the total number of bytes parsed after each chunk
+     */
+    void readStream( ObjectHandle* object, std::istream& stream, ProgressCallback progressCallback = nullptr ) const;
+
+    /**
+     * Read object from a file.
+     * The file is memory mapped and parsed straight from the mapping in chunks of READ_CHUNK_SIZE bytes, releasing
+     * pages once they have been parsed. Falls back to reading through a stream where memory mapping is unsupported.
+     * Throws std::runtime_error if the file can not be read.
+     * @param object Pointer to object to read into
+     * @param path The file to read
+     * @param progressCallback Optional callback receiving the total number of bytes parsed after each chunk
      */
-    void readStream( ObjectHandle* object, std::istream& stream ) const;
+    void readFile( ObjectHandle*                object,
+                   const std::filesystem::path& path,
+                   ProgressCallback             progressCallback = nullptr ) const;
 
     /**
-     * Write object to output stream
+     * Write object to output stream.
+     * Data is streamed straight to the output without building a JSON tree first.
      * @param object Pointer to object to write
      * @param stream The output stream
      * @param pretty If true will pretty print with indentation and newlines
      */
     void writeStream( const ObjectHandle* object, std::ostream& stream, bool pretty = false ) const;
 
+    /**
+     * Read object from an input stream which may be compressed.
+     * The compression is detected from the magic bytes at the start of the stream and the data is decompressed and
+     * parsed in chunks of READ_CHUNK_SIZE bytes. Uncompressed streams are read like in readStream.
+     * Throws std::runtime_error on corrupt or incomplete compressed data.
+     * @param object Pointer to object to read into
+     * @param stream The input stream
+     * @param progressCallback Optional callback receiving the total number of uncompressed bytes parsed
+     */
+    void readCompressedStream( ObjectHandle*    object,
+                               std::istream&    stream,
+                               ProgressCallback progressCallback = nullptr ) const;
+
+    /**
+     * Write object to an output stream, compressing while streaming.
+     * Throws std::runtime_error if the compression format is not supported by this build.
+     * @param object Pointer to object to write
+     * @param stream The output stream
+     * @param compression The compression format
+     * @param level The compression level. Uses the default level of the format if not provided.
+     * @param pretty If true will pretty print with indentation and newlines
+     */
+    void writeCompressedStream( const ObjectHandle* object,
+                                std::ostream&       stream,
+                                Compression         compression,
+                                std::optional<int>  level  = std::nullopt,
+                                bool                pretty = false ) const;
+
+    /**
+     * Write object straight to a stream writer.
+     * DATA_FULL and DATA_SKELETON output is emitted token by token while walking the fields. Other serialization
+     * types build the JSON tree of the object first.
+     * @param object Pointer to object to write
+     * @param writer The stream writer
+     */
+    void writeObjectToStream( const ObjectHandle* object, JsonStreamWriter& writer ) const;
+
+    /**
+     * Write object straight to a stream writer as part of a larger write. Used by fields holding child objects.
+     * @param object Pointer to object to write
+     * @param writer The stream writer
+     * @param context The context of the object
+     */
+    void writeObjectToStream( const ObjectHandle*             object,
+                              JsonStreamWriter&               writer,
+                              const JsonSerializationContext& context ) const;
+
     void readObjectFromJson( ObjectHandle* object, const json::object& jsonValue ) const;
     void writeObjectToJson( const ObjectHandle* object, json::object& jsonValue ) const;
 
-    void prettyPrint( std::ostream& os, json::value const& jv, std::string* indent = nullptr ) const;
+    /**
+     * Write object to JSON as part of a larger write. Used by fields holding child objects.
+     * With DATA_SKELETON only the top level object gets its fields written.
+     * @param object Pointer to object to write
+     * @param jsonValue The JSON object to write to
+     * @param context The context of the object
+     */
+    void writeObjectToJson( const ObjectHandle*             object,
+                            json::object&                   jsonValue,
+                            const JsonSerializationContext& context ) const;
+
+    /**
+     * Write a list of sibling objects to JSON, in parallel if the list is longer than the parallel write grain size.
+     * @param objects The objects to write. Must not contain nullptr.
+     * Only written in parallel if the JSON objects use the default memory resource.
+     * @param context The context of the objects
+     * @param storage The memory resource the JSON objects are allocated from
+     * @return The JSON objects in the same order as the input
+     */
+    [[nodiscard]] std::vector<json::object> writeObjectsToJson( std::span<const std::shared_ptr<ObjectHandle>> objects,
+                                                                const JsonSerializationContext& context,
+                                                                json::storage_ptr               storage = {} ) const;
+
+    /**
+     * Write a JSON value with two spaces of indentation per level and a trailing newline
+     * @param os The output stream
+     * @param jv The JSON value
+     */
+    void prettyPrint( std::ostream& os, json::value const& jv ) const;
+
+    /**
+     * Write a JSON value pretty printed inside other output. Lines after the first are indented by the given
+     * indentation on top of two spaces per level, and the trailing newline is only written without indentation.
+     * @param os The output stream
+     * @param jv The JSON value
+     * @param indent The indentation of the line the value starts on. May be nullptr for none.
+     */
+    void prettyPrint( std::ostream& os, json::value const& jv, std::string* indent ) const;
+
+private:
+    /**
+     * The key schemas written by this serializer are cached under. Made from the field selector key and any setting
+     * which changes the schemas.
+     */
+    [[nodiscard]] std::string schemaCacheKey() const;
 
 protected:
     bool           m_client;
     ObjectFactory* m_objectFactory;
     FieldSelector  m_fieldSelector;
+    std::string    m_fieldSelectorKey;
+
+    // Set when the serializer shares ownership of the object factory
+    std::shared_ptr<ObjectFactory> m_sharedObjectFactory;
+
+    std::shared_ptr<const FieldProjection> m_projection;
+
+    JsonSchemaCache* m_schemaCache;
 
     SerializationType m_serializationType;
     bool              m_serializeUuids;
-
-    mutable int m_level;
+    bool              m_packNumericArrays;
+    size_t            m_parallelWriteGrainSize;
+    size_t            m_parallelReadThreshold;
+    bool              m_lazyChildren;
+    bool              m_reconcileChildren;
+    json::storage_ptr m_memoryResource;
 };
 
 } // End of namespace caffa
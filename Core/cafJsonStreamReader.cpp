@@ -0,0 +1,866 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonStreamReader.h"
+
+#include "cafAssert.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafChildFieldHandle.h"
+#include "cafFieldHandle.h"
+#include "cafFieldIoCapability.h"
+#include "cafJsonSerializer.h"
+#include "cafLogger.h"
+#include "cafObjectFactory.h"
+#include "cafObjectHandle.h"
+#include "cafSerializationPlan.h"
+
+#include <boost/json.hpp>
+#include <boost/json/basic_parser_impl.hpp>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace caffa;
+
+namespace
+{
+using boost::json::error_code;
+using boost::json::string_view;
+
+//==================================================================================================
+/// Handler for boost::json::basic_parser binding the parse events to object fields
+//==================================================================================================
+class ReaderHandler
+{
+public:
+    static constexpr std::size_t max_object_size = std::size_t( -1 );
+    static constexpr std::size_t max_array_size  = std::size_t( -1 );
+    static constexpr std::size_t max_key_size    = std::size_t( -1 );
+    static constexpr std::size_t max_string_size = std::size_t( -1 );
+
+    ReaderHandler( const JsonSerializer& serializer, ObjectHandle* object );
+
+    bool on_document_begin( error_code& ) { return true; }
+    bool on_document_end( error_code& ) { return true; }
+    bool on_object_begin( error_code& );
+    bool on_object_end( std::size_t n, error_code& );
+    bool on_array_begin( error_code& );
+    bool on_array_end( std::size_t n, error_code& );
+    bool on_key_part( string_view s, std::size_t, error_code& );
+    bool on_key( string_view s, std::size_t, error_code& );
+    bool on_string_part( string_view s, std::size_t, error_code& );
+    bool on_string( string_view s, std::size_t, error_code& );
+    bool on_number_part( string_view, error_code& ) { return true; }
+    bool on_int64( std::int64_t i, string_view, error_code& );
+    bool on_uint64( std::uint64_t u, string_view, error_code& );
+    bool on_double( double d, string_view, error_code& );
+    bool on_bool( bool b, error_code& );
+    bool on_null( error_code& );
+    bool on_comment_part( string_view, error_code& ) { return true; }
+    bool on_comment( string_view, error_code& ) { return true; }
+
+    std::shared_ptr<ObjectHandle> createdObject() const { return m_createdObject; }
+
+private:
+    /**
+     * An object being read or a child array being filled.
+     * Objects read into child fields are created once the class keyword is known and the first field arrives.
+     */
+    struct Frame
+    {
+        bool                          isArray      = false;
+        ObjectHandle*                 object       = nullptr;
+        std::shared_ptr<ObjectHandle> ownedObject  = nullptr;
+        ChildFieldHandle*             parentChild  = nullptr;
+        ChildArrayFieldHandle*        parentArray  = nullptr;
+        FieldIoCapability*            capability   = nullptr;
+        bool                          hasMembers   = false;
+        bool                          skipContents = false;
+        std::string                   classKeyword;
+        std::string                   uuid;
+        std::string                   key;
+        json::object                  pending;
+    };
+
+    enum class ValueType
+    {
+        KEYWORD,
+        UUID,
+        SKIP,
+        PENDING,
+        DATA,
+        CHILD,
+        CHILD_ARRAY
+    };
+
+    struct ValueTarget
+    {
+        ValueType          type;
+        FieldHandle*       field      = nullptr;
+        FieldIoCapability* capability = nullptr;
+    };
+
+    ValueTarget resolveValue( Frame& frame, bool isNull );
+    void        readScalar( const json::value& value );
+    void        materialize( Frame& frame );
+    void        setClassKeyword( Frame& frame, const json::value& value );
+    void        setUuid( Frame& frame, const json::value& value );
+    void        beginCapture( FieldIoCapability* capability );
+    void        finishCapture();
+    std::string fieldKeyword( const Frame& frame ) const;
+
+    const JsonSerializer&           m_serializer;
+    JsonSerializer::FieldSelector   m_fieldSelector;
+    bool                            m_readData;
+    bool                            m_serializeUuids;
+    bool                            m_captureChildArrays;
+    ObjectHandle*                   m_rootObject;
+    std::shared_ptr<ObjectHandle>   m_createdObject;
+    std::vector<Frame>              m_frames;
+    std::string                     m_key;
+    std::string                     m_string;
+    size_t                          m_skipDepth;
+    size_t                          m_captureDepth;
+    FieldIoCapability*              m_captureCapability;
+    boost::json::monotonic_resource m_scratch;
+    boost::json::value_stack        m_capture;
+};
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ReaderHandler::ReaderHandler( const JsonSerializer& serializer, ObjectHandle* object )
+    : m_serializer( serializer )
+    , m_fieldSelector( serializer.fieldSelector() )
+    , m_readData( serializer.serializationType() == JsonSerializer::SerializationType::DATA_FULL )
+    , m_serializeUuids( serializer.serializeUuids() )
+    , m_captureChildArrays( serializer.parallelReadThreshold() > 0u || serializer.lazyChildren() ||
+                            serializer.reconcileChildren() )
+    , m_rootObject( object )
+    , m_skipDepth( 0u )
+    , m_captureDepth( 0u )
+    , m_captureCapability( nullptr )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_object_begin( error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        ++m_captureDepth;
+        return true;
+    }
+    if ( m_skipDepth > 0u )
+    {
+        ++m_skipDepth;
+        return true;
+    }
+
+    if ( m_frames.empty() )
+    {
+        Frame root;
+        root.object = m_rootObject;
+        m_frames.push_back( std::move( root ) );
+        return true;
+    }
+
+    if ( m_frames.back().isArray )
+    {
+        Frame child;
+        child.parentArray = m_frames.back().parentArray;
+        m_frames.push_back( std::move( child ) );
+        return true;
+    }
+
+    auto target = resolveValue( m_frames.back(), false );
+    switch ( target.type )
+    {
+        case ValueType::KEYWORD:
+        case ValueType::UUID:
+            throw std::runtime_error( "Invalid JSON: '" + m_frames.back().key + "' has to be a string" );
+        case ValueType::SKIP:
+            m_skipDepth = 1u;
+            break;
+        case ValueType::PENDING:
+        case ValueType::DATA:
+        case ValueType::CHILD_ARRAY:
+            beginCapture( target.capability );
+            break;
+        case ValueType::CHILD:
+        {
+            if ( m_serializer.lazyChildren() )
+            {
+                // The field keeps the JSON of the child until the child is accessed
+                beginCapture( target.capability );
+                break;
+            }
+
+            Frame child;
+            child.parentChild = dynamic_cast<ChildFieldHandle*>( target.field );
+            child.capability  = target.capability;
+            m_frames.push_back( std::move( child ) );
+            break;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_object_end( std::size_t n, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_object( n );
+        if ( --m_captureDepth == 0u ) finishCapture();
+        return true;
+    }
+    if ( m_skipDepth > 0u )
+    {
+        --m_skipDepth;
+        return true;
+    }
+
+    CAFFA_ASSERT( !m_frames.empty() && !m_frames.back().isArray );
+
+    auto& frame = m_frames.back();
+    if ( !frame.object && !frame.skipContents )
+    {
+        materialize( frame );
+    }
+
+    if ( frame.object && frame.parentArray )
+    {
+        CAFFA_TRACE( "Inserting new object into " << frame.parentArray->keyword() << " at position "
+                                                  << frame.parentArray->size() );
+        frame.parentArray->insertAt( frame.parentArray->size(), frame.ownedObject );
+    }
+    m_frames.pop_back();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_array_begin( error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        ++m_captureDepth;
+        return true;
+    }
+    if ( m_skipDepth > 0u )
+    {
+        ++m_skipDepth;
+        return true;
+    }
+
+    if ( m_frames.empty() )
+    {
+        throw std::runtime_error( "Invalid JSON: The document is not an object" );
+    }
+
+    if ( m_frames.back().isArray )
+    {
+        // Only objects are read from child arrays
+        m_skipDepth = 1u;
+        return true;
+    }
+
+    auto target = resolveValue( m_frames.back(), false );
+    switch ( target.type )
+    {
+        case ValueType::KEYWORD:
+        case ValueType::UUID:
+            throw std::runtime_error( "Invalid JSON: '" + m_frames.back().key + "' has to be a string" );
+        case ValueType::SKIP:
+            m_skipDepth = 1u;
+            break;
+        case ValueType::PENDING:
+        case ValueType::DATA:
+        case ValueType::CHILD:
+            beginCapture( target.capability );
+            break;
+        case ValueType::CHILD_ARRAY:
+        {
+            if ( m_captureChildArrays )
+            {
+                // The field reads the elements of the captured array in parallel, when first accessed or into
+                // the existing children
+                beginCapture( target.capability );
+                break;
+            }
+
+            auto childArrayField = dynamic_cast<ChildArrayFieldHandle*>( target.field );
+            childArrayField->clear();
+
+            Frame array;
+            array.isArray     = true;
+            array.parentArray = childArrayField;
+            m_frames.push_back( std::move( array ) );
+            break;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_array_end( std::size_t n, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_array( n );
+        if ( --m_captureDepth == 0u ) finishCapture();
+        return true;
+    }
+    if ( m_skipDepth > 0u )
+    {
+        --m_skipDepth;
+        return true;
+    }
+
+    CAFFA_ASSERT( !m_frames.empty() && m_frames.back().isArray );
+    m_frames.pop_back();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_key_part( string_view s, std::size_t, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_chars( s );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        m_key.append( s.data(), s.size() );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_key( string_view s, std::size_t, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_key( s );
+        return true;
+    }
+    if ( m_skipDepth > 0u ) return true;
+
+    m_key.append( s.data(), s.size() );
+
+    auto& frame = m_frames.back();
+
+    // A child field may have its object wrapped as { "value": { ... } }. This is only detectable at the first key,
+    // after which the whole field value is collected and handed to the field capability.
+    if ( frame.parentChild && !frame.hasMembers && m_key == "value" )
+    {
+        auto capability = frame.capability;
+        m_frames.pop_back();
+
+        beginCapture( capability );
+        m_capture.push_key( "value" );
+    }
+    else
+    {
+        frame.hasMembers = true;
+        frame.key.swap( m_key );
+    }
+    m_key.clear();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_string_part( string_view s, std::size_t, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_chars( s );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        m_string.append( s.data(), s.size() );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_string( string_view s, std::size_t, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_string( s );
+        return true;
+    }
+    if ( m_skipDepth > 0u ) return true;
+
+    if ( m_string.empty() )
+    {
+        readScalar( json::value( s, &m_scratch ) );
+    }
+    else
+    {
+        m_string.append( s.data(), s.size() );
+        readScalar( json::value( string_view( m_string.data(), m_string.size() ), &m_scratch ) );
+        m_string.clear();
+    }
+    m_scratch.release();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_int64( std::int64_t i, string_view, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_int64( i );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        readScalar( json::value( i ) );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_uint64( std::uint64_t u, string_view, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_uint64( u );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        readScalar( json::value( u ) );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_double( double d, string_view, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_double( d );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        readScalar( json::value( d ) );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_bool( bool b, error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_bool( b );
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        readScalar( json::value( b ) );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ReaderHandler::on_null( error_code& )
+{
+    if ( m_captureDepth > 0u )
+    {
+        m_capture.push_null();
+    }
+    else if ( m_skipDepth == 0u )
+    {
+        readScalar( json::value( nullptr ) );
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Work out where the value of the current key goes. Mirrors the checks in JsonSerializer::readObjectFromJson
+//--------------------------------------------------------------------------------------------------
+ReaderHandler::ValueTarget ReaderHandler::resolveValue( Frame& frame, bool isNull )
+{
+    const auto& key = frame.key;
+    if ( key == "keyword" || key == "class" ) return { ValueType::KEYWORD };
+    if ( key == "uuid" ) return { ValueType::UUID };
+
+    if ( isNull || frame.skipContents || !m_readData || key == "$id" || key == "methods" )
+    {
+        return { ValueType::SKIP };
+    }
+
+    if ( !frame.object )
+    {
+        if ( frame.classKeyword.empty() ) return { ValueType::PENDING };
+
+        materialize( frame );
+        if ( !frame.object ) return { ValueType::SKIP };
+    }
+
+    std::optional<SerializationPlan> ownPlan;
+
+    const auto*        entry      = SerializationPlan::forObject( frame.object, ownPlan ).findEntry( key );
+    FieldHandle*       field      = entry ? SerializationPlan::field( frame.object, *entry ) : nullptr;
+    FieldIoCapability* capability = entry ? SerializationPlan::ioCapability( field, *entry ) : nullptr;
+    if ( !capability || !field->isWritable() )
+    {
+        throw std::runtime_error( "Invalid field " + key + " in " + std::string( frame.object->classKeyword() ) );
+    }
+
+    if ( m_fieldSelector && !m_fieldSelector( field ) ) return { ValueType::SKIP };
+
+    switch ( entry->kind )
+    {
+        case SerializationPlan::FieldKind::CHILD_ARRAY:
+            return { ValueType::CHILD_ARRAY, field, capability };
+        case SerializationPlan::FieldKind::CHILD:
+            return { ValueType::CHILD, field, capability };
+        case SerializationPlan::FieldKind::DATA:
+            break;
+    }
+    return { ValueType::DATA, field, capability };
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::readScalar( const json::value& value )
+{
+    if ( m_frames.empty() )
+    {
+        // A null document gives no object
+        if ( value.is_null() && !m_rootObject ) return;
+
+        throw std::runtime_error( "Invalid JSON: The document is not an object" );
+    }
+
+    auto& frame = m_frames.back();
+
+    // Only objects are read from child arrays
+    if ( frame.isArray ) return;
+
+    auto target = resolveValue( frame, value.is_null() );
+    switch ( target.type )
+    {
+        case ValueType::KEYWORD:
+            setClassKeyword( frame, value );
+            break;
+        case ValueType::UUID:
+            setUuid( frame, value );
+            break;
+        case ValueType::SKIP:
+            break;
+        case ValueType::PENDING:
+            frame.pending[frame.key] = value;
+            break;
+        case ValueType::DATA:
+        case ValueType::CHILD:
+        case ValueType::CHILD_ARRAY:
+            CAFFA_TRACE( "Reading field: " << frame.key << " with value " << json::dump( value ) );
+            target.capability->readFromJson( value, m_serializer );
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Create the object for a frame, or pick up the existing child object if the uuid matches
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::materialize( Frame& frame )
+{
+    CAFFA_ASSERT( !frame.object );
+
+    if ( frame.classKeyword.empty() )
+    {
+        if ( frame.parentChild || frame.parentArray )
+        {
+            throw std::runtime_error( "Invalid JSON. Could not find keyword tag" );
+        }
+        // Without a class keyword there is nothing to create at the top level
+        frame.skipContents = true;
+        return;
+    }
+
+    std::shared_ptr<ObjectHandle> object;
+    if ( frame.parentChild && !frame.uuid.empty() )
+    {
+        if ( auto existing = frame.parentChild->childObjects(); !existing.empty() && existing.front()->uuid() == frame.uuid )
+        {
+            CAFFA_TRACE( "Had existing matching object! Overwriting field values!" );
+            object = existing.front();
+        }
+    }
+
+    if ( !object )
+    {
+        auto objectFactory = m_serializer.objectFactory();
+        if ( !objectFactory )
+        {
+            CAFFA_ASSERT( false && "No object factory!" );
+            frame.skipContents = true;
+            return;
+        }
+
+        object = objectFactory->create( frame.classKeyword );
+        if ( object && frame.parentChild )
+        {
+            frame.parentChild->setChildObject( object );
+            if ( auto children = frame.parentChild->childObjects(); children.empty() || children.front() != object )
+            {
+                object.reset();
+            }
+        }
+
+        if ( !object )
+        {
+            if ( frame.parentChild || frame.parentArray )
+            {
+                CAFFA_ERROR( "Unknown object type with class name: " << frame.classKeyword
+                                                                     << " found while reading the field : "
+                                                                     << fieldKeyword( frame ) );
+            }
+            frame.skipContents = true;
+            return;
+        }
+    }
+
+    if ( !ObjectHandle::matchesClassKeyword( frame.classKeyword, object->classInheritanceStack() ) )
+    {
+        CAFFA_ERROR( "Unknown object type with class name: " << frame.classKeyword << " found while reading the field : "
+                                                             << fieldKeyword( frame ) );
+        CAFFA_ERROR( "                     Expected class name: " << object->classKeyword() );
+        frame.skipContents = true;
+        return;
+    }
+
+    if ( m_serializeUuids && !frame.uuid.empty() )
+    {
+        object->setUuid( frame.uuid );
+    }
+
+    frame.object      = object.get();
+    frame.ownedObject = object;
+    if ( !frame.parentChild && !frame.parentArray )
+    {
+        m_createdObject = object;
+    }
+
+    if ( !frame.pending.empty() )
+    {
+        m_serializer.readObjectFromJson( frame.object, frame.pending );
+        frame.pending.clear();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::setClassKeyword( Frame& frame, const json::value& value )
+{
+    if ( !value.is_string() )
+    {
+        throw std::runtime_error( "Invalid JSON: The class keyword has to be a string" );
+    }
+    frame.classKeyword = json::from_json<std::string>( value );
+
+    CAFFA_ASSERT( !frame.object || ObjectHandle::matchesClassKeyword( frame.classKeyword,
+                                                                      frame.object->classInheritanceStack() ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::setUuid( Frame& frame, const json::value& value )
+{
+    if ( !value.is_string() )
+    {
+        throw std::runtime_error( "Invalid JSON: The uuid has to be a string" );
+    }
+    frame.uuid = json::from_json<std::string>( value );
+
+    if ( frame.object && m_serializeUuids )
+    {
+        frame.object->setUuid( frame.uuid );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Start collecting a complete field value. A null capability means the value is held back on the current frame.
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::beginCapture( FieldIoCapability* capability )
+{
+    m_captureCapability = capability;
+    m_capture.reset( &m_scratch );
+    m_captureDepth = 1u;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ReaderHandler::finishCapture()
+{
+    {
+        json::value value = m_capture.release();
+        if ( m_captureCapability )
+        {
+            m_captureCapability->readFromJson( value, m_serializer );
+        }
+        else
+        {
+            auto& frame              = m_frames.back();
+            frame.pending[frame.key] = value;
+        }
+    }
+    m_captureCapability = nullptr;
+    m_scratch.release();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string ReaderHandler::fieldKeyword( const Frame& frame ) const
+{
+    if ( frame.parentChild ) return frame.parentChild->keyword();
+    if ( frame.parentArray ) return frame.parentArray->keyword();
+    return "";
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+struct JsonStreamReader::Parser
+{
+    Parser( const JsonSerializer& serializer, ObjectHandle* object )
+        : parser( boost::json::parse_options(), serializer, object )
+        , bytesConsumed( 0u )
+    {
+    }
+
+    boost::json::basic_parser<ReaderHandler> parser;
+    size_t                                   bytesConsumed;
+};
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamReader::JsonStreamReader( const JsonSerializer& serializer )
+    : m_parser( std::make_unique<Parser>( serializer, nullptr ) )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamReader::JsonStreamReader( const JsonSerializer& serializer, ObjectHandle* object )
+    : m_parser( std::make_unique<Parser>( serializer, object ) )
+{
+    CAFFA_ASSERT( object );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamReader::~JsonStreamReader() = default;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamReader::write( std::string_view chunk )
+{
+    error_code ec;
+    size_t     consumed = m_parser->parser.write_some( true, chunk.data(), chunk.size(), ec );
+    m_parser->bytesConsumed += consumed;
+
+    if ( !ec && consumed < chunk.size() )
+    {
+        ec = boost::json::error::extra_data;
+    }
+    if ( ec )
+    {
+        throw std::runtime_error( "Failed to parse JSON at byte " + std::to_string( m_parser->bytesConsumed ) + ": " +
+                                  ec.message() );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamReader::finish()
+{
+    if ( m_parser->parser.done() ) return;
+
+    error_code ec;
+    char       c = 0;
+    m_parser->parser.write_some( false, &c, 0u, ec );
+    if ( !ec && !m_parser->parser.done() )
+    {
+        ec = boost::json::error::incomplete;
+    }
+    if ( ec )
+    {
+        throw std::runtime_error( "Failed to parse JSON at byte " + std::to_string( m_parser->bytesConsumed ) + ": " +
+                                  ec.message() );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t JsonStreamReader::bytesConsumed() const
+{
+    return m_parser->bytesConsumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> JsonStreamReader::createdObject() const
+{
+    return m_parser->parser.handler().createdObject();
+}
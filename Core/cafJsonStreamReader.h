@@ -0,0 +1,90 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace caffa
+{
+class JsonSerializer;
+class ObjectHandle;
+
+/**
+ * Incremental JSON reader binding keys to fields while the text is being parsed.
+ *
+ * No tree is built for the document as a whole. Child objects are created through the serializer's object factory
+ * once their class keyword (and uuid, if it precedes the first field) has been read, and their fields are read
+ * straight into them. The value of each data field is collected on its own and handed to the field's IO capability,
+ * so only one field value is held in memory at any time. Text can be supplied in chunks of any size.
+ *
+ * Fields appearing before the class keyword of an object are held back until the object can be created.
+ * If the serializer reads child arrays in parallel, each child array is collected as a whole and handed to the field.
+ */
+class JsonStreamReader
+{
+public:
+    /**
+     * Construct a reader creating a new object from the class keyword in the document
+     * @param serializer The serializer providing factory, field selector and serialization type
+     */
+    explicit JsonStreamReader( const JsonSerializer& serializer );
+
+    /**
+     * Construct a reader reading into an existing object
+     * @param serializer The serializer providing factory, field selector and serialization type
+     * @param object The object to read into
+     */
+    JsonStreamReader( const JsonSerializer& serializer, ObjectHandle* object );
+
+    ~JsonStreamReader();
+
+    JsonStreamReader( const JsonStreamReader& )            = delete;
+    JsonStreamReader& operator=( const JsonStreamReader& ) = delete;
+
+    /**
+     * Parse the next chunk of text. Throws std::runtime_error on malformed JSON or invalid fields.
+     * @param chunk The text to parse. Does not need to end on a token boundary.
+     */
+    void write( std::string_view chunk );
+
+    /**
+     * Signal the end of the text. Throws std::runtime_error if the document is incomplete.
+     */
+    void finish();
+
+    /**
+     * The number of bytes parsed so far
+     */
+    [[nodiscard]] size_t bytesConsumed() const;
+
+    /**
+     * The object created from the class keyword of the document.
+     * @return the new object or nullptr when reading into an existing object, if the document was null or if the
+     * class keyword was missing or unknown
+     */
+    [[nodiscard]] std::shared_ptr<ObjectHandle> createdObject() const;
+
+private:
+    struct Parser;
+    std::unique_ptr<Parser> m_parser;
+};
+
+} // namespace caffa
@@ -0,0 +1,447 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafJsonStreamWriter.h"
+
+#include "cafAssert.h"
+
+#include <boost/json.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string>
+
+using namespace caffa;
+
+namespace
+{
+// Enough for any int64, uint64 or shortest round-trip double
+constexpr size_t NUMBER_BUFFER_SIZE = 32u;
+
+template <typename T>
+std::string_view formatNumber( char ( &buffer )[NUMBER_BUFFER_SIZE], T number )
+{
+    auto [end, error] = std::to_chars( buffer, buffer + NUMBER_BUFFER_SIZE, number );
+    CAFFA_ASSERT( error == std::errc() );
+    return std::string_view( buffer, static_cast<size_t>( end - buffer ) );
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamWriter::JsonStreamWriter( std::ostream& stream, bool pretty /* = false */, size_t bufferSize /* = DEFAULT_BUFFER_SIZE */ )
+    : m_stream( &stream )
+    , m_output( &m_buffer )
+    , m_bufferSize( bufferSize )
+    , m_pretty( pretty )
+    , m_afterKey( false )
+{
+    m_buffer.reserve( bufferSize );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamWriter::JsonStreamWriter( std::string& output, bool pretty /* = false */ )
+    : m_stream( nullptr )
+    , m_output( &output )
+    , m_bufferSize( 0u )
+    , m_pretty( pretty )
+    , m_afterKey( false )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Start with the scopes of the array writer, so indentation matches, but with no elements in the array
+//--------------------------------------------------------------------------------------------------
+JsonStreamWriter::JsonStreamWriter( std::string& output, const JsonStreamWriter& arrayWriter )
+    : m_stream( nullptr )
+    , m_output( &output )
+    , m_bufferSize( 0u )
+    , m_pretty( arrayWriter.m_pretty )
+    , m_afterKey( false )
+    , m_scopes( arrayWriter.m_scopes )
+{
+    CAFFA_ASSERT( !m_scopes.empty() && m_scopes.back().isArray && !arrayWriter.m_afterKey &&
+                  "Element writers have to be constructed inside an array" );
+    m_scopes.back().isEmpty = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JsonStreamWriter::~JsonStreamWriter() noexcept
+{
+    try
+    {
+        flush();
+    }
+    catch ( ... )
+    {
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::beginObject()
+{
+    beginValue();
+    write( m_pretty ? "{\n" : "{" );
+    m_scopes.push_back( Scope{ false, true } );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::endObject()
+{
+    CAFFA_ASSERT( !m_scopes.empty() && !m_scopes.back().isArray && !m_afterKey );
+    m_scopes.pop_back();
+    if ( m_pretty )
+    {
+        write( "\n" );
+        indent();
+    }
+    write( "}" );
+    endValue();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::beginArray()
+{
+    beginValue();
+    write( m_pretty ? "[\n" : "[" );
+    m_scopes.push_back( Scope{ true, true } );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::endArray()
+{
+    CAFFA_ASSERT( !m_scopes.empty() && m_scopes.back().isArray );
+    m_scopes.pop_back();
+    if ( m_pretty )
+    {
+        write( "\n" );
+        indent();
+    }
+    write( "]" );
+    endValue();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::key( std::string_view key )
+{
+    CAFFA_ASSERT( !m_scopes.empty() && !m_scopes.back().isArray && !m_afterKey );
+
+    auto& scope = m_scopes.back();
+    if ( !scope.isEmpty )
+    {
+        write( m_pretty ? ",\n" : "," );
+    }
+    scope.isEmpty = false;
+    indent();
+
+    writeEscaped( key );
+    write( m_pretty ? " : " : ":" );
+    m_afterKey = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::string( std::string_view string )
+{
+    beginValue();
+    writeEscaped( string );
+    endValue();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::value( const json::value& value )
+{
+    switch ( value.kind() )
+    {
+        case boost::json::kind::object:
+        {
+            beginObject();
+            for ( const auto& [memberKey, memberValue] : value.get_object() )
+            {
+                key( memberKey );
+                this->value( memberValue );
+            }
+            endObject();
+            break;
+        }
+        case boost::json::kind::array:
+        {
+            beginArray();
+            for ( const auto& entry : value.get_array() )
+            {
+                this->value( entry );
+            }
+            endArray();
+            break;
+        }
+        case boost::json::kind::string:
+        {
+            const auto& text = value.get_string();
+            string( std::string_view( text.data(), text.size() ) );
+            break;
+        }
+        case boost::json::kind::int64:
+        {
+            char buffer[NUMBER_BUFFER_SIZE];
+            beginValue();
+            write( formatNumber( buffer, value.get_int64() ) );
+            endValue();
+            break;
+        }
+        case boost::json::kind::uint64:
+        {
+            char buffer[NUMBER_BUFFER_SIZE];
+            beginValue();
+            write( formatNumber( buffer, value.get_uint64() ) );
+            endValue();
+            break;
+        }
+        case boost::json::kind::double_:
+        {
+            beginValue();
+            writeDouble( value );
+            endValue();
+            break;
+        }
+        case boost::json::kind::bool_:
+        {
+            beginValue();
+            write( value.get_bool() ? "true" : "false" );
+            endValue();
+            break;
+        }
+        case boost::json::kind::null:
+        {
+            beginValue();
+            write( "null" );
+            endValue();
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The elements start with their own indentation, so only the separator is written here
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::appendElements( std::string_view elements )
+{
+    CAFFA_ASSERT( !m_scopes.empty() && m_scopes.back().isArray && !m_afterKey &&
+                  "Elements can only be appended inside an array" );
+    if ( elements.empty() ) return;
+
+    auto& scope = m_scopes.back();
+    if ( !scope.isEmpty )
+    {
+        write( m_pretty ? ",\n" : "," );
+    }
+    scope.isEmpty = false;
+    write( elements );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::lineBreak()
+{
+    CAFFA_ASSERT( m_scopes.empty() && !m_afterKey && "Line breaks are only written between top level values" );
+    write( "\n" );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::flush()
+{
+    if ( m_stream && !m_buffer.empty() )
+    {
+        m_stream->write( m_buffer.data(), static_cast<std::streamsize>( m_buffer.size() ) );
+        m_buffer.clear();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Emit the separator and indentation needed in front of a value
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::beginValue()
+{
+    if ( m_afterKey )
+    {
+        m_afterKey = false;
+        return;
+    }
+
+    if ( !m_scopes.empty() )
+    {
+        auto& scope = m_scopes.back();
+        CAFFA_ASSERT( scope.isArray && "Object members have to be preceded by a key" );
+        if ( !scope.isEmpty )
+        {
+            write( m_pretty ? ",\n" : "," );
+        }
+        scope.isEmpty = false;
+        indent();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// A pretty printed document ends with a newline
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::endValue()
+{
+    if ( m_pretty && m_scopes.empty() )
+    {
+        write( "\n" );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::indent()
+{
+    if ( !m_pretty ) return;
+
+    // Deeper levels are written as several slices of the same run of spaces
+    static const std::string spaces( 256u, ' ' );
+
+    size_t count = 2u * m_scopes.size();
+    while ( count > 0u )
+    {
+        const size_t slice = std::min( count, spaces.size() );
+        m_output->append( spaces.data(), slice );
+        count -= slice;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::write( std::string_view text )
+{
+    m_output->append( text );
+    flushIfFull();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write a quoted string, appending runs of characters that need no escaping in one go.
+/// Uses the same escapes as json::dump.
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::writeEscaped( std::string_view text )
+{
+    static constexpr char hexDigits[] = "0123456789abcdef";
+
+    m_output->push_back( '"' );
+
+    size_t runStart = 0u;
+    for ( size_t i = 0u; i < text.size(); ++i )
+    {
+        const auto c = static_cast<unsigned char>( text[i] );
+        if ( c >= 0x20u && c != '"' && c != '\\' ) continue;
+
+        m_output->append( text.data() + runStart, i - runStart );
+        runStart = i + 1u;
+
+        switch ( c )
+        {
+            case '"':
+                m_output->append( "\\\"" );
+                break;
+            case '\\':
+                m_output->append( "\\\\" );
+                break;
+            case '\b':
+                m_output->append( "\\b" );
+                break;
+            case '\f':
+                m_output->append( "\\f" );
+                break;
+            case '\n':
+                m_output->append( "\\n" );
+                break;
+            case '\r':
+                m_output->append( "\\r" );
+                break;
+            case '\t':
+                m_output->append( "\\t" );
+                break;
+            default:
+            {
+                const char escape[] = { '\\', 'u', '0', '0', hexDigits[c >> 4u], hexDigits[c & 0xfu] };
+                m_output->append( escape, sizeof( escape ) );
+                break;
+            }
+        }
+    }
+    m_output->append( text.data() + runStart, text.size() - runStart );
+    m_output->push_back( '"' );
+
+    flushIfFull();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The compact output keeps the number format of json::dump. The pretty output uses the shortest form which
+/// reads back to the same double, marked as a double with a trailing ".0" if it would otherwise read as an integer.
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::writeDouble( const json::value& value )
+{
+    const double number = value.get_double();
+    if ( !m_pretty || !std::isfinite( number ) )
+    {
+        write( boost::json::serialize( value ) );
+        return;
+    }
+
+    char buffer[NUMBER_BUFFER_SIZE];
+    auto text = formatNumber( buffer, number );
+    m_output->append( text );
+    if ( text.find_first_of( ".e" ) == std::string_view::npos )
+    {
+        m_output->append( ".0" );
+    }
+    flushIfFull();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void JsonStreamWriter::flushIfFull()
+{
+    if ( m_stream && m_buffer.size() >= m_bufferSize )
+    {
+        flush();
+    }
+}
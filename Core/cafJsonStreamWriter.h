@@ -0,0 +1,144 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonDefinitions.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caffa
+{
+/**
+ * Forward-only JSON token writer.
+ *
+ * Tokens are formatted into a buffer which is flushed to the output stream whenever it fills up, or appended
+ * directly to a caller-supplied string. Memory use is therefore bounded by the buffer size and the nesting depth,
+ * not by the size of the document. Strings are escaped and numbers formatted straight into the buffer.
+ * The compact output is identical to json::dump. The pretty output is indented by two spaces per level and writes
+ * doubles in the shortest form which reads back to the same value.
+ */
+class JsonStreamWriter
+{
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64u * 1024u;
+
+    /**
+     * Construct a writer flushing to an output stream
+     * @param stream The output stream
+     * @param pretty If true will pretty print with indentation and newlines
+     * @param bufferSize The number of bytes to buffer before flushing to the stream
+     */
+    explicit JsonStreamWriter( std::ostream& stream, bool pretty = false, size_t bufferSize = DEFAULT_BUFFER_SIZE );
+
+    /**
+     * Construct a writer appending to a caller-supplied string
+     * @param output The string to append to
+     * @param pretty If true will pretty print with indentation and newlines
+     */
+    explicit JsonStreamWriter( std::string& output, bool pretty = false );
+
+    /**
+     * Construct a writer appending elements of the array arrayWriter is writing to a caller-supplied string, so
+     * the elements can be written apart from the array, for instance on other threads. The elements are formatted
+     * as they would have been by arrayWriter and are added to the array with appendElements.
+     * @param output The string to append to
+     * @param arrayWriter A writer inside an array
+     */
+    JsonStreamWriter( std::string& output, const JsonStreamWriter& arrayWriter );
+
+    ~JsonStreamWriter() noexcept;
+
+    JsonStreamWriter( const JsonStreamWriter& )            = delete;
+    JsonStreamWriter& operator=( const JsonStreamWriter& ) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * Write an object member key. Has to be followed by exactly one value.
+     * @param key The unescaped key
+     */
+    void key( std::string_view key );
+
+    /**
+     * Write a string value
+     * @param string The unescaped string
+     */
+    void string( std::string_view string );
+
+    /**
+     * Write a complete JSON value, recursing into arrays and objects.
+     * @param value The JSON value
+     */
+    void value( const json::value& value );
+
+    /**
+     * Add array elements written by a writer constructed for this array
+     * @param elements The elements as written by the other writer. May be empty.
+     */
+    void appendElements( std::string_view elements );
+
+    /**
+     * Write a line break between top level values, as in newline-delimited JSON
+     */
+    void lineBreak();
+
+    /**
+     * Write any buffered output to the stream
+     */
+    void flush();
+
+    /**
+     * The current nesting depth. Zero at the top level.
+     */
+    [[nodiscard]] size_t depth() const { return m_scopes.size(); }
+
+    [[nodiscard]] bool pretty() const { return m_pretty; }
+
+private:
+    void beginValue();
+    void endValue();
+    void indent();
+    void write( std::string_view text );
+    void writeEscaped( std::string_view text );
+    void writeDouble( const json::value& value );
+    void flushIfFull();
+
+    struct Scope
+    {
+        bool isArray;
+        bool isEmpty;
+    };
+
+    std::ostream* m_stream;
+    std::string   m_buffer;
+    std::string*  m_output;
+    size_t        m_bufferSize;
+    bool          m_pretty;
+    bool          m_afterKey;
+
+    std::vector<Scope> m_scopes;
+};
+
+} // namespace caffa
@@ -0,0 +1,174 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafMappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define CAFFA_HAS_MMAP
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace caffa;
+
+#ifdef CAFFA_HAS_MMAP
+
+namespace
+{
+std::string errorText( const std::filesystem::path& path, const std::string& action )
+{
+    return "Failed to " + action + " '" + path.string() + "': " + std::strerror( errno );
+}
+
+size_t pageSize()
+{
+    static const size_t size = static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+    return size;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MappedFile::MappedFile( const std::filesystem::path& path )
+    : m_data( nullptr )
+    , m_size( 0u )
+    , m_releasedSize( 0u )
+{
+    int fileDescriptor = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fileDescriptor < 0 )
+    {
+        throw std::runtime_error( errorText( path, "open" ) );
+    }
+
+    struct stat fileStatus;
+    if ( ::fstat( fileDescriptor, &fileStatus ) != 0 )
+    {
+        auto errorMessage = errorText( path, "read the size of" );
+        ::close( fileDescriptor );
+        throw std::runtime_error( errorMessage );
+    }
+    m_size = static_cast<size_t>( fileStatus.st_size );
+
+    // Empty files can not be mapped, and are represented by an empty view
+    if ( m_size > 0u )
+    {
+        void* data = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+        if ( data == MAP_FAILED )
+        {
+            auto errorMessage = errorText( path, "map" );
+            ::close( fileDescriptor );
+            throw std::runtime_error( errorMessage );
+        }
+        m_data = static_cast<const char*>( data );
+
+        // Only a hint, so failures are ignored
+        ::madvise( data, m_size, MADV_SEQUENTIAL );
+    }
+
+    // The mapping stays valid after the file is closed
+    ::close( fileDescriptor );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    if ( m_data )
+    {
+        ::munmap( const_cast<char*>( m_data ), m_size );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MappedFile::release( size_t offset )
+{
+    if ( !m_data ) return;
+
+    // Only whole pages can be released
+    const size_t end = std::min( offset, m_size ) / pageSize() * pageSize();
+    if ( end <= m_releasedSize ) return;
+
+    ::madvise( const_cast<char*>( m_data ) + m_releasedSize, end - m_releasedSize, MADV_DONTNEED );
+    m_releasedSize = end;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool MappedFile::isSupported()
+{
+    return true;
+}
+
+#else
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MappedFile::MappedFile( const std::filesystem::path& path )
+    : m_data( nullptr )
+    , m_size( 0u )
+    , m_releasedSize( 0u )
+{
+    throw std::runtime_error( "Failed to map '" + path.string() + "': Memory mapped files are not supported" );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MappedFile::release( size_t )
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool MappedFile::isSupported()
+{
+    return false;
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string_view MappedFile::view() const
+{
+    return std::string_view( m_data, m_size );
+}
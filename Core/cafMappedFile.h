@@ -0,0 +1,71 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace caffa
+{
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * The mapping is advised for sequential access, and pages that have been consumed can be released early. This
+ * keeps the resident memory of a single pass over a large file small, and the file is parsed straight from the
+ * page cache without being copied.
+ * Memory mapping is only available on POSIX platforms. Check isSupported() before use.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Map a file. Throws std::runtime_error if the file can not be opened or mapped.
+     * @param path The file to map
+     */
+    explicit MappedFile( const std::filesystem::path& path );
+    ~MappedFile();
+
+    MappedFile( const MappedFile& )            = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    /**
+     * The contents of the file
+     */
+    [[nodiscard]] std::string_view view() const;
+
+    /**
+     * Release the pages holding the file contents before the given offset. The contents before the offset must not
+     * be accessed afterwards.
+     * @param offset The number of bytes from the start of the file that are no longer needed
+     */
+    void release( size_t offset );
+
+    /**
+     * Whether memory mapped files are available on this platform
+     */
+    [[nodiscard]] static bool isSupported();
+
+private:
+    const char* m_data;
+    size_t      m_size;
+    size_t      m_releasedSize;
+};
+
+} // namespace caffa
@@ -0,0 +1,246 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafNdjson.h"
+
+#include "cafAssert.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafJsonStreamReader.h"
+#include "cafLogger.h"
+#include "cafObjectHandle.h"
+#include "cafParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+
+using namespace caffa;
+
+namespace
+{
+void checkDataSerializer( const JsonSerializer& serializer )
+{
+    if ( serializer.serializationType() != JsonSerializer::SerializationType::DATA_FULL &&
+         serializer.serializationType() != JsonSerializer::SerializationType::DATA_SKELETON )
+    {
+        throw std::runtime_error( "NDJSON can only be used with data serialization types" );
+    }
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+NdjsonWriter::NdjsonWriter( const JsonSerializer& serializer, size_t bufferSize /* = DEFAULT_BUFFER_SIZE */ )
+    : m_serializer( serializer )
+    , m_bufferSize( bufferSize )
+{
+    checkDataSerializer( m_serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonWriter::write( ChildArrayFieldHandle& field, std::ostream& stream ) const
+{
+    return writeRange( field, 0u, field.size(), stream );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonWriter::write( ChildArrayFieldHandle& field, std::span<std::ostream* const> streams ) const
+{
+    if ( streams.empty() ) return 0u;
+
+    const size_t count      = field.size();
+    const size_t shardCount = streams.size();
+
+    std::atomic<size_t> written = 0u;
+    parallelFor( shardCount,
+                 1u,
+                 [this, &field, &streams, &written, count, shardCount]( size_t begin, size_t end )
+                 {
+                     for ( size_t shard = begin; shard < end; ++shard )
+                     {
+                         CAFFA_ASSERT( streams[shard] );
+                         written += writeRange( field,
+                                                shard * count / shardCount,
+                                                ( shard + 1u ) * count / shardCount,
+                                                *streams[shard] );
+                     }
+                 } );
+    return written.load();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the children [begin, end) one per line
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonWriter::writeRange( ChildArrayFieldHandle& field, size_t begin, size_t end, std::ostream& stream ) const
+{
+    CAFFA_TRACE( "Writing children " << begin << " to " << end << " of " << field.keyword() << " as NDJSON" );
+
+    JsonStreamWriter writer( stream, false, m_bufferSize );
+
+    size_t written = 0u;
+    for ( size_t i = begin; i < end; ++i )
+    {
+        auto object = field.at( i );
+        if ( !object ) continue;
+
+        m_serializer.writeObjectToStream( object.get(), writer );
+        writer.lineBreak();
+        ++written;
+    }
+    writer.flush();
+    return written;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+NdjsonReader::NdjsonReader( const JsonSerializer& serializer, size_t windowSize /* = DEFAULT_WINDOW_SIZE */ )
+    : m_serializer( serializer )
+    , m_windowSize( std::max( windowSize, size_t( 1u ) ) )
+{
+    checkDataSerializer( m_serializer );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonReader::read( std::istream& stream, ChildArrayFieldHandle& field ) const
+{
+    // The lines are read into the same strings for every window, so their buffers are reused
+    std::vector<Line> window( m_windowSize );
+
+    size_t appended   = 0u;
+    size_t lineNumber = 0u;
+    size_t count      = 0u;
+    while ( std::getline( stream, window[count].text ) )
+    {
+        auto& line  = window[count];
+        line.number = ++lineNumber;
+
+        if ( !line.text.empty() && line.text.back() == '\r' ) line.text.pop_back();
+        if ( line.text.find_first_not_of( " \t" ) == std::string::npos ) continue;
+
+        if ( ++count == window.size() )
+        {
+            appended += readWindow( window, field );
+            count = 0u;
+        }
+    }
+    if ( stream.bad() )
+    {
+        throw std::runtime_error( "Failed to read NDJSON after line " + std::to_string( lineNumber ) );
+    }
+
+    appended += readWindow( std::span<const Line>( window ).first( count ), field );
+    return appended;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonReader::read( const std::filesystem::path& path, ChildArrayFieldHandle& field ) const
+{
+    std::ifstream stream( path, std::ios::binary );
+    if ( !stream )
+    {
+        throw std::runtime_error( "Failed to open '" + path.string() + "'" );
+    }
+    return read( stream, field );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonReader::windowSize() const
+{
+    return m_windowSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Create the objects of a window of lines and append them to the field in one go
+//--------------------------------------------------------------------------------------------------
+size_t NdjsonReader::readWindow( std::span<const Line> lines, ChildArrayFieldHandle& field ) const
+{
+    if ( lines.empty() ) return 0u;
+
+    std::vector<std::shared_ptr<ObjectHandle>> objects( lines.size() );
+
+    auto readLines = [this, &lines, &objects]( const JsonSerializer& serializer, size_t begin, size_t end )
+    {
+        for ( size_t i = begin; i < end; ++i )
+        {
+            objects[i] = readLine( lines[i], serializer );
+        }
+    };
+
+    const size_t threshold = m_serializer.parallelReadThreshold();
+    if ( threshold > 0u && lines.size() >= threshold )
+    {
+        // Memory resources are generally not thread safe, so the workers read with a serializer on the default heap
+        JsonSerializer workerSerializer( m_serializer );
+        workerSerializer.setMemoryResource( {} );
+
+        // Use a few chunks per thread, since the lines may differ a lot in size
+        const size_t grainSize = std::max( lines.size() / ( parallelThreadCount() * 8u ), size_t( 1u ) );
+        parallelFor( lines.size(),
+                     grainSize,
+                     [&readLines, &workerSerializer]( size_t begin, size_t end )
+                     { readLines( workerSerializer, begin, end ); } );
+    }
+    else
+    {
+        readLines( m_serializer, 0u, lines.size() );
+    }
+
+    std::erase( objects, nullptr );
+
+    // Objects of classes the field can not hold are left out by the field
+    const size_t sizeBefore = field.size();
+    field.push_back_objs( std::move( objects ) );
+    return field.size() - sizeBefore;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Create the object of a single line. Returns nullptr if the class is missing or unknown.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ObjectHandle> NdjsonReader::readLine( const Line& line, const JsonSerializer& serializer ) const
+{
+    try
+    {
+        JsonStreamReader reader( serializer );
+        reader.write( line.text );
+        reader.finish();
+
+        auto object = reader.createdObject();
+        if ( !object )
+        {
+            CAFFA_ERROR( "Skipping NDJSON line " << line.number << " with a missing or unknown class keyword" );
+        }
+        return object;
+    }
+    catch ( const std::runtime_error& e )
+    {
+        throw std::runtime_error( "Invalid NDJSON on line " + std::to_string( line.number ) + ": " + e.what() );
+    }
+}
@@ -0,0 +1,137 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include "cafJsonSerializer.h"
+#include "cafJsonStreamWriter.h"
+
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace caffa
+{
+class ChildArrayFieldHandle;
+
+/**
+ * Writes the children of a child array field as newline-delimited JSON (NDJSON), one object per line.
+ *
+ * Each child is written as a top level object by the serializer, so its field selector, projection and uuid settings
+ * apply. The lines go through a JsonStreamWriter, so the memory used is bounded by the writer buffer and the size of
+ * a single child, however many children there are. Children which are null are left out.
+ */
+class NdjsonWriter
+{
+public:
+    /**
+     * Constructor
+     * @param serializer The serializer used to write each child. Only data serialization types are supported.
+     * @param bufferSize The number of bytes to buffer before flushing to the stream
+     */
+    explicit NdjsonWriter( const JsonSerializer& serializer,
+                           size_t                bufferSize = JsonStreamWriter::DEFAULT_BUFFER_SIZE );
+
+    /**
+     * Write the children of a field to a stream
+     * @param field The child array field
+     * @param stream The output stream
+     * @return The number of children written
+     */
+    size_t write( ChildArrayFieldHandle& field, std::ostream& stream ) const;
+
+    /**
+     * Write the children of a field split into consecutive shards, one for each stream.
+     * The shards are written in parallel (see cafParallelFor.h) and hold about the same number of children.
+     * Concatenating the shards in order gives the same text as writing all the children to a single stream.
+     *
+     * @param field The child array field
+     * @param streams The output stream of each shard
+     * @return The number of children written across all shards
+     */
+    size_t write( ChildArrayFieldHandle& field, std::span<std::ostream* const> streams ) const;
+
+private:
+    size_t writeRange( ChildArrayFieldHandle& field, size_t begin, size_t end, std::ostream& stream ) const;
+
+    JsonSerializer m_serializer;
+    size_t         m_bufferSize;
+};
+
+/**
+ * Reads newline-delimited JSON (NDJSON), one object per line, and appends the objects to a child array field.
+ *
+ * Lines are read in windows of a fixed number of lines. The objects of each window are created through the object
+ * factory of the serializer, read with the stream reader and appended to the field in a single bulk insert before
+ * the next window is read. No more than one window of lines and objects is held at any time, so the memory used
+ * does not depend on the number of lines.
+ *
+ * Windows with at least the parallel read threshold of the serializer are read on several threads
+ * (see cafParallelFor.h), in which case the object factory and the constructors of the classes read must be safe to
+ * call concurrently. Empty lines are skipped, as are objects of unknown classes or of a class the field can not hold.
+ */
+class NdjsonReader
+{
+public:
+    static constexpr size_t DEFAULT_WINDOW_SIZE = 4096u;
+
+    /**
+     * Constructor
+     * @param serializer The serializer used to read each line. Only data serialization types are supported.
+     * @param windowSize The largest number of lines read before the objects are appended to the field
+     */
+    explicit NdjsonReader( const JsonSerializer& serializer, size_t windowSize = DEFAULT_WINDOW_SIZE );
+
+    /**
+     * Read objects from a stream and append them to a field.
+     * Throws std::runtime_error with the line number if a line is not a valid object. The objects of the windows
+     * before the failing one have been appended by then.
+     *
+     * @param stream The input stream
+     * @param field The child array field to append to
+     * @return The number of objects appended
+     */
+    size_t read( std::istream& stream, ChildArrayFieldHandle& field ) const;
+
+    /**
+     * Read objects from a file and append them to a field, like above
+     * @param path The path of the file
+     * @param field The child array field to append to
+     * @return The number of objects appended
+     */
+    size_t read( const std::filesystem::path& path, ChildArrayFieldHandle& field ) const;
+
+    [[nodiscard]] size_t windowSize() const;
+
+private:
+    struct Line
+    {
+        size_t      number = 0u;
+        std::string text;
+    };
+
+    size_t                        readWindow( std::span<const Line> lines, ChildArrayFieldHandle& field ) const;
+    std::shared_ptr<ObjectHandle> readLine( const Line& line, const JsonSerializer& serializer ) const;
+
+    JsonSerializer m_serializer;
+    size_t         m_windowSize;
+};
+
+} // namespace caffa
@@ -0,0 +1,206 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+using namespace caffa;
+
+namespace
+{
+thread_local bool insideParallelFor = false;
+
+std::atomic<size_t> maxThreadCount = 0u;
+
+/**
+ * A parallel loop shared by the calling thread and the pool threads helping it.
+ */
+struct ParallelJob
+{
+    size_t              count;
+    size_t              grainSize;
+    size_t              chunkCount;
+    const ParallelBody* body;
+
+    std::atomic<size_t> nextChunk = 0u;
+    std::atomic<bool>   failed    = false;
+    std::exception_ptr  firstException;
+    std::mutex          exceptionMutex;
+
+    // Guarded by the mutex of the pool
+    size_t helpersWanted = 0u;
+    size_t activeHelpers = 0u;
+
+    void process();
+};
+
+/**
+ * Threads kept alive between parallel loops, so a loop does not pay for starting threads. The pool grows to the
+ * largest number of helpers asked for and the threads are stopped when the program exits.
+ */
+class ThreadPool
+{
+public:
+    static ThreadPool& instance();
+
+    void run( ParallelJob& job, size_t helperCount );
+
+private:
+    void workerLoop( std::stop_token stopToken );
+
+    std::mutex                  m_mutex;
+    std::condition_variable_any m_jobPosted;
+    std::condition_variable     m_helpersDone;
+    std::deque<ParallelJob*>    m_jobs;
+    std::vector<std::jthread>   m_threads; // Last, so the threads are joined before the rest is destroyed
+};
+
+//--------------------------------------------------------------------------------------------------
+/// Process chunks until there are none left or the body has thrown
+//--------------------------------------------------------------------------------------------------
+void ParallelJob::process()
+{
+    for ( size_t chunk = nextChunk++; chunk < chunkCount && !failed; chunk = nextChunk++ )
+    {
+        const size_t begin = chunk * grainSize;
+        const size_t end   = std::min( begin + grainSize, count );
+        try
+        {
+            ( *body )( begin, end );
+        }
+        catch ( ... )
+        {
+            std::scoped_lock lock( exceptionMutex );
+            if ( !firstException ) firstException = std::current_exception();
+            failed = true;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Post the job to up to helperCount pool threads, work on it on the calling thread and return once no pool
+/// thread is working on it any more. Helpers busy with other jobs are not waited for.
+//--------------------------------------------------------------------------------------------------
+void ThreadPool::run( ParallelJob& job, size_t helperCount )
+{
+    {
+        std::scoped_lock lock( m_mutex );
+        while ( m_threads.size() < helperCount )
+        {
+            m_threads.emplace_back( [this]( std::stop_token stopToken ) { workerLoop( stopToken ); } );
+        }
+        job.helpersWanted = helperCount;
+        m_jobs.push_back( &job );
+    }
+    m_jobPosted.notify_all();
+
+    insideParallelFor = true;
+    job.process();
+    insideParallelFor = false;
+
+    std::unique_lock lock( m_mutex );
+    if ( job.helpersWanted > 0u ) std::erase( m_jobs, &job );
+    m_helpersDone.wait( lock, [&job]() { return job.activeHelpers == 0u; } );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ThreadPool::workerLoop( std::stop_token stopToken )
+{
+    insideParallelFor = true;
+
+    std::unique_lock lock( m_mutex );
+    while ( m_jobPosted.wait( lock, stopToken, [this]() { return !m_jobs.empty(); } ) )
+    {
+        ParallelJob* job = m_jobs.front();
+        if ( --job->helpersWanted == 0u ) m_jobs.pop_front();
+        ++job->activeHelpers;
+
+        lock.unlock();
+        job->process();
+        lock.lock();
+
+        if ( --job->activeHelpers == 0u ) m_helpersDone.notify_all();
+    }
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void caffa::parallelFor( size_t count, size_t grainSize, const ParallelBody& body )
+{
+    if ( count == 0u ) return;
+
+    grainSize                = std::max( grainSize, size_t( 1u ) );
+    const size_t chunkCount  = ( count + grainSize - 1u ) / grainSize;
+    const size_t threadCount = std::min( chunkCount, parallelThreadCount() );
+
+    if ( threadCount <= 1u || insideParallelFor )
+    {
+        body( 0u, count );
+        return;
+    }
+
+    ParallelJob job;
+    job.count      = count;
+    job.grainSize  = grainSize;
+    job.chunkCount = chunkCount;
+    job.body       = &body;
+
+    ThreadPool::instance().run( job, threadCount - 1u );
+
+    if ( job.firstException ) std::rethrow_exception( job.firstException );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void caffa::setParallelThreadCount( size_t threadCount )
+{
+    maxThreadCount = threadCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t caffa::parallelThreadCount()
+{
+    if ( const size_t threadCount = maxThreadCount; threadCount > 0u ) return threadCount;
+
+    return std::max( size_t( std::thread::hardware_concurrency() ), size_t( 1u ) );
+}
@@ -0,0 +1,59 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace caffa
+{
+/**
+ * The body of a parallel loop. Called with a half open range [begin, end) of indices.
+ */
+using ParallelBody = std::function<void( size_t begin, size_t end )>;
+
+/**
+ * Run a loop body over the indices [0, count) on several threads.
+ *
+ * The indices are split into consecutive chunks of grainSize indices, which are handed out in order to the calling
+ * thread and to the threads of a pool that is kept alive between calls. Each chunk is processed exactly once, but
+ * the order in which chunks finish is not defined, so the body must only write to data belonging to its own indices.
+ *
+ * Calls made from inside a loop body run the whole range on the calling thread, so nested parallel loops do not
+ * multiply the number of threads. If the body throws, no new chunks are started and the first exception is
+ * rethrown on the calling thread once all workers have stopped.
+ *
+ * @param count The number of indices
+ * @param grainSize The number of indices in each chunk. 0 is treated as 1.
+ * @param body The loop body
+ */
+void parallelFor( size_t count, size_t grainSize, const ParallelBody& body );
+
+/**
+ * Set the largest number of threads used by parallelFor, including the calling thread
+ * @param threadCount The number of threads or 0 to use the number of hardware threads (the default)
+ */
+void setParallelThreadCount( size_t threadCount );
+
+/**
+ * The largest number of threads used by parallelFor, including the calling thread
+ */
+[[nodiscard]] size_t parallelThreadCount();
+
+} // namespace caffa
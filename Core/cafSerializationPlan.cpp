@@ -0,0 +1,180 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#include "cafSerializationPlan.h"
+
+#include "cafAssert.h"
+#include "cafChildArrayFieldHandle.h"
+#include "cafChildFieldHandle.h"
+#include "cafFieldHandle.h"
+#include "cafFieldIoCapability.h"
+#include "cafObjectHandle.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+
+using namespace caffa;
+
+namespace
+{
+/// Plans are kept for the lifetime of the process, so references to them stay valid
+class PlanCache
+{
+public:
+    static PlanCache& instance()
+    {
+        static PlanCache cache;
+        return cache;
+    }
+
+    const SerializationPlan& plan( const ObjectHandle* object, const std::type_info& type )
+    {
+        {
+            std::shared_lock lock( m_mutex );
+            if ( auto it = m_plans.find( type ); it != m_plans.end() ) return *it->second;
+        }
+
+        std::unique_lock lock( m_mutex );
+        auto& cachedPlan = m_plans[type];
+        if ( !cachedPlan ) cachedPlan = std::make_unique<SerializationPlan>( object );
+        return *cachedPlan;
+    }
+
+private:
+    std::shared_mutex                                                       m_mutex;
+    std::unordered_map<std::type_index, std::unique_ptr<SerializationPlan>> m_plans;
+};
+
+SerializationPlan::FieldKind fieldKind( const FieldHandle* field )
+{
+    if ( dynamic_cast<const ChildArrayFieldHandle*>( field ) ) return SerializationPlan::FieldKind::CHILD_ARRAY;
+    if ( dynamic_cast<const ChildFieldHandle*>( field ) ) return SerializationPlan::FieldKind::CHILD;
+    return SerializationPlan::FieldKind::DATA;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SerializationPlan::SerializationPlan( const ObjectHandle* object )
+{
+    CAFFA_ASSERT( object );
+
+    const auto* objectAddress = reinterpret_cast<const char*>( object );
+
+    // The fields come in keyword order, which findEntry() relies on
+    auto fields = object->fields();
+    m_entries.reserve( fields.size() );
+    for ( auto field : fields )
+    {
+        m_entries.push_back( { .keyword           = field->keyword(),
+                               .offset            = reinterpret_cast<const char*>( field ) - objectAddress,
+                               .ioCapabilityIndex = field->capabilityIndex<FieldIoCapability>(),
+                               .kind              = fieldKind( field ),
+                               .deprecated        = field->isDeprecated() } );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const SerializationPlan& SerializationPlan::forObject( const ObjectHandle*               object,
+                                                       std::optional<SerializationPlan>& ownPlan )
+{
+    CAFFA_ASSERT( object );
+
+    const std::type_info& type = typeid( *object );
+
+    // Objects tend to come in long runs of the same class, such as the children of an array.
+    // Remembering the last plan on each thread keeps those from contending on the cache lock.
+    thread_local const std::type_info*    lastType = nullptr;
+    thread_local const SerializationPlan* lastPlan = nullptr;
+
+    if ( !lastType || *lastType != type )
+    {
+        lastPlan = &PlanCache::instance().plan( object, type );
+        lastType = &type;
+    }
+
+    if ( !lastPlan->matches( object ) )
+    {
+        return ownPlan.emplace( object );
+    }
+    return *lastPlan;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Check that the object has a field with the keyword of each entry at the place of the entry. Only addresses are
+/// compared, since the place of an entry may be anywhere in an object of another layout.
+//--------------------------------------------------------------------------------------------------
+bool SerializationPlan::matches( const ObjectHandle* object ) const
+{
+    if ( m_entries.size() != object->fieldCount() ) return false;
+
+    const auto* objectAddress = reinterpret_cast<const char*>( object );
+    for ( const auto& entry : m_entries )
+    {
+        const auto* field = object->findField( entry.keyword );
+        if ( !field || reinterpret_cast<const char*>( field ) - objectAddress != entry.offset ) return false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const std::vector<SerializationPlan::Entry>& SerializationPlan::entries() const
+{
+    return m_entries;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const SerializationPlan::Entry* SerializationPlan::findEntry( std::string_view keyword ) const
+{
+    auto it = std::lower_bound( m_entries.begin(),
+                                m_entries.end(),
+                                keyword,
+                                []( const Entry& entry, std::string_view value ) { return entry.keyword < value; } );
+    return it != m_entries.end() && it->keyword == keyword ? &*it : nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FieldHandle* SerializationPlan::field( const ObjectHandle* object, const Entry& entry )
+{
+    auto* objectAddress = const_cast<char*>( reinterpret_cast<const char*>( object ) );
+    auto* field         = reinterpret_cast<FieldHandle*>( objectAddress + entry.offset );
+    CAFFA_ASSERT( field->ownerObject() == object && "Serialization plan used with an object of another layout" );
+    return field;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FieldIoCapability* SerializationPlan::ioCapability( FieldHandle* field, const Entry& entry )
+{
+    if ( !entry.ioCapabilityIndex ) return nullptr;
+    return field->capabilityAt<FieldIoCapability>( *entry.ioCapabilityIndex );
+}
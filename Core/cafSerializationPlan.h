@@ -0,0 +1,112 @@
+// ##################################################################################################
+//
+//    Caffa
+//    Copyright (C) 2026- Kontur AS
+//
+//    GNU Lesser General Public License Usage
+//    This library is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation; either version 2.1 of the License, or
+//    (at your option) any later version.
+//
+//    This library is distributed in the hope that it will be useful, but WITHOUT ANY
+//    WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//    FITNESS FOR A PARTICULAR PURPOSE.
+//
+//    See the GNU Lesser General Public License at <<http://www.gnu.org/licenses/lgpl-2.1.html>>
+//    for more details.
+//
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caffa
+{
+class FieldHandle;
+class FieldIoCapability;
+class ObjectHandle;
+
+/**
+ * The field layout of a class, worked out from the first object of the class and reused for every other object.
+ *
+ * For each field the plan holds the keyword, where the field sits in the object, where the IO capability sits among
+ * the field capabilities, what kind of field it is and whether it is deprecated. Reading and writing an object
+ * through its plan avoids listing the fields, copying keywords and searching for capabilities on every object.
+ *
+ * Plans are shared between objects of the same dynamic type. They rely on every object of a type registering the
+ * same member fields with the same capabilities, as done with initField() in the constructor. An object whose
+ * fields do not have the keywords and places of the plan of its type is given a plan of its own.
+ */
+class SerializationPlan
+{
+public:
+    enum class FieldKind
+    {
+        DATA,
+        CHILD,
+        CHILD_ARRAY
+    };
+
+    struct Entry
+    {
+        std::string           keyword;
+        std::ptrdiff_t        offset;
+        std::optional<size_t> ioCapabilityIndex;
+        FieldKind             kind;
+        bool                  deprecated;
+    };
+
+    /**
+     * Build a plan from the fields of an object
+     * @param object The object to take the field layout from
+     */
+    explicit SerializationPlan( const ObjectHandle* object );
+
+    /**
+     * Get the plan for an object. The plan of the object type is built on first use and shared. Thread safe.
+     * @param object The object to get the plan for
+     * @param ownPlan Storage for a plan built for this object alone, if it does not match the plan of its type
+     * @return the plan for the object
+     */
+    [[nodiscard]] static const SerializationPlan& forObject( const ObjectHandle*               object,
+                                                             std::optional<SerializationPlan>& ownPlan );
+
+    /**
+     * The fields in keyword order
+     */
+    [[nodiscard]] const std::vector<Entry>& entries() const;
+
+    /**
+     * Find a field entry by keyword
+     * @param keyword The field keyword
+     * @return the entry or nullptr if the class has no such field
+     */
+    [[nodiscard]] const Entry* findEntry( std::string_view keyword ) const;
+
+    /**
+     * Get the field of an entry in an object
+     * @param object An object of the type the plan was built for
+     * @param entry An entry of this plan
+     * @return the field
+     */
+    [[nodiscard]] static FieldHandle* field( const ObjectHandle* object, const Entry& entry );
+
+    /**
+     * Get the IO capability of an entry field
+     * @param field The field returned by field() for the entry
+     * @param entry An entry of this plan
+     * @return the capability or nullptr if the field has none
+     */
+    [[nodiscard]] static FieldIoCapability* ioCapability( FieldHandle* field, const Entry& entry );
+
+private:
+    [[nodiscard]] bool matches( const ObjectHandle* object ) const;
+
+    std::vector<Entry> m_entries;
+};
+
+} // namespace caffa
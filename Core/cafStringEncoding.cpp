@@ -366,22 +366,13 @@ namespace detail
 
 } // namespace detail
 
-template <class OutputBuffer, class InputIterator>
-inline OutputBuffer encode_into( InputIterator begin, InputIterator end )
+inline size_t encoded_size( size_t binarytextsize )
 {
-    typedef std::decay_t<decltype( *begin )> input_value_type;
-    static_assert( std::is_same_v<input_value_type, char> || std::is_same_v<input_value_type, signed char> ||
-                   std::is_same_v<input_value_type, unsigned char> || std::is_same_v<input_value_type, std::byte> );
-    typedef typename OutputBuffer::value_type output_value_type;
-    static_assert( std::is_same_v<output_value_type, char> || std::is_same_v<output_value_type, signed char> ||
-                   std::is_same_v<output_value_type, unsigned char> || std::is_same_v<output_value_type, std::byte> );
-    const size_t binarytextsize = end - begin;
-    const size_t encodedsize    = ( binarytextsize / 3 + ( binarytextsize % 3 > 0 ) ) << 2;
-    OutputBuffer encoded( encodedsize, detail::padding_char );
-
-    const uint8_t* bytes        = reinterpret_cast<const uint8_t*>( &*begin );
-    char*          currEncoding = reinterpret_cast<char*>( &encoded[0] );
+    return ( binarytextsize / 3 + ( binarytextsize % 3 > 0 ) ) << 2;
+}
 
+inline void encode_to( const uint8_t* bytes, size_t binarytextsize, char* currEncoding )
+{
     for ( size_t i = binarytextsize / 3; i; --i )
     {
         const uint8_t t1 = *bytes++;
@@ -404,8 +395,8 @@ inline OutputBuffer encode_into( InputIterator begin, InputIterator end )
             const uint8_t t1 = bytes[0];
             *currEncoding++  = detail::encode_table_0[t1];
             *currEncoding++  = detail::encode_table_1[( t1 & 0x03 ) << 4];
-            // *currEncoding++ = detail::padding_char;
-            // *currEncoding++ = detail::padding_char;
+            *currEncoding++  = detail::padding_char;
+            *currEncoding++  = detail::padding_char;
             break;
         }
         case 2:
@@ -415,7 +406,7 @@ inline OutputBuffer encode_into( InputIterator begin, InputIterator end )
             *currEncoding++  = detail::encode_table_0[t1];
             *currEncoding++  = detail::encode_table_1[( ( t1 & 0x03 ) << 4 ) | ( ( t2 >> 4 ) & 0x0F )];
             *currEncoding++  = detail::encode_table_1[( t2 & 0x0F ) << 2];
-            // *currEncoding++ = detail::padding_char;
+            *currEncoding++  = detail::padding_char;
             break;
         }
         default:
@@ -423,7 +414,22 @@ inline OutputBuffer encode_into( InputIterator begin, InputIterator end )
             throw std::runtime_error{ "Invalid base64 encoded data" };
         }
     }
+}
 
+template <class OutputBuffer, class InputIterator>
+inline OutputBuffer encode_into( InputIterator begin, InputIterator end )
+{
+    typedef std::decay_t<decltype( *begin )> input_value_type;
+    static_assert( std::is_same_v<input_value_type, char> || std::is_same_v<input_value_type, signed char> ||
+                   std::is_same_v<input_value_type, unsigned char> || std::is_same_v<input_value_type, std::byte> );
+    typedef typename OutputBuffer::value_type output_value_type;
+    static_assert( std::is_same_v<output_value_type, char> || std::is_same_v<output_value_type, signed char> ||
+                   std::is_same_v<output_value_type, unsigned char> || std::is_same_v<output_value_type, std::byte> );
+    const size_t binarytextsize = end - begin;
+    OutputBuffer encoded( encoded_size( binarytextsize ), detail::padding_char );
+    if ( binarytextsize == 0 ) return encoded;
+
+    encode_to( reinterpret_cast<const uint8_t*>( &*begin ), binarytextsize, reinterpret_cast<char*>( &encoded[0] ) );
     return encoded;
 }
 
@@ -438,15 +444,11 @@ inline std::string to_base64( std::string_view data )
     return encode_into<std::string>( std::begin( data ), std::end( data ) );
 }
 
-template <class OutputBuffer>
-inline OutputBuffer decode_into( std::string_view base64Text )
+inline size_t padding_size( std::string_view base64Text )
 {
-    typedef typename OutputBuffer::value_type output_value_type;
-    static_assert( std::is_same_v<output_value_type, char> || std::is_same_v<output_value_type, signed char> ||
-                   std::is_same_v<output_value_type, unsigned char> || std::is_same_v<output_value_type, std::byte> );
     if ( base64Text.empty() )
     {
-        return OutputBuffer();
+        return 0;
     }
 
     if ( ( base64Text.size() & 3 ) != 0 )
@@ -459,12 +461,26 @@ inline OutputBuffer decode_into( std::string_view base64Text )
     {
         throw std::runtime_error{ "Invalid base64 encoded data - Found more than 2 padding signs" };
     }
+    return numPadding;
+}
 
-    const size_t decodedsize = ( base64Text.size() * 3 >> 2 ) - numPadding;
-    OutputBuffer decoded( decodedsize, '.' );
+inline size_t decoded_size( std::string_view base64Text )
+{
+    const size_t numPadding = padding_size( base64Text );
+    return ( base64Text.size() * 3 >> 2 ) - numPadding;
+}
 
-    const uint8_t* bytes        = reinterpret_cast<const uint8_t*>( &base64Text[0] );
-    char*          currDecoding = reinterpret_cast<char*>( &decoded[0] );
+/**
+ * Decode complete quartets of base64 text. The padding is that of the final quartet of base64Text.
+ */
+inline void decode_to( std::string_view base64Text, size_t numPadding, char* currDecoding )
+{
+    if ( base64Text.empty() )
+    {
+        return;
+    }
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>( &base64Text[0] );
 
     for ( size_t i = ( base64Text.size() >> 2 ) - ( numPadding != 0 ); i; --i )
     {
@@ -550,7 +566,24 @@ inline OutputBuffer decode_into( std::string_view base64Text )
             throw std::runtime_error{ "Invalid base64 encoded data - Invalid padding number" };
         }
     }
+}
 
+template <class OutputBuffer>
+inline OutputBuffer decode_into( std::string_view base64Text )
+{
+    typedef typename OutputBuffer::value_type output_value_type;
+    static_assert( std::is_same_v<output_value_type, char> || std::is_same_v<output_value_type, signed char> ||
+                   std::is_same_v<output_value_type, unsigned char> || std::is_same_v<output_value_type, std::byte> );
+    if ( base64Text.empty() )
+    {
+        return OutputBuffer();
+    }
+
+    const size_t numPadding  = padding_size( base64Text );
+    const size_t decodedsize = ( base64Text.size() * 3 >> 2 ) - numPadding;
+    OutputBuffer decoded( decodedsize, '.' );
+
+    decode_to( base64Text, numPadding, reinterpret_cast<char*>( &decoded[0] ) );
     return decoded;
 }
 
@@ -571,16 +604,512 @@ inline std::string from_base64( std::string_view data )
 
 } // namespace base64
 
+//==================================================================================================
+// Vectorised base64 using the algorithms described by Wojciech Muła and Daniel Lemire in
+// "Faster Base64 Encoding and Decoding Using AVX2 Instructions" (ACM TOW 2018).
+// The vector loops handle the bulk of the data and leave the tail, including padding, to the scalar code.
+//==================================================================================================
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define CAFFA_BASE64_X86
+#include <immintrin.h>
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#include <intrin.h>
+#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#define CAFFA_BASE64_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define CAFFA_BASE64_TARGET( isa ) __attribute__( ( target( isa ) ) )
+#else
+#define CAFFA_BASE64_TARGET( isa )
+#endif
+
+namespace
+{
+using caffa::StringTools::Base64Implementation;
+
+#ifdef CAFFA_BASE64_X86
+
+//--------------------------------------------------------------------------------------------------
+/// Map 6-bit indices to the base64 alphabet by adding an offset selected from the range of the index
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) __m128i encodeLookupSsse3( __m128i indices )
+{
+    const __m128i shiftLut = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+
+    __m128i       result = _mm_subs_epu8( indices, _mm_set1_epi8( 51 ) );
+    const __m128i less   = _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), indices );
+    result               = _mm_or_si128( result, _mm_and_si128( less, _mm_set1_epi8( 13 ) ) );
+    return _mm_add_epi8( _mm_shuffle_epi8( shiftLut, result ), indices );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Spread the 12 bytes in the low part of each 16 byte block into 16 6-bit indices
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) __m128i encodeUnpackSsse3( __m128i input )
+{
+    input            = _mm_shuffle_epi8( input, _mm_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+    const __m128i t0 = _mm_and_si128( input, _mm_set1_epi32( 0x0fc0fc00 ) );
+    const __m128i t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+    const __m128i t2 = _mm_and_si128( input, _mm_set1_epi32( 0x003f03f0 ) );
+    const __m128i t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+    return _mm_or_si128( t1, t3 );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) size_t encodeSsse3( const uint8_t* input, size_t size, char* output )
+{
+    size_t consumed = 0u;
+    // Each iteration reads 16 bytes but only encodes the first 12
+    for ( ; consumed + 16u <= size; consumed += 12u )
+    {
+        const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + consumed ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( output ), encodeLookupSsse3( encodeUnpackSsse3( block ) ) );
+        output += 16u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Translate 16 base64 characters to 6-bit values. Sets bits in the error mask for invalid characters.
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) __m128i decodeLookupSsse3( __m128i input, int& errorMask )
+{
+    // Characters are classified by their high nibble, with the lower nibble selecting which high nibbles are valid
+    const __m128i shiftLut  = _mm_setr_epi8( 0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+    // The masks are bit sets of valid high nibbles, written as signed bytes: -88 = 0xa8, -8 = 0xf8, -16 = 0xf0
+    const __m128i maskLut =
+        _mm_setr_epi8( -88, -8, -8, -8, -8, -8, -8, -8, -8, -8, -16, 0x54, 0x50, 0x50, 0x50, 0x54 );
+    const __m128i bitposLut = _mm_setr_epi8( 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, -128, 0, 0, 0, 0, 0, 0, 0, 0 );
+
+    const __m128i higherNibble = _mm_and_si128( _mm_srli_epi32( input, 4 ), _mm_set1_epi8( 0x0f ) );
+    const __m128i lowerNibble  = _mm_and_si128( input, _mm_set1_epi8( 0x0f ) );
+
+    const __m128i validHigh = _mm_shuffle_epi8( maskLut, lowerNibble );
+    const __m128i highBit   = _mm_shuffle_epi8( bitposLut, higherNibble );
+    errorMask |= _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( validHigh, highBit ), _mm_setzero_si128() ) );
+
+    // '/' shares the high nibble with '+' but needs an offset which is 3 lower
+    const __m128i isSlash = _mm_cmpeq_epi8( input, _mm_set1_epi8( '/' ) );
+    const __m128i shift   = _mm_add_epi8( _mm_shuffle_epi8( shiftLut, higherNibble ),
+                                          _mm_and_si128( isSlash, _mm_set1_epi8( -3 ) ) );
+    return _mm_add_epi8( input, shift );
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Pack 16 6-bit values into 12 bytes in the low part of the result
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) __m128i decodePackSsse3( __m128i values )
+{
+    const __m128i mergedPairs = _mm_maddubs_epi16( values, _mm_set1_epi32( 0x01400140 ) );
+    const __m128i merged      = _mm_madd_epi16( mergedPairs, _mm_set1_epi32( 0x00011000 ) );
+    return _mm_shuffle_epi8( merged, _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "ssse3" ) size_t decodeSsse3( const uint8_t* input, size_t size, char* output )
+{
+    size_t consumed = 0u;
+    // Each iteration writes 16 bytes but only 12 are decoded. Staying 8 characters from the end keeps the
+    // writes inside the output and the padding out of the vector loop.
+    for ( ; consumed + 24u <= size; consumed += 16u )
+    {
+        int           errorMask = 0;
+        const __m128i block     = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + consumed ) );
+        const __m128i values    = decodeLookupSsse3( block, errorMask );
+        if ( errorMask != 0 ) break;
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( output ), decodePackSsse3( values ) );
+        output += 12u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The AVX2 versions do the same as the SSSE3 versions in each 128 bit lane
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "avx2" ) size_t encodeAvx2( const uint8_t* input, size_t size, char* output )
+{
+    const __m256i shuffle = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8( 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 ) );
+    const __m256i shiftLut = _mm256_broadcastsi128_si256( _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                                          '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                                          '/' - 63, 'A', 0, 0 ) );
+
+    size_t consumed = 0u;
+    // Each iteration reads 12 bytes into each lane, with the second lane reaching 28 bytes in
+    for ( ; consumed + 28u <= size; consumed += 24u )
+    {
+        const __m128i low   = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + consumed ) );
+        const __m128i high  = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + consumed + 12u ) );
+        __m256i       block = _mm256_inserti128_si256( _mm256_castsi128_si256( low ), high, 1 );
+
+        block             = _mm256_shuffle_epi8( block, shuffle );
+        const __m256i t0  = _mm256_and_si256( block, _mm256_set1_epi32( 0x0fc0fc00 ) );
+        const __m256i t1  = _mm256_mulhi_epu16( t0, _mm256_set1_epi32( 0x04000040 ) );
+        const __m256i t2  = _mm256_and_si256( block, _mm256_set1_epi32( 0x003f03f0 ) );
+        const __m256i t3  = _mm256_mullo_epi16( t2, _mm256_set1_epi32( 0x01000010 ) );
+        const __m256i idx = _mm256_or_si256( t1, t3 );
+
+        __m256i       result = _mm256_subs_epu8( idx, _mm256_set1_epi8( 51 ) );
+        const __m256i less   = _mm256_cmpgt_epi8( _mm256_set1_epi8( 26 ), idx );
+        result               = _mm256_or_si256( result, _mm256_and_si256( less, _mm256_set1_epi8( 13 ) ) );
+        result               = _mm256_add_epi8( _mm256_shuffle_epi8( shiftLut, result ), idx );
+
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( output ), result );
+        output += 32u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CAFFA_BASE64_TARGET( "avx2" ) size_t decodeAvx2( const uint8_t* input, size_t size, char* output )
+{
+    const __m256i shiftLut = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8( 0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+    const __m256i maskLut = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8( -88, -8, -8, -8, -8, -8, -8, -8, -8, -8, -16, 0x54, 0x50, 0x50, 0x50, 0x54 ) );
+    const __m256i bitposLut = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8( 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, -128, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+    const __m256i pack = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+
+    size_t consumed = 0u;
+    // Each iteration writes 32 bytes but only 24 are decoded. See decodeSsse3.
+    for ( ; consumed + 48u <= size; consumed += 32u )
+    {
+        const __m256i block = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( input + consumed ) );
+
+        const __m256i higherNibble = _mm256_and_si256( _mm256_srli_epi32( block, 4 ), _mm256_set1_epi8( 0x0f ) );
+        const __m256i lowerNibble  = _mm256_and_si256( block, _mm256_set1_epi8( 0x0f ) );
+
+        const __m256i validHigh = _mm256_shuffle_epi8( maskLut, lowerNibble );
+        const __m256i highBit   = _mm256_shuffle_epi8( bitposLut, higherNibble );
+        const __m256i invalid = _mm256_cmpeq_epi8( _mm256_and_si256( validHigh, highBit ), _mm256_setzero_si256() );
+        if ( _mm256_movemask_epi8( invalid ) != 0 ) break;
+
+        const __m256i isSlash = _mm256_cmpeq_epi8( block, _mm256_set1_epi8( '/' ) );
+        const __m256i shift   = _mm256_add_epi8( _mm256_shuffle_epi8( shiftLut, higherNibble ),
+                                               _mm256_and_si256( isSlash, _mm256_set1_epi8( -3 ) ) );
+        const __m256i values  = _mm256_add_epi8( block, shift );
+
+        const __m256i mergedPairs = _mm256_maddubs_epi16( values, _mm256_set1_epi32( 0x01400140 ) );
+        const __m256i merged      = _mm256_madd_epi16( mergedPairs, _mm256_set1_epi32( 0x00011000 ) );
+        const __m256i packed      = _mm256_shuffle_epi8( merged, pack );
+        const __m256i compacted = _mm256_permutevar8x32_epi32( packed, _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 ) );
+
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( output ), compacted );
+        output += 24u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Base64Implementation detectImplementation()
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx2" ) ) return Base64Implementation::AVX2;
+    if ( __builtin_cpu_supports( "ssse3" ) ) return Base64Implementation::SSSE3;
+#elif defined( _MSC_VER )
+    int info[4];
+    __cpuid( info, 0 );
+    const int maxLeaf = info[0];
+
+    __cpuid( info, 1 );
+    const bool ssse3   = ( info[2] & ( 1 << 9 ) ) != 0;
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool avx     = ( info[2] & ( 1 << 28 ) ) != 0;
+
+    bool avx2 = false;
+    if ( maxLeaf >= 7 && osxsave && avx && ( _xgetbv( 0 ) & 0x6 ) == 0x6 )
+    {
+        __cpuidex( info, 7, 0 );
+        avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+    }
+    if ( avx2 ) return Base64Implementation::AVX2;
+    if ( ssse3 ) return Base64Implementation::SSSE3;
+#endif
+    return Base64Implementation::SCALAR;
+}
+
+#elif defined( CAFFA_BASE64_NEON )
+
+//--------------------------------------------------------------------------------------------------
+/// Encodes 48 bytes into 64 characters per iteration using the de-interleaving loads and table lookups
+//--------------------------------------------------------------------------------------------------
+size_t encodeNeon( const uint8_t* input, size_t size, char* output )
+{
+    static constexpr uint8_t alphabet[64] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+                                              'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+                                              'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+                                              'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+                                              '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/' };
+
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8( alphabet );
+    table.val[1] = vld1q_u8( alphabet + 16 );
+    table.val[2] = vld1q_u8( alphabet + 32 );
+    table.val[3] = vld1q_u8( alphabet + 48 );
+
+    const uint8x16_t mask = vdupq_n_u8( 0x3f );
+
+    size_t consumed = 0u;
+    for ( ; consumed + 48u <= size; consumed += 48u )
+    {
+        const uint8x16x3_t block = vld3q_u8( input + consumed );
+
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8( block.val[0], 2 );
+        indices.val[1] = vandq_u8( vorrq_u8( vshlq_n_u8( block.val[0], 4 ), vshrq_n_u8( block.val[1], 4 ) ), mask );
+        indices.val[2] = vandq_u8( vorrq_u8( vshlq_n_u8( block.val[1], 2 ), vshrq_n_u8( block.val[2], 6 ) ), mask );
+        indices.val[3] = vandq_u8( block.val[2], mask );
+
+        uint8x16x4_t result;
+        for ( int i = 0; i < 4; ++i )
+        {
+            result.val[i] = vqtbl4q_u8( table, indices.val[i] );
+        }
+        vst4q_u8( reinterpret_cast<uint8_t*>( output ), result );
+        output += 64u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Translate 16 base64 characters to 6-bit values by range. Sets the error vector for invalid characters.
+//--------------------------------------------------------------------------------------------------
+uint8x16_t decodeLookupNeon( uint8x16_t input, uint8x16_t& error )
+{
+    const uint8x16_t upper = vsubq_u8( input, vdupq_n_u8( 'A' ) );
+    const uint8x16_t lower = vsubq_u8( input, vdupq_n_u8( 'a' ) );
+    const uint8x16_t digit = vsubq_u8( input, vdupq_n_u8( '0' ) );
+
+    const uint8x16_t isUpper = vcltq_u8( upper, vdupq_n_u8( 26 ) );
+    const uint8x16_t isLower = vcltq_u8( lower, vdupq_n_u8( 26 ) );
+    const uint8x16_t isDigit = vcltq_u8( digit, vdupq_n_u8( 10 ) );
+    const uint8x16_t isPlus  = vceqq_u8( input, vdupq_n_u8( '+' ) );
+    const uint8x16_t isSlash = vceqq_u8( input, vdupq_n_u8( '/' ) );
+
+    uint8x16_t values = vandq_u8( isUpper, upper );
+    values            = vorrq_u8( values, vandq_u8( isLower, vaddq_u8( lower, vdupq_n_u8( 26 ) ) ) );
+    values            = vorrq_u8( values, vandq_u8( isDigit, vaddq_u8( digit, vdupq_n_u8( 52 ) ) ) );
+    values            = vorrq_u8( values, vandq_u8( isPlus, vdupq_n_u8( 62 ) ) );
+    values            = vorrq_u8( values, vandq_u8( isSlash, vdupq_n_u8( 63 ) ) );
+
+    const uint8x16_t valid = vorrq_u8( vorrq_u8( vorrq_u8( isUpper, isLower ), vorrq_u8( isDigit, isPlus ) ), isSlash );
+    error                  = vorrq_u8( error, vmvnq_u8( valid ) );
+    return values;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Decodes 64 characters into 48 bytes per iteration
+//--------------------------------------------------------------------------------------------------
+size_t decodeNeon( const uint8_t* input, size_t size, char* output )
+{
+    size_t consumed = 0u;
+    // Staying more than one quartet from the end keeps the padding out of the vector loop
+    for ( ; consumed + 68u <= size; consumed += 64u )
+    {
+        const uint8x16x4_t block = vld4q_u8( input + consumed );
+
+        uint8x16_t error = vdupq_n_u8( 0 );
+        uint8x16_t a     = decodeLookupNeon( block.val[0], error );
+        uint8x16_t b     = decodeLookupNeon( block.val[1], error );
+        uint8x16_t c     = decodeLookupNeon( block.val[2], error );
+        uint8x16_t d     = decodeLookupNeon( block.val[3], error );
+        if ( vmaxvq_u8( error ) != 0 ) break;
+
+        uint8x16x3_t result;
+        result.val[0] = vorrq_u8( vshlq_n_u8( a, 2 ), vshrq_n_u8( b, 4 ) );
+        result.val[1] = vorrq_u8( vshlq_n_u8( b, 4 ), vshrq_n_u8( c, 2 ) );
+        result.val[2] = vorrq_u8( vshlq_n_u8( c, 6 ), d );
+        vst3q_u8( reinterpret_cast<uint8_t*>( output ), result );
+        output += 48u;
+    }
+    return consumed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Base64Implementation detectImplementation()
+{
+    return Base64Implementation::NEON;
+}
+
+#else
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Base64Implementation detectImplementation()
+{
+    return Base64Implementation::SCALAR;
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/// Encode with the vector implementation and return the number of input bytes consumed.
+/// The remaining input is left to the scalar code.
+//--------------------------------------------------------------------------------------------------
+size_t encodeVectorised( const uint8_t* input, size_t size, char* output, Base64Implementation implementation )
+{
+    switch ( implementation )
+    {
+#ifdef CAFFA_BASE64_X86
+        case Base64Implementation::AVX2:
+        {
+            size_t consumed = encodeAvx2( input, size, output );
+            return consumed + encodeSsse3( input + consumed, size - consumed, output + consumed / 3u * 4u );
+        }
+        case Base64Implementation::SSSE3:
+            return encodeSsse3( input, size, output );
+#elif defined( CAFFA_BASE64_NEON )
+        case Base64Implementation::NEON:
+            return encodeNeon( input, size, output );
+#endif
+        default:
+            return 0u;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Decode with the vector implementation and return the number of input characters consumed.
+/// The vector code stops at the first block with invalid characters and leaves them to the scalar code to report.
+//--------------------------------------------------------------------------------------------------
+size_t decodeVectorised( const uint8_t* input, size_t size, char* output, Base64Implementation implementation )
+{
+    switch ( implementation )
+    {
+#ifdef CAFFA_BASE64_X86
+        case Base64Implementation::AVX2:
+        {
+            size_t consumed = decodeAvx2( input, size, output );
+            return consumed + decodeSsse3( input + consumed, size - consumed, output + consumed / 4u * 3u );
+        }
+        case Base64Implementation::SSSE3:
+            return decodeSsse3( input, size, output );
+#elif defined( CAFFA_BASE64_NEON )
+        case Base64Implementation::NEON:
+            return decodeNeon( input, size, output );
+#endif
+        default:
+            return 0u;
+    }
+}
+
+} // namespace
+
 namespace caffa::StringTools
 {
 
 std::string decodeBase64( std::string_view input )
 {
-    return base64::decode_into<std::string>( input );
+    std::string decoded( decodedBase64Size( input ), '\0' );
+    decodeBase64( input, decoded );
+    return decoded;
 }
 
 std::string encodeBase64( std::string_view val )
 {
-    return base64::encode_into<std::string>( std::begin( val ), std::end( val ) );
+    std::string encoded( encodedBase64Size( val.size() ), '\0' );
+    encodeBase64( val, encoded );
+    return encoded;
 }
-} // namespace caffa::StringTools
\ No newline at end of file
+
+size_t encodedBase64Size( size_t unencodedSize )
+{
+    return base64::encoded_size( unencodedSize );
+}
+
+size_t decodedBase64Size( std::string_view encodedValue )
+{
+    return base64::decoded_size( encodedValue );
+}
+
+size_t encodeBase64( std::string_view unencodedValue, std::span<char> output )
+{
+    return encodeBase64( unencodedValue, output, base64Implementation() );
+}
+
+size_t decodeBase64( std::string_view encodedValue, std::span<char> output )
+{
+    return decodeBase64( encodedValue, output, base64Implementation() );
+}
+
+size_t encodeBase64( std::string_view unencodedValue, std::span<char> output, Base64Implementation implementation )
+{
+    if ( !isBase64ImplementationSupported( implementation ) )
+    {
+        throw std::runtime_error{ "Base64 implementation not supported on this CPU" };
+    }
+
+    const size_t encodedSize = base64::encoded_size( unencodedValue.size() );
+    if ( output.size() < encodedSize )
+    {
+        throw std::runtime_error{ "Base64 output buffer too small" };
+    }
+    if ( unencodedValue.empty() ) return 0u;
+
+    const auto*  input    = reinterpret_cast<const uint8_t*>( unencodedValue.data() );
+    const size_t consumed = encodeVectorised( input, unencodedValue.size(), output.data(), implementation );
+    base64::encode_to( input + consumed, unencodedValue.size() - consumed, output.data() + consumed / 3u * 4u );
+    return encodedSize;
+}
+
+size_t decodeBase64( std::string_view encodedValue, std::span<char> output, Base64Implementation implementation )
+{
+    if ( !isBase64ImplementationSupported( implementation ) )
+    {
+        throw std::runtime_error{ "Base64 implementation not supported on this CPU" };
+    }
+
+    const size_t numPadding  = base64::padding_size( encodedValue );
+    const size_t decodedSize = ( encodedValue.size() * 3 >> 2 ) - numPadding;
+    if ( output.size() < decodedSize )
+    {
+        throw std::runtime_error{ "Base64 output buffer too small" };
+    }
+    if ( encodedValue.empty() ) return 0u;
+
+    const auto*  input    = reinterpret_cast<const uint8_t*>( encodedValue.data() );
+    const size_t consumed = decodeVectorised( input, encodedValue.size(), output.data(), implementation );
+    base64::decode_to( encodedValue.substr( consumed ), numPadding, output.data() + consumed / 4u * 3u );
+    return decodedSize;
+}
+
+Base64Implementation base64Implementation()
+{
+    static const Base64Implementation implementation = detectImplementation();
+    return implementation;
+}
+
+bool isBase64ImplementationSupported( Base64Implementation implementation )
+{
+    const auto best = base64Implementation();
+    switch ( implementation )
+    {
+        case Base64Implementation::SCALAR:
+            return true;
+        case Base64Implementation::SSSE3:
+            return best == Base64Implementation::SSSE3 || best == Base64Implementation::AVX2;
+        default:
+            return implementation == best;
+    }
+}
+
+} // namespace caffa::StringTools
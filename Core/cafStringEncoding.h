@@ -19,10 +19,68 @@
 // ##################################################################################################
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace caffa::StringTools
 {
+/**
+ * The base64 implementations. The vectorised ones are picked at runtime depending on the CPU.
+ */
+enum class Base64Implementation
+{
+    SCALAR,
+    SSSE3,
+    AVX2,
+    NEON
+};
+
 std::string decodeBase64( std::string_view encodedValue );
 std::string encodeBase64( std::string_view unencodedValue );
+
+/**
+ * The number of characters needed to encode a number of bytes, including padding
+ */
+size_t encodedBase64Size( size_t unencodedSize );
+
+/**
+ * The number of bytes the encoded value decodes to. Throws std::runtime_error if the size or padding is invalid.
+ */
+size_t decodedBase64Size( std::string_view encodedValue );
+
+/**
+ * Encode into a caller-provided buffer without any intermediate allocation.
+ * Data can be encoded in chunks as long as all chunks except the last have a size divisible by 3.
+ * @param unencodedValue The data to encode
+ * @param output The buffer to write to. Must hold at least encodedBase64Size( unencodedValue.size() ) characters.
+ * @return The number of characters written
+ */
+size_t encodeBase64( std::string_view unencodedValue, std::span<char> output );
+
+/**
+ * Decode into a caller-provided buffer without any intermediate allocation. Throws std::runtime_error on invalid data.
+ * Data can be decoded in chunks as long as all chunks except the last have a size divisible by 4.
+ * @param encodedValue The base64 text to decode
+ * @param output The buffer to write to. Must hold at least decodedBase64Size( encodedValue ) bytes.
+ * @return The number of bytes written
+ */
+size_t decodeBase64( std::string_view encodedValue, std::span<char> output );
+
+/**
+ * Encode with a specific implementation. Throws std::runtime_error if the implementation is not supported.
+ */
+size_t encodeBase64( std::string_view unencodedValue, std::span<char> output, Base64Implementation implementation );
+
+/**
+ * Decode with a specific implementation. Throws std::runtime_error if the implementation is not supported.
+ */
+size_t decodeBase64( std::string_view encodedValue, std::span<char> output, Base64Implementation implementation );
+
+/**
+ * The fastest base64 implementation supported by the CPU. This is the one used when none is specified.
+ */
+Base64Implementation base64Implementation();
+
+bool isBase64ImplementationSupported( Base64Implementation implementation );
 } // namespace caffa::StringTools
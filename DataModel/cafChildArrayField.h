@@ -27,7 +27,9 @@
 #include "cafObjectHandle.h"
 #include "cafObjectHandlePortableDataType.h"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace caffa
 {
@@ -69,12 +71,21 @@ public:
     std::vector<std::shared_ptr<const DataType>> objects() const;
     void                                         setObjects( std::vector<std::shared_ptr<DataType>>& objects );
 
+    /**
+     * Defer creating the child objects until any of them are accessed. Replaces the current children.
+     * Fields using a custom accessor call the loader straight away.
+     * @param loader Function creating the child objects. Objects of the wrong type are skipped.
+     * Called at most once, from the first thread accessing the children.
+     */
+    void setObjectsLoader( std::function<std::vector<std::shared_ptr<ObjectHandle>>()> loader );
+
     // std::vector-like access
 
     std::shared_ptr<DataType> operator[]( size_t index ) const;
 
     void push_back( std::shared_ptr<DataType> pointer );
     void push_back_obj( std::shared_ptr<ObjectHandle> obj ) override;
+    void push_back_objs( std::vector<std::shared_ptr<ObjectHandle>> objs ) override;
     void insert( size_t index, std::shared_ptr<DataType> pointer );
     void insertAt( size_t index, std::shared_ptr<ObjectHandle> obj ) override;
     void erase( size_t index ) override;
@@ -69,6 +69,8 @@ void ChildArrayField<DataTypePtr>::push_back( std::shared_ptr<DataType> pointer
     }
 
     m_fieldDataAccessor->push_back( pointer );
+    this->updateLastModified();
+    if ( pointer ) pointer->setAddedVersion( this->lastModifiedVersion() );
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -87,6 +89,29 @@ void ChildArrayField<DataTypePtr>::push_back_obj( std::shared_ptr<ObjectHandle>
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Assign several shared pointers at once
+//--------------------------------------------------------------------------------------------------
+template <typename DataTypePtr>
+    requires is_pointer<DataTypePtr>
+void ChildArrayField<DataTypePtr>::push_back_objs( std::vector<std::shared_ptr<ObjectHandle>> objs )
+{
+    CAFFA_ASSERT( isInitialized() );
+
+    if ( !m_fieldDataAccessor )
+    {
+        throw std::runtime_error( "Failed to add objects to '" + this->keyword() + "': Field is not accessible" );
+    }
+
+    std::erase_if( objs, []( const auto& obj ) { return !std::dynamic_pointer_cast<DataType>( obj ); } );
+    this->updateLastModified();
+    for ( const auto& obj : objs )
+    {
+        obj->setAddedVersion( this->lastModifiedVersion() );
+    }
+    m_fieldDataAccessor->append( std::move( objs ) );
+}
+
 //--------------------------------------------------------------------------------------------------
 /// Insert pointer at position index, pushing the value previously at that position and all
 /// the preceding values backwards
@@ -104,6 +129,8 @@ void ChildArrayField<DataTypePtr>::insert( size_t index, std::shared_ptr<DataTyp
     }
 
     m_fieldDataAccessor->insert( index, pointer );
+    this->updateLastModified();
+    if ( pointer ) pointer->setAddedVersion( this->lastModifiedVersion() );
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -133,7 +160,8 @@ void ChildArrayField<DataTypePtr>::clear()
     {
         throw std::runtime_error( "Failed to clear objects from '" + this->keyword() + "': Field is not accessible" );
     }
-    return m_fieldDataAccessor->clear();
+    m_fieldDataAccessor->clear();
+    this->updateLastModified();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -151,6 +179,7 @@ void ChildArrayField<DataTypePtr>::erase( size_t index )
                                   "': Field is not accessible" );
     }
     m_fieldDataAccessor->remove( index );
+    this->updateLastModified();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -169,6 +198,37 @@ void ChildArrayField<DataTypePtr>::setObjects( std::vector<std::shared_ptr<DataT
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Only fields storing their own children can defer loading them. Others get the children straight away.
+//--------------------------------------------------------------------------------------------------
+template <typename DataTypePtr>
+    requires is_pointer<DataTypePtr>
+void ChildArrayField<DataTypePtr>::setObjectsLoader( std::function<std::vector<std::shared_ptr<ObjectHandle>>()> loader )
+{
+    CAFFA_ASSERT( isInitialized() );
+
+    if ( !dynamic_cast<DirectStorageAccessor*>( m_fieldDataAccessor.get() ) )
+    {
+        clear();
+        push_back_objs( loader() );
+        return;
+    }
+
+    // The children count as added when the loader was set, although they are created later
+    this->updateLastModified();
+    auto typedLoader = [loader = std::move( loader ), addedVersion = this->lastModifiedVersion()]()
+    {
+        auto objects = loader();
+        std::erase_if( objects, []( const auto& obj ) { return !std::dynamic_pointer_cast<DataType>( obj ); } );
+        for ( const auto& obj : objects )
+        {
+            obj->setAddedVersion( addedVersion );
+        }
+        return objects;
+    };
+    m_fieldDataAccessor = std::make_unique<ChildArrayFieldLazyAccessor>( this, std::move( typedLoader ) );
+}
+
 //--------------------------------------------------------------------------------------------------
 /// Removes all instances of object pointer from the container without deleting the object.
 //--------------------------------------------------------------------------------------------------
@@ -189,6 +249,7 @@ void ChildArrayField<DataTypePtr>::removeChildObject( std::shared_ptr<const Obje
         if ( index < m_fieldDataAccessor->size() )
         {
             m_fieldDataAccessor->remove( index );
+            this->updateLastModified();
         }
     }
 }
@@ -23,6 +23,7 @@
 #include "cafObjectHandle.h"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 
 using namespace caffa;
@@ -77,6 +78,17 @@ void ChildArrayFieldDirectStorageAccessor::push_back( std::shared_ptr<ObjectHand
     m_pointers.push_back( pointer );
 }
 
+void ChildArrayFieldDirectStorageAccessor::append( std::vector<std::shared_ptr<ObjectHandle>> pointers )
+{
+    if ( m_pointers.empty() )
+    {
+        m_pointers = std::move( pointers );
+        return;
+    }
+    m_pointers.reserve( m_pointers.size() + pointers.size() );
+    std::move( pointers.begin(), pointers.end(), std::back_inserter( m_pointers ) );
+}
+
 size_t ChildArrayFieldDirectStorageAccessor::index( std::shared_ptr<const ObjectHandle> object ) const
 {
     auto it = std::find_if( m_pointers.begin(),
@@ -106,3 +118,95 @@ void ChildArrayFieldDirectStorageAccessor::remove( size_t index )
         throw std::runtime_error( "Index out of range " + std::to_string( index ) );
     }
 }
+
+ChildArrayFieldLazyAccessor::ChildArrayFieldLazyAccessor( FieldHandle* field, Loader loader )
+    : ChildArrayFieldDirectStorageAccessor( field )
+    , m_loader( std::move( loader ) )
+    , m_loaded( false )
+{
+}
+
+ChildArrayFieldLazyAccessor::~ChildArrayFieldLazyAccessor() = default;
+
+size_t ChildArrayFieldLazyAccessor::size() const
+{
+    load();
+    return ChildArrayFieldDirectStorageAccessor::size();
+}
+
+void ChildArrayFieldLazyAccessor::clear()
+{
+    {
+        std::scoped_lock lock( m_mutex );
+        m_loader = nullptr;
+        m_loaded.store( true, std::memory_order_release );
+    }
+    ChildArrayFieldDirectStorageAccessor::clear();
+}
+
+std::vector<std::shared_ptr<ObjectHandle>> ChildArrayFieldLazyAccessor::objects()
+{
+    load();
+    return ChildArrayFieldDirectStorageAccessor::objects();
+}
+
+std::vector<std::shared_ptr<const ObjectHandle>> ChildArrayFieldLazyAccessor::objects() const
+{
+    load();
+    return ChildArrayFieldDirectStorageAccessor::objects();
+}
+
+std::shared_ptr<ObjectHandle> ChildArrayFieldLazyAccessor::at( size_t index ) const
+{
+    load();
+    return ChildArrayFieldDirectStorageAccessor::at( index );
+}
+
+void ChildArrayFieldLazyAccessor::insert( size_t index, std::shared_ptr<ObjectHandle> pointer )
+{
+    load();
+    ChildArrayFieldDirectStorageAccessor::insert( index, pointer );
+}
+
+void ChildArrayFieldLazyAccessor::push_back( std::shared_ptr<ObjectHandle> pointer )
+{
+    load();
+    ChildArrayFieldDirectStorageAccessor::push_back( pointer );
+}
+
+void ChildArrayFieldLazyAccessor::append( std::vector<std::shared_ptr<ObjectHandle>> pointers )
+{
+    load();
+    ChildArrayFieldDirectStorageAccessor::append( std::move( pointers ) );
+}
+
+size_t ChildArrayFieldLazyAccessor::index( std::shared_ptr<const ObjectHandle> object ) const
+{
+    load();
+    return ChildArrayFieldDirectStorageAccessor::index( object );
+}
+
+void ChildArrayFieldLazyAccessor::remove( size_t index )
+{
+    load();
+    ChildArrayFieldDirectStorageAccessor::remove( index );
+}
+
+bool ChildArrayFieldLazyAccessor::isLoaded() const
+{
+    return m_loaded.load( std::memory_order_acquire );
+}
+
+void ChildArrayFieldLazyAccessor::load() const
+{
+    if ( isLoaded() ) return;
+
+    std::scoped_lock lock( m_mutex );
+    if ( isLoaded() ) return;
+
+    // The accessor itself is never const, only the view of it. A loader which throws is tried again next time.
+    auto* self = const_cast<ChildArrayFieldLazyAccessor*>( this );
+    self->ChildArrayFieldDirectStorageAccessor::append( m_loader() );
+    m_loader = nullptr;
+    m_loaded.store( true, std::memory_order_release );
+}
@@ -18,7 +18,10 @@
 //
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace caffa
@@ -45,6 +48,18 @@ public:
     virtual size_t                        index( std::shared_ptr<const ObjectHandle> pointer ) const    = 0;
     virtual void                          remove( size_t index )                                        = 0;
 
+    /**
+     * Add several objects to the end in one operation. The default implementation adds them one at a time.
+     * @param pointers The objects to add
+     */
+    virtual void append( std::vector<std::shared_ptr<ObjectHandle>> pointers )
+    {
+        for ( auto& pointer : pointers )
+        {
+            push_back( std::move( pointer ) );
+        }
+    }
+
     /**
      * The accessor has a getter. Thus can be read.
      * @return true if it has a getter
@@ -74,6 +89,7 @@ public:
     std::shared_ptr<ObjectHandle>                    at( size_t index ) const override;
     void         insert( size_t index, std::shared_ptr<ObjectHandle> pointer ) override;
     void         push_back( std::shared_ptr<ObjectHandle> pointer ) override;
+    void         append( std::vector<std::shared_ptr<ObjectHandle>> pointers ) override;
     size_t       index( std::shared_ptr<const ObjectHandle> object ) const override;
     virtual void remove( size_t index ) override;
     bool         hasGetter() const override { return true; }
@@ -83,4 +99,41 @@ private:
     std::vector<std::shared_ptr<ObjectHandle>> m_pointers;
 };
 
+/**
+ * Accessor storing children which are created by a loader the first time any of them are accessed, including
+ * through size(). Lets readers defer building child subtrees until somebody looks at them.
+ * The loader is called at most once and may be called from any thread accessing the children.
+ */
+class ChildArrayFieldLazyAccessor final : public ChildArrayFieldDirectStorageAccessor
+{
+public:
+    using Loader = std::function<std::vector<std::shared_ptr<ObjectHandle>>()>;
+
+    ChildArrayFieldLazyAccessor( FieldHandle* field, Loader loader );
+    ~ChildArrayFieldLazyAccessor() override;
+
+    size_t                                           size() const override;
+    void                                             clear() override;
+    std::vector<std::shared_ptr<ObjectHandle>>       objects() override;
+    std::vector<std::shared_ptr<const ObjectHandle>> objects() const override;
+    std::shared_ptr<ObjectHandle>                    at( size_t index ) const override;
+    void   insert( size_t index, std::shared_ptr<ObjectHandle> pointer ) override;
+    void   push_back( std::shared_ptr<ObjectHandle> pointer ) override;
+    void   append( std::vector<std::shared_ptr<ObjectHandle>> pointers ) override;
+    size_t index( std::shared_ptr<const ObjectHandle> object ) const override;
+    void   remove( size_t index ) override;
+
+    /**
+     * @return true once the loader has run or the children have been cleared
+     */
+    bool isLoaded() const;
+
+private:
+    void load() const;
+
+    mutable std::mutex        m_mutex;
+    mutable Loader            m_loader;
+    mutable std::atomic<bool> m_loaded;
+};
+
 } // namespace caffa
@@ -24,6 +24,7 @@
 #include "cafChildFieldHandle.h"
 
 #include <memory>
+#include <vector>
 
 namespace caffa
 {
@@ -84,6 +85,14 @@ public:
      */
     virtual void push_back_obj( std::shared_ptr<ObjectHandle> obj ) = 0;
 
+    /**
+     * @brief push back several objects in one operation, taking over ownership.
+     * Objects of the wrong type are skipped, like in push_back_obj.
+     *
+     * @param objs objects to take.
+     */
+    virtual void push_back_objs( std::vector<std::shared_ptr<ObjectHandle>> objs ) = 0;
+
     /**
      * @brief Set a new accessor
      *
@@ -28,6 +28,7 @@
 #include "cafObjectHandlePortableDataType.h"
 
 #include <concepts>
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -91,6 +92,13 @@ public:
     }
     void setObject( Ptr object );
 
+    /**
+     * Defer creating the child object until it is first accessed. Replaces the current child.
+     * Fields using a custom accessor call the loader straight away.
+     * @param loader Function creating the child object. Called at most once, from the first thread accessing it.
+     */
+    void setObjectLoader( std::function<Ptr()> loader );
+
     // Access operators
     operator std::shared_ptr<DataType>() { return this->object(); }
     operator std::shared_ptr<const DataType>() const { return this->object(); }
@@ -81,6 +81,31 @@ void ChildField<DataTypePtr>::setObject( std::shared_ptr<DataType> object )
     }
 
     m_fieldDataAccessor->setObject( object );
+    this->updateLastModified();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Only fields storing their own child can defer loading it. Others get the child straight away.
+//--------------------------------------------------------------------------------------------------
+template <typename DataTypePtr>
+requires is_pointer<DataTypePtr>
+void ChildField<DataTypePtr>::setObjectLoader( std::function<Ptr()> loader )
+{
+    CAFFA_ASSERT( isInitialized() );
+
+    auto* accessor = m_fieldDataAccessor.get();
+    if ( !dynamic_cast<ChildFieldDirectStorageAccessor*>( accessor ) &&
+         !dynamic_cast<ChildFieldLazyAccessor*>( accessor ) )
+    {
+        this->setObject( loader() );
+        return;
+    }
+
+    m_fieldDataAccessor =
+        std::make_unique<ChildFieldLazyAccessor>( this,
+                                                  [loader = std::move( loader )]() -> std::shared_ptr<ObjectHandle>
+                                                  { return loader(); } );
+    this->updateLastModified();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -133,6 +158,7 @@ void ChildField<DataTypePtr>::clear()
     if ( m_fieldDataAccessor )
     {
         m_fieldDataAccessor->clear();
+        this->updateLastModified();
     }
 }
 //--------------------------------------------------------------------------------------------------
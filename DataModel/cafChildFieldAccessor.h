@@ -20,7 +20,10 @@
 
 #include "cafObjectHandle.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace caffa
@@ -76,4 +79,78 @@ private:
     std::shared_ptr<ObjectHandle> m_object;
 };
 
+/**
+ * Accessor storing a child which is created by a loader the first time it is accessed.
+ * Lets readers defer building child subtrees until somebody looks at them.
+ * The loader is called at most once and may be called from any thread accessing the child.
+ */
+class ChildFieldLazyAccessor final : public ChildFieldAccessor
+{
+public:
+    using Loader = std::function<std::shared_ptr<ObjectHandle>()>;
+
+    ChildFieldLazyAccessor( FieldHandle* field, Loader loader )
+        : ChildFieldAccessor( field )
+        , m_loader( std::move( loader ) )
+        , m_loaded( false )
+    {
+    }
+    ~ChildFieldLazyAccessor() override = default;
+
+    std::shared_ptr<ObjectHandle> object() override
+    {
+        load();
+        return m_object;
+    }
+    std::shared_ptr<const ObjectHandle> object() const override
+    {
+        load();
+        return m_object;
+    }
+    void setObject( std::shared_ptr<ObjectHandle> object ) override
+    {
+        discardLoader();
+        m_object = object;
+    }
+    void clear() override
+    {
+        discardLoader();
+        m_object.reset();
+    }
+
+    bool hasGetter() const override { return true; }
+    bool hasSetter() const override { return true; }
+
+    /**
+     * @return true once the loader has run or the child has been replaced
+     */
+    bool isLoaded() const { return m_loaded.load( std::memory_order_acquire ); }
+
+private:
+    void load() const
+    {
+        if ( isLoaded() ) return;
+
+        std::scoped_lock lock( m_mutex );
+        if ( isLoaded() ) return;
+
+        // A loader which throws is left in place and tried again on the next access
+        m_object = m_loader();
+        m_loader = nullptr;
+        m_loaded.store( true, std::memory_order_release );
+    }
+
+    void discardLoader()
+    {
+        std::scoped_lock lock( m_mutex );
+        m_loader = nullptr;
+        m_loaded.store( true, std::memory_order_release );
+    }
+
+    mutable std::mutex                    m_mutex;
+    mutable Loader                        m_loader;
+    mutable std::shared_ptr<ObjectHandle> m_object;
+    mutable std::atomic<bool>             m_loaded;
+};
+
 } // namespace caffa
@@ -25,10 +25,13 @@
 
 #include "cafAssert.h"
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <ranges>
 #include <string>
+#include <vector>
 
 namespace caffa
 {
@@ -48,6 +51,19 @@ public:
 
     [[nodiscard]] std::ranges::view auto classes() const { return std::views::keys( m_factoryMap ); }
 
+    [[nodiscard]] std::vector<std::string> classKeywords() const override
+    {
+        auto keywords = classes();
+        return std::vector<std::string>( keywords.begin(), keywords.end() );
+    }
+
+    /**
+     * A counter increased every time a class is registered. Results derived from the set of registered classes
+     * can be kept for as long as the generation stays the same.
+     * @return the registry generation
+     */
+    [[nodiscard]] std::uint64_t generation() const override { return m_generation.load( std::memory_order_acquire ); }
+
     template <typename ObjectBaseDerivative>
     bool registerCreator()
     {
@@ -61,6 +77,7 @@ public:
         }
         auto object                               = std::make_unique<ObjectCreator<ObjectBaseDerivative>>();
         m_factoryMap[std::string( classKeyword )] = std::move( object );
+        m_generation.fetch_add( 1u, std::memory_order_acq_rel );
         return true;
     }
 
@@ -88,6 +105,7 @@ private:
 
     // Map to store factory
     std::map<std::string, std::shared_ptr<ObjectCreatorBase>, std::less<>> m_factoryMap;
+    std::atomic<std::uint64_t>                                             m_generation = 0u;
 };
 
 } // End of namespace caffa
@@ -3,10 +3,16 @@
 #include "cafFieldCapability.h"
 #include "cafObjectHandle.h"
 
+#include <atomic>
 #include <typeinfo>
 
 namespace caffa
 {
+namespace
+{
+    std::atomic<std::uint64_t> s_modificationVersion = 0u;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -14,6 +20,7 @@ FieldHandle::FieldHandle()
     : m_ownerObject( nullptr )
     , m_isDeprecated( false )
     , m_volatile( false )
+    , m_lastModifiedVersion( 0u )
 {
 }
 
@@ -77,4 +84,37 @@ void FieldHandle::markVolatile()
     m_volatile = true;
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const std::chrono::system_clock::time_point& FieldHandle::lastModified() const
+{
+    return m_lastModified;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t FieldHandle::lastModifiedVersion() const
+{
+    return m_lastModifiedVersion;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t FieldHandle::currentVersion()
+{
+    return s_modificationVersion.load( std::memory_order_acquire );
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FieldHandle::updateLastModified()
+{
+    m_lastModifiedVersion = s_modificationVersion.fetch_add( 1u, std::memory_order_acq_rel ) + 1u;
+    m_lastModified        = std::chrono::system_clock::now();
+}
+
 } // End of namespace caffa
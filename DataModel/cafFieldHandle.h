@@ -3,7 +3,9 @@
 #include "cafAssert.h"
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -24,7 +26,7 @@ public:
     FieldHandle();
     virtual ~FieldHandle();
 
-    [[nodiscard]] std::string         keyword() const { return m_keyword; }
+    [[nodiscard]] const std::string&  keyword() const { return m_keyword; }
     ObjectHandle*                     ownerObject();
     [[nodiscard]] const ObjectHandle* ownerObject() const;
 
@@ -39,6 +41,23 @@ public:
     template <typename CapabilityType>
     const CapabilityType* capability() const;
 
+    /**
+     * The position of a capability among the capabilities of the field.
+     * Fields set up the same way have their capabilities in the same positions.
+     * @return the position or nullopt if the field does not have the capability
+     */
+    template <typename CapabilityType>
+    [[nodiscard]] std::optional<size_t> capabilityIndex() const;
+
+    /**
+     * Get a capability directly from a position found with capabilityIndex() on a field set up the same way.
+     * Avoids the search done by capability().
+     * @param index The capability position
+     * @return the capability or nullptr if the position is out of range
+     */
+    template <typename CapabilityType>
+    CapabilityType* capabilityAt( size_t index );
+
     /**
      * Accept the visit by an inspecting visitor
      * @param visitor
@@ -69,7 +88,24 @@ public:
 
     FieldHandle( const FieldHandle& ) = delete;
 
-    const std::chrono::system_clock::time_point& lastModified() const;
+    /**
+     * The time of the last change to the field value or to the set of children held by the field.
+     * Is the epoch for fields that have not been changed since construction.
+     */
+    [[nodiscard]] const std::chrono::system_clock::time_point& lastModified() const;
+
+    /**
+     * The modification version of the last change to the field. Versions are taken from a process wide counter
+     * which increases with every field modification, so they can be compared across fields and objects.
+     * Is zero for fields that have not been changed since construction.
+     */
+    [[nodiscard]] std::uint64_t lastModifiedVersion() const;
+
+    /**
+     * The most recent modification version handed out to any field. Fields with a lastModifiedVersion() larger
+     * than a version recorded earlier have been changed after it was recorded.
+     */
+    [[nodiscard]] static std::uint64_t currentVersion();
 
     /**
      * Is the field volatile (can be changed external means)
@@ -101,6 +137,7 @@ private:
     std::string m_documentation;
 
     std::chrono::system_clock::time_point m_lastModified;
+    std::uint64_t                         m_lastModifiedVersion;
 };
 
 template <typename CapabilityType>
@@ -136,4 +173,30 @@ const CapabilityType* FieldHandle::capability() const
     return nullptr;
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename CapabilityType>
+std::optional<size_t> FieldHandle::capabilityIndex() const
+{
+    for ( size_t i = 0; i < m_capabilities.size(); ++i )
+    {
+        if ( dynamic_cast<const CapabilityType*>( m_capabilities[i].get() ) ) return i;
+    }
+    return std::nullopt;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+template <typename CapabilityType>
+CapabilityType* FieldHandle::capabilityAt( size_t index )
+{
+    if ( index >= m_capabilities.size() ) return nullptr;
+
+    CAFFA_ASSERT( dynamic_cast<CapabilityType*>( m_capabilities[index].get() ) &&
+                  "Capability position taken from a field set up differently" );
+    return static_cast<CapabilityType*>( m_capabilities[index].get() );
+}
+
 } // End of namespace caffa
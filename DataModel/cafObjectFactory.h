@@ -23,8 +23,11 @@
 
 #include "cafObjectHandle.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace caffa
 {
@@ -41,12 +44,45 @@ public:
 
     [[nodiscard]] virtual std::string name() const = 0;
 
+    /**
+     * The class keywords of the objects the factory can create.
+     * Factories which can not list their classes return an empty list.
+     * @return a list of class keywords
+     */
+    [[nodiscard]] virtual std::vector<std::string> classKeywords() const { return {}; }
+
+    /**
+     * A counter changed every time the set of classes the factory can create changes.
+     * Factories which do not keep track return 0, and results derived from their classes are not cached.
+     * @return the registry generation
+     */
+    [[nodiscard]] virtual std::uint64_t generation() const { return 0u; }
+
+    /**
+     * A number telling the factory apart from every other factory in the process, including factories created later
+     * at the same address. Results derived from the classes of a factory are cached per identity, since the same class
+     * keyword may be registered differently with different factories.
+     * @return the factory identity
+     */
+    [[nodiscard]] virtual std::uint64_t identity() const { return m_identity; }
+
 protected:
-    ObjectFactory()          = default;
+    ObjectFactory()
+        : m_identity( nextIdentity() )
+    {
+    }
     virtual ~ObjectFactory() = default;
 
 private:
     virtual std::shared_ptr<ObjectHandle> doCreate( const std::string_view& classKeyword ) = 0;
+
+    static std::uint64_t nextIdentity()
+    {
+        static std::atomic<std::uint64_t> lastIdentity = 0u;
+        return lastIdentity.fetch_add( 1u, std::memory_order_relaxed ) + 1u;
+    }
+
+    std::uint64_t m_identity;
 };
 
 } // End of namespace caffa
@@ -35,6 +35,7 @@ using namespace caffa;
 ///
 //--------------------------------------------------------------------------------------------------
 ObjectHandle::ObjectHandle( bool generateUuid /* = true */ )
+    : m_addedVersion( 0u )
 {
     if ( generateUuid )
     {
@@ -83,6 +84,14 @@ std::vector<FieldHandle*> ObjectHandle::fields() const
     return fieldVector;
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t ObjectHandle::fieldCount() const
+{
+    return m_fields.size();
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -173,3 +182,19 @@ void ObjectHandle::setUuid( const std::string& uuid )
 {
     m_uuid = uuid;
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t ObjectHandle::addedVersion() const
+{
+    return m_addedVersion;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ObjectHandle::setAddedVersion( std::uint64_t version )
+{
+    m_addedVersion = version;
+}
@@ -28,6 +28,7 @@
 #include "cafStringTools.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string_view>
@@ -104,6 +105,12 @@ public:
      */
     [[nodiscard]] std::vector<FieldHandle*> fields() const;
 
+    /**
+     * The number of registered fields. Cheaper than fields().size()
+     * @return the field count
+     */
+    [[nodiscard]] size_t fieldCount() const;
+
     /**
      * The registered methods for this Object.
      * @return a list of MethodHandle pointers
@@ -127,6 +134,13 @@ public:
     [[nodiscard]] const std::string& uuid() const;
     void                             setUuid( const std::string& );
 
+    /**
+     * The modification version of the child array field change which last added the object to the field.
+     * Is zero for objects that have not been added to a child array field since construction.
+     */
+    [[nodiscard]] std::uint64_t addedVersion() const;
+    void                        setAddedVersion( std::uint64_t version );
+
     /// Method gets called from Document after all objects are read.
     /// Re-implement to set up internal pointers etc. in your data structure
     virtual void initAfterRead() {};
@@ -158,7 +172,8 @@ protected:
     void addMethod( MethodHandle* method, const std::string& keyword );
 
 private:
-    std::string m_uuid;
+    std::string   m_uuid;
+    std::uint64_t m_addedVersion;
 
     // Fields
     std::map<std::string, FieldHandle*> m_fields;